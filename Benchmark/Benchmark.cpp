@@ -0,0 +1,102 @@
+﻿#include "Benchmark.h"
+#include "../DirectX/Math/SIMD.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+
+Benchmark::Benchmark(int sampleCount, unsigned seed) :
+    mSampleCount(std::max(sampleCount, 1)),
+    mSeed(seed) {
+}
+
+Benchmark::~Benchmark() = default;
+
+void Benchmark::run(const std::string& name, size_t count, const std::function<unsigned long long()>& func) {
+    using Clock = std::chrono::high_resolution_clock;
+
+    //キャッシュと分岐予測を温めるため、1回は計測せずに実行する
+    auto checksum = func();
+
+    std::vector<double> samples(mSampleCount);
+    for (auto&& sample : samples) {
+        auto begin = Clock::now();
+        auto sum = func();
+        auto end = Clock::now();
+        sample = std::chrono::duration<double, std::milli>(end - begin).count();
+
+        //毎回同じ結果にならなければ計測対象が壊れている
+        if (sum != checksum) {
+            checksum = ~0ull;
+        }
+    }
+
+    std::sort(samples.begin(), samples.end());
+    mResults.emplace_back(Result{ name, count, samples.front(), samples[samples.size() / 2], checksum });
+}
+
+void Benchmark::verify(const std::string& name, size_t count, size_t mismatchCount) {
+    mChecks.emplace_back(Check{ name, count, mismatchCount });
+}
+
+bool Benchmark::passed() const {
+    return std::all_of(mChecks.begin(), mChecks.end(), [](const Check& check) {
+        return check.mismatchCount == 0;
+    });
+}
+
+void Benchmark::writeJson(std::ostream& out) const {
+    out << std::fixed << std::setprecision(6);
+    out << "{\n";
+    out << "  \"seed\": " << mSeed << ",\n";
+    out << "  \"samples\": " << mSampleCount << ",\n";
+    out << "  \"simd\": ";
+    writeString(out, simdName());
+    out << ",\n";
+    out << "  \"results\": [\n";
+    for (size_t i = 0; i < mResults.size(); ++i) {
+        const auto& r = mResults[i];
+        auto nsPerOp = (r.count > 0) ? r.minMs * 1000000.0 / r.count : 0.0;
+
+        out << "    { \"name\": ";
+        writeString(out, r.name);
+        out << ", \"count\": " << r.count;
+        out << ", \"minMs\": " << r.minMs;
+        out << ", \"medianMs\": " << r.medianMs;
+        out << ", \"nsPerOp\": " << nsPerOp;
+        out << ", \"checksum\": " << r.checksum << " }";
+        out << ((i + 1 < mResults.size()) ? ",\n" : "\n");
+    }
+    out << "  ],\n";
+    out << "  \"checks\": [\n";
+    for (size_t i = 0; i < mChecks.size(); ++i) {
+        const auto& c = mChecks[i];
+        out << "    { \"name\": ";
+        writeString(out, c.name);
+        out << ", \"count\": " << c.count;
+        out << ", \"mismatches\": " << c.mismatchCount << " }";
+        out << ((i + 1 < mChecks.size()) ? ",\n" : "\n");
+    }
+    out << "  ]\n";
+    out << "}\n";
+}
+
+const char* Benchmark::simdName() {
+#if defined(MATH_AVX)
+    return "AVX";
+#elif defined(MATH_SSE)
+    return "SSE2";
+#else
+    return "None";
+#endif
+}
+
+void Benchmark::writeString(std::ostream& out, const std::string& str) {
+    out << '"';
+    for (auto c : str) {
+        if (c == '"' || c == '\\') {
+            out << '\\';
+        }
+        out << c;
+    }
+    out << '"';
+}
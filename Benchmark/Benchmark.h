@@ -0,0 +1,60 @@
+﻿#pragma once
+
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+//処理時間を計測し、ビルド間で比較できるようにJSONで出力する
+class Benchmark {
+    //1項目の計測結果
+    struct Result {
+        std::string name;
+        //1サンプルで処理した件数
+        size_t count;
+        //最も速かったサンプルの時間
+        double minMs;
+        //サンプルの中央値
+        double medianMs;
+        //計算結果の集計値 最適化で処理が消えていないかの確認と、ビルド間の結果比較に使う
+        unsigned long long checksum;
+    };
+
+    //実装同士の結果の突き合わせ
+    struct Check {
+        std::string name;
+        //突き合わせた件数
+        size_t count;
+        //結果が食い違った件数
+        size_t mismatchCount;
+    };
+
+public:
+    Benchmark(int sampleCount, unsigned seed);
+    ~Benchmark();
+
+    //funcをサンプル数だけ計測する
+    //countはfuncの1回で処理する件数、funcは計算結果の集計値を返す
+    void run(const std::string& name, size_t count, const std::function<unsigned long long()>& func);
+    //countの件数を突き合わせ、mismatchCount件の結果が食い違ったことを記録する
+    void verify(const std::string& name, size_t count, size_t mismatchCount);
+    //全項目の結果が一致したか
+    bool passed() const;
+    //全結果をJSONで書き出す
+    void writeJson(std::ostream& out) const;
+
+private:
+    Benchmark(const Benchmark&) = delete;
+    Benchmark& operator=(const Benchmark&) = delete;
+
+    //ビルドで使われたSIMD命令セット名
+    static const char* simdName();
+    //JSONの文字列として書き出す
+    static void writeString(std::ostream& out, const std::string& str);
+
+private:
+    std::vector<Result> mResults;
+    std::vector<Check> mChecks;
+    int mSampleCount;
+    unsigned mSeed;
+};
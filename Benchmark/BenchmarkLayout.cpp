@@ -0,0 +1,46 @@
+﻿#include "BenchmarkLayout.h"
+#include <cmath>
+
+const BenchmarkLayout::Object BenchmarkLayout::OBJECTS[] = {
+    { "Niwa", Vector3(-3.13f, -6.29f, 1.52f), Vector3(0.000002134f, 46.298676f, -14.8999815f), Vector3(1.55f, 2.58f, 0.73f), Vector3(-4.361124f, 0.f, -4.4845963f), Vector3(-2.4916828f, 1.5400376f, -3.2158234f) },
+    { "Plane", Vector3(0.f, 0.f, 0.f), Vector3(-89.99999f, 0.f, 0.f), Vector3(10.f, 10.f, 1.f), Vector3(-1.f, -1.f, 0.f), Vector3(1.f, 1.f, 0.f) },
+    { "Plane1", Vector3(0.f, 0.f, 0.f), Vector3(-89.99999f, 0.f, 0.f), Vector3(1.f, 1.f, 1.f), Vector3(-1.f, -1.f, 0.f), Vector3(1.f, 1.f, 0.f) },
+    { "SphereTest", Vector3(0.f, 3.96f, 0.f), Vector3(0.f, -98.899f, 0.f), Vector3(1.f, 1.f, 1.f), Vector3(-0.95105785f, -0.99999994f, -1.f), Vector3(0.95105785f, 0.99999994f, 1.f) },
+    { "box", Vector3(6.08f, 4.76f, 0.f), Vector3(0.f, 0.f, 0.f), Vector3(1.f, 1.f, 1.f), Vector3(-1.f, -1.f, -2.3712637f), Vector3(5.493106f, 3.401885f, 3.7863672f) },
+    { "box", Vector3(6.08f, 4.76f, 0.f), Vector3(0.f, 0.f, 0.f), Vector3(1.f, 1.f, 1.f), Vector3(-8.722597f, -4.7110996f, -1.f), Vector3(1.f, 2.1174603f, 5.4696646f) },
+    { "box1", Vector3(0.f, 2.89f, 0.f), Vector3(-75.79952f, 53.599796f, 109.29998f), Vector3(1.f, 1.f, 1.f), Vector3(-1.f, -1.f, -1.f), Vector3(1.f, 1.f, 1.f) },
+    { "sky", Vector3(0.f, 0.f, 0.f), Vector3(0.f, 0.f, 0.f), Vector3(1.f, 1.f, 1.f), Vector3(-100.f, -100.f, -100.f), Vector3(100.f, 100.f, 100.f) },
+    { "sphere", Vector3(0.f, 2.95f, 0.f), Vector3(0.f, -179.90097f, 0.f), Vector3(1.f, 1.f, 1.f), Vector3(-0.95105785f, -0.99999994f, -1.f), Vector3(0.95105785f, 0.99999994f, 1.f) },
+    { "test", Vector3(0.f, 0.f, 0.f), Vector3(0.f, 0.f, 0.f), Vector3(1.f, 1.f, 1.f), Vector3(1.500747f, 0.f, 0.9063356f), Vector3(5.f, 1.3039768f, 5.f) },
+    { "test", Vector3(0.f, 0.f, 0.f), Vector3(0.f, 0.f, 0.f), Vector3(1.f, 1.f, 1.f), Vector3(-3.8906593f, 0.f, 0.5528893f), Vector3(-1.5558254f, 1.2818223f, 5.f) },
+    { "tonbi4_sankaku", Vector3(0.f, 1.17f, 0.f), Vector3(-89.99999f, 180.f, 0.f), Vector3(100.f, 100.f, 100.f), Vector3(-0.100343235f, -1.1741346f, 0.0578614f), Vector3(0.04868748f, -1.1433218f, 0.11937725f) },
+    { "yasiki+niwa", Vector3(0.f, 12.7f, 0.f), Vector3(0.f, 0.f, 0.f), Vector3(1.f, 1.f, 1.f), Vector3(-11.079243f, 0.f, -10.080199f), Vector3(15.025423f, 4.07874f, 10.797081f) },
+};
+
+void BenchmarkLayout::create(unsigned copies, std::vector<AABB>& out) {
+    //1つ分の配置をワールド空間に変換する
+    std::vector<AABB> layout;
+    AABB bounds;
+    for (const auto& obj : OBJECTS) {
+        Quaternion rotation;
+        rotation.setEuler(obj.rotation);
+        auto world = Matrix4::createScale(obj.scale) * Matrix4::createFromQuaternion(rotation) * Matrix4::createTranslation(obj.position);
+        auto aabb = AABB(obj.min, obj.max).transform(world);
+        layout.emplace_back(aabb);
+        bounds.updateMinMax(aabb.min);
+        bounds.updateMinMax(aabb.max);
+    }
+
+    //xz平面上に正方形に近い形で並べる
+    auto side = static_cast<unsigned>(std::ceil(std::sqrt(static_cast<float>(copies))));
+    auto stepX = bounds.max.x - bounds.min.x + COPY_GAP;
+    auto stepZ = bounds.max.z - bounds.min.z + COPY_GAP;
+    out.clear();
+    out.reserve(layout.size() * copies);
+    for (unsigned i = 0; i < copies; ++i) {
+        auto offset = Vector3((i % side) * stepX, 0.f, (i / side) * stepZ);
+        for (const auto& aabb : layout) {
+            out.emplace_back(aabb.min + offset, aabb.max + offset);
+        }
+    }
+}
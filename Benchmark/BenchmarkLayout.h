@@ -0,0 +1,35 @@
+﻿#pragma once
+
+#include "../DirectX/Collision/AABB.h"
+#include "../DirectX/Math/Math.h"
+#include <vector>
+
+//Assets/Dataに保存されているオブジェクトのAABBコライダーの配置
+//D3Dとjsonの読み込みを使わずに、実際のシーンの配置でブロードフェーズを計測するために使う
+class BenchmarkLayout {
+    //ファイル1つ分のトランスフォームと、AABBコライダーのローカル空間の範囲
+    struct Object {
+        const char* fileName;
+        Vector3 position;
+        //オイラー角 (度)
+        Vector3 rotation;
+        Vector3 scale;
+        Vector3 min;
+        Vector3 max;
+    };
+
+public:
+    //配置を水平方向に格子状に複製して、ワールド空間のAABBを作る
+    //複製同士は重ならないように間隔を空ける
+    static void create(unsigned copies, std::vector<AABB>& out);
+
+private:
+    BenchmarkLayout() = delete;
+    ~BenchmarkLayout() = delete;
+
+private:
+    //minとmaxが保存されているAABBコライダー 1つのファイルに複数あればその数だけ並ぶ
+    static const Object OBJECTS[];
+    //複製同士の間隔
+    static constexpr float COPY_GAP = 1.f;
+};
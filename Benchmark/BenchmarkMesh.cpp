@@ -0,0 +1,78 @@
+﻿#include "BenchmarkMesh.h"
+#include "../DirectX/Collision/ConvexHull.h"
+#include "../DirectX/Collision/TriangleBVH.h"
+
+BenchmarkMesh::BenchmarkMesh(const std::vector<Vector3>& triangles) :
+    mMeshesVertices(1),
+    mBones(),
+    mMaterial(),
+    mAABB(Vector3::zero, Vector3::zero),
+    mSphere(Vector3::zero, 0.f),
+    mTriangleBVH(std::make_unique<TriangleBVH>()),
+    mConvexHull(std::make_unique<ConvexHull>()) {
+    auto& vertices = mMeshesVertices[0];
+    vertices.resize(triangles.size() / 3 * 3);
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        vertices[i].pos = triangles[i];
+    }
+
+    if (!vertices.empty()) {
+        AABB aabb;
+        for (const auto& v : vertices) {
+            aabb.updateMinMax(v.pos);
+        }
+        mAABB = aabb;
+
+        //AABBの中心から最も遠い頂点までを半径にする
+        auto center = (aabb.min + aabb.max) / 2.f;
+        float radiusSq = 0.f;
+        for (const auto& v : vertices) {
+            radiusSq = Math::Max(radiusSq, (v.pos - center).lengthSq());
+        }
+        mSphere = Sphere(center, Math::sqrt(radiusSq));
+    }
+
+    mTriangleBVH->build(mMeshesVertices);
+}
+
+BenchmarkMesh::~BenchmarkMesh() = default;
+
+const Material& BenchmarkMesh::getMaterial(unsigned /*index*/) const {
+    return mMaterial;
+}
+
+unsigned BenchmarkMesh::getMeshCount() const {
+    return mMeshesVertices.size();
+}
+
+const MeshVertices& BenchmarkMesh::getMeshVertices(unsigned index) const {
+    return mMeshesVertices[index];
+}
+
+const std::vector<Bone>& BenchmarkMesh::getBones() const {
+    return mBones;
+}
+
+const AABB& BenchmarkMesh::getAABB(unsigned /*index*/) const {
+    return mAABB;
+}
+
+const AABB& BenchmarkMesh::getAABB() const {
+    return mAABB;
+}
+
+const Sphere& BenchmarkMesh::getSphere(unsigned /*index*/) const {
+    return mSphere;
+}
+
+const Sphere& BenchmarkMesh::getSphere() const {
+    return mSphere;
+}
+
+const TriangleBVH& BenchmarkMesh::getTriangleBVH() const {
+    return *mTriangleBVH;
+}
+
+const ConvexHull& BenchmarkMesh::getConvexHull() const {
+    return *mConvexHull;
+}
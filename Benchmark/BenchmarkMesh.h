@@ -0,0 +1,44 @@
+﻿#pragma once
+
+#include "../DirectX/Collision/AABB.h"
+#include "../DirectX/Collision/Sphere.h"
+#include "../DirectX/Mesh/IMesh.h"
+#include <memory>
+#include <vector>
+
+class TriangleBVH;
+class ConvexHull;
+
+//三角形の集まりから作る描画しないメッシュ
+//D3Dを使わずにメッシュの衝突判定を計測するために使う
+class BenchmarkMesh : public IMesh {
+public:
+    //3頂点で1ポリゴンとして扱う
+    BenchmarkMesh(const std::vector<Vector3>& triangles);
+    ~BenchmarkMesh();
+
+    virtual const Material& getMaterial(unsigned index) const override;
+    virtual unsigned getMeshCount() const override;
+    virtual const MeshVertices& getMeshVertices(unsigned index) const override;
+    virtual const std::vector<Bone>& getBones() const override;
+    virtual const AABB& getAABB(unsigned index) const override;
+    virtual const AABB& getAABB() const override;
+    virtual const Sphere& getSphere(unsigned index) const override;
+    virtual const Sphere& getSphere() const override;
+    virtual const TriangleBVH& getTriangleBVH() const override;
+    virtual const ConvexHull& getConvexHull() const override;
+
+private:
+    BenchmarkMesh(const BenchmarkMesh&) = delete;
+    BenchmarkMesh& operator=(const BenchmarkMesh&) = delete;
+
+private:
+    std::vector<MeshVertices> mMeshesVertices;
+    std::vector<Bone> mBones;
+    Material mMaterial;
+    AABB mAABB;
+    Sphere mSphere;
+    std::unique_ptr<TriangleBVH> mTriangleBVH;
+    //凸包は計測対象外なので空のまま
+    std::unique_ptr<ConvexHull> mConvexHull;
+};
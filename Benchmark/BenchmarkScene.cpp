@@ -0,0 +1,84 @@
+﻿#include "BenchmarkScene.h"
+#include "../DirectX/Utility/Random.h"
+#include <cmath>
+
+BenchmarkScene::BenchmarkScene() :
+    spheres(),
+    aabbs(),
+    rays(),
+    meshRays(),
+    cameraRays(),
+    triangles(),
+    meshExtent(10.f) {
+}
+
+void BenchmarkScene::generate(const BenchmarkSceneSettings& settings, unsigned seed) {
+    Random::initialize(seed);
+
+    const auto world = Vector3::one * settings.worldExtent;
+    const auto minWorld = -1.f * world;
+
+    spheres.resize(settings.objectCount);
+    for (auto&& sphere : spheres) {
+        sphere.center = Random::randomRange(minWorld, world);
+        sphere.radius = Random::randomRange(0.5f, 2.f);
+    }
+
+    aabbs.resize(settings.objectCount);
+    for (auto&& aabb : aabbs) {
+        auto center = Random::randomRange(minWorld, world);
+        auto extents = Random::randomRange(Vector3::one * 0.5f, Vector3::one * 2.f);
+        aabb = AABB(center - extents, center + extents);
+    }
+
+    //シーンの外側の2点を結ぶレイ
+    rays.resize(settings.rayCount);
+    for (auto&& ray : rays) {
+        ray.start = Random::randomRange(minWorld, world);
+        ray.end = Random::randomRange(minWorld, world);
+        ray.start.x = minWorld.x * 1.5f;
+        ray.end.x = world.x * 1.5f;
+    }
+
+    //メッシュ内の点を中心に小さな三角形をばら撒く
+    const auto mesh = Vector3::one * meshExtent;
+    const auto minMesh = -1.f * mesh;
+    triangles.resize(settings.triangleCount * 3);
+    for (size_t i = 0; i < triangles.size(); i += 3) {
+        auto center = Random::randomRange(minMesh, mesh);
+        for (size_t j = 0; j < 3; ++j) {
+            triangles[i + j] = center + Random::randomRange(Vector3::one * -1.f, Vector3::one);
+        }
+    }
+
+    //メッシュを囲む球の外側から、メッシュ内の点に向かうレイ
+    meshRays.resize(settings.rayCount);
+    for (auto&& ray : meshRays) {
+        auto dir = Random::randomRange(Vector3::one * -1.f, Vector3::one);
+        if (dir.lengthSq() < 0.0001f) {
+            dir = Vector3::forward;
+        }
+        auto target = Random::randomRange(minMesh, mesh);
+        ray.start = target + Vector3::normalize(dir) * meshExtent * 3.f;
+        ray.end = target - Vector3::normalize(dir) * meshExtent * 3.f;
+    }
+
+    //区画を正方形に近い形に並べ、区画の中は横4本、縦2本ずつ並べる
+    const unsigned tileCount = (settings.rayCount + 7) / 8;
+    const auto tilesX = static_cast<unsigned>(std::ceil(std::sqrt(static_cast<float>(tileCount))));
+    const auto tilesY = (tileCount + tilesX - 1) / Math::Max(tilesX, 1u);
+    const auto eye = Vector3(meshExtent * 0.5f, meshExtent * 0.5f, -meshExtent * 3.f);
+    cameraRays.resize(settings.rayCount);
+    for (unsigned i = 0; i < settings.rayCount; ++i) {
+        auto tile = i / 8;
+        auto x = (tile % tilesX) * 4 + i % 4;
+        auto y = (tile / tilesX) * 2 + (i % 8) / 4;
+        auto target = Vector3(
+            meshExtent * ((x + 0.5f) / (tilesX * 4) * 2.f - 1.f),
+            meshExtent * ((y + 0.5f) / (tilesY * 2) * 2.f - 1.f),
+            0.f
+        );
+        cameraRays[i].start = eye;
+        cameraRays[i].end = eye + (target - eye) * 2.f;
+    }
+}
@@ -0,0 +1,48 @@
+﻿#pragma once
+
+#include "../DirectX/Collision/AABB.h"
+#include "../DirectX/Collision/Ray.h"
+#include "../DirectX/Collision/Sphere.h"
+#include "../DirectX/Math/Math.h"
+#include <vector>
+
+//計測用のシーンの大きさ
+struct BenchmarkSceneSettings {
+    //球とAABBそれぞれの数
+    unsigned objectCount;
+    //レイの数
+    unsigned rayCount;
+    //三角形の数
+    unsigned triangleCount;
+    //オブジェクトを配置する立方体の一辺の半分
+    float worldExtent;
+
+    BenchmarkSceneSettings() :
+        objectCount(10000),
+        rayCount(1000),
+        triangleCount(20000),
+        worldExtent(100.f) {
+    }
+};
+
+//乱数で生成する計測用のシーン
+//同じシードからは同じシーンが生成されるので、ビルド間で結果を比較できる
+struct BenchmarkScene {
+    std::vector<Sphere> spheres;
+    std::vector<AABB> aabbs;
+    //シーン全体を横切るレイ
+    std::vector<Ray> rays;
+    //メッシュの周囲からメッシュに向かうレイ
+    std::vector<Ray> meshRays;
+    //メッシュの手前の1点から、メッシュを覆う格子の各点に向かうレイ
+    //カメラから画面の区画ごとに飛ばすように、続く8本が格子上の4x2の区画に並ぶ
+    std::vector<Ray> cameraRays;
+    //3頂点で1ポリゴンの三角形の集まり
+    std::vector<Vector3> triangles;
+    //三角形を配置する立方体の一辺の半分
+    float meshExtent;
+
+    BenchmarkScene();
+    //シードからシーンを生成する
+    void generate(const BenchmarkSceneSettings& settings, unsigned seed);
+};
@@ -0,0 +1,521 @@
+﻿#include "CollisionBenchmark.h"
+#include "Benchmark.h"
+#include "BenchmarkLayout.h"
+#include "BenchmarkMesh.h"
+#include "BenchmarkScene.h"
+#include "../DirectX/Collision/AABBArray.h"
+#include "../DirectX/Collision/DynamicAABBTree.h"
+#include "../DirectX/Collision/Intersect.h"
+#include "../DirectX/Collision/RayPacket.h"
+#include "../DirectX/Collision/RaycastHit.h"
+#include "../DirectX/Collision/SpatialHashGrid.h"
+#include "../DirectX/Collision/SweepAndPrune.h"
+#include "../DirectX/Collision/TriangleBVH.h"
+#include "../DirectX/Utility/Random.h"
+#include <algorithm>
+
+void CollisionBenchmark::run(Benchmark& benchmark, const BenchmarkScene& scene, unsigned seed) {
+    verifyRayAABB(benchmark, scene);
+    runRay(benchmark, scene);
+    runMesh(benchmark, scene);
+    runOverlap(benchmark, scene);
+    runBroadphase(benchmark, scene);
+    runSweepAndPrune(benchmark, seed);
+    runLayout(benchmark);
+}
+
+void CollisionBenchmark::verifyRayAABB(Benchmark& benchmark, const BenchmarkScene& scene) {
+    const auto aabbCount = std::min<size_t>(scene.aabbs.size(), VERIFY_AABB_COUNT);
+    AABBArray aabbArray;
+    for (size_t i = 0; i < aabbCount; ++i) {
+        aabbArray.add(scene.aabbs[i]);
+    }
+
+    //各AABBの面上から、面に沿って箱を横切るレイと、面の外側を通り過ぎるレイを作る
+    //どちらも1軸は方向が0で、始点がその軸のスラブの平面上にある
+    std::vector<Ray> rays;
+    //レイを作った元のAABBと、そのAABBとの期待する結果
+    std::vector<size_t> sources;
+    std::vector<unsigned char> expected;
+    for (size_t i = 0; i < aabbCount; ++i) {
+        const auto& aabb = scene.aabbs[i];
+        auto center = (aabb.min + aabb.max) * 0.5f;
+        for (int axis = 0; axis < 3; ++axis) {
+            auto along = (axis + 1) % 3;
+            auto other = (axis + 2) % 3;
+            for (int side = 0; side < 2; ++side) {
+                Ray ray;
+                ray.start = center;
+                ray.start[axis] = (side == 0) ? aabb.min[axis] : aabb.max[axis];
+                ray.start[along] = aabb.min[along] - 1.f;
+                ray.end = ray.start;
+                ray.end[along] = aabb.max[along] + 1.f;
+                rays.emplace_back(ray);
+                sources.emplace_back(i);
+                expected.emplace_back(1);
+
+                ray.start[other] = ray.end[other] = aabb.max[other] + 1.f;
+                rays.emplace_back(ray);
+                sources.emplace_back(i);
+                expected.emplace_back(0);
+            }
+        }
+    }
+
+    //全レイを全AABBと判定し、スカラーの結果を基準にする
+    size_t mismatchCount = 0;
+    std::vector<float> batchT(aabbCount);
+    std::vector<float> scalarT(rays.size() * aabbCount);
+    for (size_t r = 0; r < rays.size(); ++r) {
+        const auto& ray = rays[r];
+        auto invDir = ray.inverseDirection();
+        Intersect::intersectRayAABBs(ray, aabbArray, batchT.data());
+        for (size_t i = 0; i < aabbCount; ++i) {
+            auto& t = scalarT[r * aabbCount + i];
+            if (!Intersect::intersectRayAABB(ray.start, invDir, scene.aabbs[i], 1.f, t)) {
+                t = Math::infinity;
+            }
+            if (batchT[i] != t) {
+                ++mismatchCount;
+            }
+        }
+        //レイを作った元のAABBとの結果は分かっている
+        auto hit = scalarT[r * aabbCount + sources[r]] < Math::infinity;
+        if (hit != (expected[r] != 0)) {
+            ++mismatchCount;
+        }
+    }
+
+    float packetT[RayPacket::SIZE];
+    for (size_t first = 0; first < rays.size(); first += RayPacket::SIZE) {
+        RayPacket packet;
+        auto last = std::min<size_t>(rays.size(), first + RayPacket::SIZE);
+        for (auto r = first; r < last; ++r) {
+            packet.add(rays[r]);
+        }
+        for (size_t i = 0; i < aabbCount; ++i) {
+            auto mask = Intersect::intersectRayPacketAABB(packet, scene.aabbs[i], packetT);
+            for (int k = 0; k < packet.count; ++k) {
+                auto t = scalarT[(first + k) * aabbCount + i];
+                auto hit = (mask >> k) & 1;
+                if (hit != static_cast<unsigned>(t < Math::infinity) || (hit && packetT[k] != t)) {
+                    ++mismatchCount;
+                }
+            }
+        }
+    }
+
+    benchmark.verify("Intersect::intersectRayAABB(axis-parallel on slab)", rays.size() * aabbCount * 2 + rays.size(), mismatchCount);
+}
+
+void CollisionBenchmark::runRay(Benchmark& benchmark, const BenchmarkScene& scene) {
+    const auto& rays = scene.rays;
+    const auto& aabbs = scene.aabbs;
+    const auto& spheres = scene.spheres;
+
+    const auto polygonCount = std::min<size_t>(scene.triangles.size() / 3, BRUTE_FORCE_POLYGON_COUNT);
+    benchmark.run("Intersect::intersectRayPolygon", scene.meshRays.size() * polygonCount, [&]() {
+        unsigned long long hits = 0;
+        Vector3 point;
+        for (const auto& ray : scene.meshRays) {
+            for (size_t i = 0; i < polygonCount; ++i) {
+                const auto* p = &scene.triangles[i * 3];
+                if (Intersect::intersectRayPolygon(ray, p[0], p[1], p[2], point)) {
+                    ++hits;
+                }
+            }
+        }
+        return hits;
+    });
+
+    benchmark.run("Intersect::intersectRayAABB", rays.size() * aabbs.size(), [&]() {
+        unsigned long long hits = 0;
+        for (const auto& ray : rays) {
+            for (const auto& aabb : aabbs) {
+                if (Intersect::intersectRayAABB(ray, aabb)) {
+                    ++hits;
+                }
+            }
+        }
+        return hits;
+    });
+
+    //方向の逆数を使い回すスラブ判定
+    benchmark.run("Intersect::intersectRayAABB(invDir)", rays.size() * aabbs.size(), [&]() {
+        unsigned long long hits = 0;
+        float t = 0.f;
+        for (const auto& ray : rays) {
+            auto invDir = ray.inverseDirection();
+            for (const auto& aabb : aabbs) {
+                if (Intersect::intersectRayAABB(ray.start, invDir, aabb, 1.f, t)) {
+                    ++hits;
+                }
+            }
+        }
+        return hits;
+    });
+
+    AABBArray aabbArray;
+    for (const auto& aabb : aabbs) {
+        aabbArray.add(aabb);
+    }
+    std::vector<float> outT(aabbArray.size());
+    benchmark.run("Intersect::intersectRayAABBs", rays.size() * aabbs.size(), [&]() {
+        unsigned long long hits = 0;
+        for (const auto& ray : rays) {
+            hits += Intersect::intersectRayAABBs(ray, aabbArray, outT.data());
+        }
+        return hits;
+    });
+
+    //球の中心との距離で判定する
+    benchmark.run("Ray::minDistanceSquare", rays.size() * spheres.size(), [&]() {
+        unsigned long long hits = 0;
+        for (const auto& ray : rays) {
+            for (const auto& sphere : spheres) {
+                if (ray.minDistanceSquare(sphere.center) <= sphere.radius * sphere.radius) {
+                    ++hits;
+                }
+            }
+        }
+        return hits;
+    });
+
+    benchmark.run("Ray::minDistanceSquare(Ray)", rays.size() * rays.size(), [&]() {
+        unsigned long long hits = 0;
+        for (const auto& a : rays) {
+            for (const auto& b : rays) {
+                if (Ray::minDistanceSquare(a, b) < 1.f) {
+                    ++hits;
+                }
+            }
+        }
+        return hits;
+    });
+}
+
+void CollisionBenchmark::runMesh(Benchmark& benchmark, const BenchmarkScene& scene) {
+    BenchmarkMesh mesh(scene.triangles);
+
+    std::vector<MeshVertices> meshesVertices(1);
+    for (const auto& p : scene.triangles) {
+        MeshVertex vertex;
+        vertex.pos = p;
+        meshesVertices[0].emplace_back(vertex);
+    }
+    benchmark.run("TriangleBVH::build", scene.triangles.size() / 3, [&]() {
+        TriangleBVH bvh;
+        bvh.build(meshesVertices);
+        return static_cast<unsigned long long>(bvh.getTriangleCount());
+    });
+
+    benchmark.run("TriangleBVH::raycast", scene.meshRays.size(), [&]() {
+        unsigned long long hits = 0;
+        for (const auto& ray : scene.meshRays) {
+            RaycastHit hit;
+            if (mesh.getTriangleBVH().raycast(ray.start, ray.end, hit)) {
+                ++hits;
+            }
+        }
+        return hits;
+    });
+
+    //オブジェクト空間のレイをワールド空間に移して、ワールド行列付きで判定する
+    auto world = Matrix4::createScale(1.5f)
+        * Matrix4::createFromQuaternion(Quaternion(Vector3::normalize(Vector3(1.f, 2.f, 3.f)), 30.f))
+        * Matrix4::createTranslation(Vector3(5.f, -3.f, 10.f));
+    auto toWorld = [&](const std::vector<Ray>& rays) {
+        std::vector<Ray> worldRays(rays.size());
+        for (size_t i = 0; i < worldRays.size(); ++i) {
+            worldRays[i].start = Vector3::transform(rays[i].start, world);
+            worldRays[i].end = Vector3::transform(rays[i].end, world);
+        }
+        return worldRays;
+    };
+    auto toPackets = [](const std::vector<Ray>& rays) {
+        std::vector<RayPacket> packets;
+        for (const auto& ray : rays) {
+            if (packets.empty() || !packets.back().add(ray)) {
+                packets.emplace_back();
+                packets.back().add(ray);
+            }
+        }
+        return packets;
+    };
+
+    //向きのばらばらなレイと、カメラから区画ごとに飛ばす向きのそろったレイ
+    const auto worldRays = toWorld(scene.meshRays);
+    const auto cameraRays = toWorld(scene.cameraRays);
+    const auto packets = toPackets(worldRays);
+    const auto cameraPackets = toPackets(cameraRays);
+
+    auto runScalar = [&](const std::string& name, const std::vector<Ray>& rays) {
+        benchmark.run(name, rays.size(), [&]() {
+            unsigned long long hits = 0;
+            for (const auto& ray : rays) {
+                RaycastHit hit;
+                if (Intersect::intersectRayMesh(ray, mesh, world, hit)) {
+                    ++hits;
+                }
+            }
+            return hits;
+        });
+    };
+    auto runPacket = [&](const std::string& name, const std::vector<Ray>& rays, const std::vector<RayPacket>& rayPackets) {
+        benchmark.run(name, rays.size(), [&]() {
+            unsigned long long hits = 0;
+            RaycastHit packetHits[RayPacket::SIZE];
+            for (const auto& packet : rayPackets) {
+                auto mask = Intersect::intersectRayPacketMesh(packet, mesh, world, packetHits);
+                for (; mask != 0; mask &= mask - 1) {
+                    ++hits;
+                }
+            }
+            return hits;
+        });
+    };
+    runScalar("Intersect::intersectRayMesh", worldRays);
+    runPacket("Intersect::intersectRayPacketMesh", worldRays, packets);
+    runScalar("Intersect::intersectRayMesh(camera)", cameraRays);
+    runPacket("Intersect::intersectRayPacketMesh(camera)", cameraRays, cameraPackets);
+
+    //パケットの結果が1本ずつ判定した結果と一致するか
+    auto verifyPacket = [&](const std::string& name, const std::vector<Ray>& rays, const std::vector<RayPacket>& rayPackets) {
+        size_t mismatchCount = 0;
+        RaycastHit packetHits[RayPacket::SIZE];
+        for (size_t p = 0; p < rayPackets.size(); ++p) {
+            auto mask = Intersect::intersectRayPacketMesh(rayPackets[p], mesh, world, packetHits);
+            for (int i = 0; i < rayPackets[p].count; ++i) {
+                RaycastHit hit;
+                auto hitScalar = Intersect::intersectRayMesh(rays[p * RayPacket::SIZE + i], mesh, world, hit);
+                auto hitPacket = ((mask >> i) & 1) != 0;
+                if (hitScalar != hitPacket || (hitScalar && Math::abs(hit.t - packetHits[i].t) > MESH_T_TOLERANCE)) {
+                    ++mismatchCount;
+                }
+            }
+        }
+        benchmark.verify(name, rays.size(), mismatchCount);
+    };
+    verifyPacket("Intersect::intersectRayPacketMesh", worldRays, packets);
+    verifyPacket("Intersect::intersectRayPacketMesh(camera)", cameraRays, cameraPackets);
+}
+
+void CollisionBenchmark::runOverlap(Benchmark& benchmark, const BenchmarkScene& scene) {
+    const auto aabbCount = std::min<size_t>(scene.aabbs.size(), BRUTE_FORCE_SHAPE_COUNT);
+    benchmark.run("Intersect::intersectAABB", aabbCount * (aabbCount - 1) / 2, [&]() {
+        unsigned long long hits = 0;
+        for (size_t i = 0; i < aabbCount; ++i) {
+            for (size_t j = i + 1; j < aabbCount; ++j) {
+                if (Intersect::intersectAABB(scene.aabbs[i], scene.aabbs[j])) {
+                    ++hits;
+                }
+            }
+        }
+        return hits;
+    });
+
+    const auto sphereCount = std::min<size_t>(scene.spheres.size(), BRUTE_FORCE_SHAPE_COUNT);
+    benchmark.run("Intersect::intersectSphere", sphereCount * (sphereCount - 1) / 2, [&]() {
+        unsigned long long hits = 0;
+        for (size_t i = 0; i < sphereCount; ++i) {
+            for (size_t j = i + 1; j < sphereCount; ++j) {
+                if (Intersect::intersectSphere(scene.spheres[i], scene.spheres[j])) {
+                    ++hits;
+                }
+            }
+        }
+        return hits;
+    });
+}
+
+void CollisionBenchmark::runBroadphase(Benchmark& benchmark, const BenchmarkScene& scene) {
+    const auto& aabbs = scene.aabbs;
+
+    benchmark.run("DynamicAABBTree::createProxy", aabbs.size(), [&]() {
+        DynamicAABBTree tree;
+        for (unsigned i = 0; i < aabbs.size(); ++i) {
+            tree.createProxy(aabbs[i], i);
+        }
+        return static_cast<unsigned long long>(tree.getHeight());
+    });
+
+    DynamicAABBTree tree;
+    for (unsigned i = 0; i < aabbs.size(); ++i) {
+        tree.createProxy(aabbs[i], i);
+    }
+
+    benchmark.run("DynamicAABBTree::query", aabbs.size(), [&]() {
+        unsigned long long hits = 0;
+        std::vector<unsigned> out;
+        for (const auto& aabb : aabbs) {
+            out.clear();
+            tree.query(aabb, out);
+            hits += out.size();
+        }
+        return hits;
+    });
+
+    benchmark.run("DynamicAABBTree::raycast", scene.rays.size(), [&]() {
+        unsigned long long hits = 0;
+        std::vector<unsigned> out;
+        for (const auto& ray : scene.rays) {
+            out.clear();
+            tree.raycast(ray, out);
+            hits += out.size();
+        }
+        return hits;
+    });
+
+    //セルはAABBの最大の大きさに合わせる
+    SpatialHashGrid grid;
+    grid.setCellSize(4.f);
+    for (unsigned i = 0; i < aabbs.size(); ++i) {
+        grid.createProxy(aabbs[i], i);
+    }
+
+    benchmark.run("SpatialHashGrid::computePairs", aabbs.size(), [&]() {
+        std::vector<std::pair<unsigned, unsigned>> pairs;
+        grid.computePairs(pairs);
+        return static_cast<unsigned long long>(pairs.size());
+    });
+
+    //Physicsの既定のブロードフェーズ 最初の更新で端点を整列してペアを求める
+    benchmark.run("SweepAndPrune::createProxy", aabbs.size(), [&]() {
+        SweepAndPrune sap;
+        for (unsigned i = 0; i < aabbs.size(); ++i) {
+            sap.createProxy(aabbs[i], i);
+        }
+        sap.update();
+        return static_cast<unsigned long long>(sap.getPairCount());
+    });
+
+    SweepAndPrune sap;
+    for (unsigned i = 0; i < aabbs.size(); ++i) {
+        sap.createProxy(aabbs[i], i);
+    }
+    sap.update();
+
+    //グリッドと同じペアが見つかるので、集計値も一致する
+    benchmark.run("SweepAndPrune::computePairs", aabbs.size(), [&]() {
+        std::vector<std::pair<unsigned, unsigned>> pairs;
+        sap.update();
+        sap.computePairs(pairs);
+        return static_cast<unsigned long long>(pairs.size());
+    });
+}
+
+void CollisionBenchmark::runSweepAndPrune(Benchmark& benchmark, unsigned seed) {
+    for (auto objectCount : SAP_OBJECT_COUNTS) {
+        BenchmarkSceneSettings settings;
+        settings.objectCount = objectCount;
+        settings.rayCount = 0;
+        settings.triangleCount = 0;
+        BenchmarkScene scene;
+        scene.generate(settings, seed);
+        const auto& aabbs = scene.aabbs;
+
+        //1フレーム分だけ動かしたAABB
+        std::vector<AABB> moved(aabbs.size());
+        for (size_t i = 0; i < aabbs.size(); ++i) {
+            auto move = Random::randomRange(Vector3::one * -SAP_MOVE, Vector3::one * SAP_MOVE);
+            moved[i] = AABB(aabbs[i].min + move, aabbs[i].max + move);
+        }
+
+        //最初の並べ替えは整列されていない配列の挿入ソートになるので、計測前に済ませておく
+        SweepAndPrune sap;
+        std::vector<int> proxies(aabbs.size());
+        for (unsigned i = 0; i < aabbs.size(); ++i) {
+            proxies[i] = sap.createProxy(aabbs[i], i);
+        }
+        sap.update();
+
+        //動かして元に戻す2フレームで、毎回同じペア数になるようにする
+        auto name = "SweepAndPrune::update(" + std::to_string(objectCount) + ")";
+        benchmark.run(name, aabbs.size() * 2, [&]() {
+            unsigned long long pairs = 0;
+            for (size_t i = 0; i < proxies.size(); ++i) {
+                sap.moveProxy(proxies[i], moved[i]);
+            }
+            sap.update();
+            pairs += sap.getPairCount();
+            for (size_t i = 0; i < proxies.size(); ++i) {
+                sap.moveProxy(proxies[i], aabbs[i]);
+            }
+            sap.update();
+            pairs += sap.getPairCount();
+            return pairs;
+        });
+    }
+}
+
+void CollisionBenchmark::runLayout(Benchmark& benchmark) {
+    using PairArray = std::vector<std::pair<unsigned, unsigned>>;
+
+    std::vector<AABB> aabbs;
+    BenchmarkLayout::create(LAYOUT_COPIES, aabbs);
+
+    SpatialHashGrid grid;
+    grid.setCellSize(LAYOUT_CELL_SIZE);
+    SweepAndPrune sap;
+    DynamicAABBTree tree;
+    for (unsigned i = 0; i < aabbs.size(); ++i) {
+        grid.createProxy(aabbs[i], i);
+        sap.createProxy(aabbs[i], i);
+        tree.createProxy(aabbs[i], i);
+    }
+    sap.update();
+
+    PairArray gridPairs;
+    benchmark.run("SpatialHashGrid::computePairs(Assets/Data x100)", aabbs.size(), [&]() {
+        gridPairs.clear();
+        grid.computePairs(gridPairs);
+        return static_cast<unsigned long long>(gridPairs.size());
+    });
+
+    //配置は動かないので、毎フレームの端点の更新と並べ直しの確認だけの負荷になる
+    PairArray sapPairs;
+    benchmark.run("SweepAndPrune::update(Assets/Data x100)", aabbs.size(), [&]() {
+        sap.update();
+        sapPairs.clear();
+        sap.computePairs(sapPairs);
+        return static_cast<unsigned long long>(sapPairs.size());
+    });
+
+    //木は広げたAABBで返すので、元のAABBで重なりを確かめる
+    PairArray treePairs;
+    benchmark.run("DynamicAABBTree::query(Assets/Data x100)", aabbs.size(), [&]() {
+        treePairs.clear();
+        std::vector<unsigned> out;
+        for (unsigned i = 0; i < aabbs.size(); ++i) {
+            out.clear();
+            tree.query(aabbs[i], out);
+            for (auto other : out) {
+                if (other > i && Intersect::intersectAABB(aabbs[i], aabbs[other])) {
+                    treePairs.emplace_back(i, other);
+                }
+            }
+        }
+        return static_cast<unsigned long long>(treePairs.size());
+    });
+
+    //3つのブロードフェーズで同じペアが見つかっているか突き合わせる
+    auto normalize = [](PairArray& pairs) {
+        for (auto&& pair : pairs) {
+            if (pair.first > pair.second) {
+                std::swap(pair.first, pair.second);
+            }
+        }
+        std::sort(pairs.begin(), pairs.end());
+    };
+    normalize(gridPairs);
+    normalize(sapPairs);
+    normalize(treePairs);
+    size_t mismatchCount = 0;
+    if (gridPairs != treePairs) {
+        ++mismatchCount;
+    }
+    if (sapPairs != treePairs) {
+        ++mismatchCount;
+    }
+    benchmark.verify("broadphase pairs(Assets/Data x100)", 2, mismatchCount);
+}
@@ -0,0 +1,48 @@
+﻿#pragma once
+
+class Benchmark;
+struct BenchmarkScene;
+
+//衝突判定とブロードフェーズの計測項目
+class CollisionBenchmark {
+public:
+    //全項目を計測する
+    static void run(Benchmark& benchmark, const BenchmarkScene& scene, unsigned seed);
+
+private:
+    CollisionBenchmark() = delete;
+    ~CollisionBenchmark() = delete;
+
+    //軸に平行でAABBの面上を通るレイについて、スカラー・SoA・パケットの判定結果を突き合わせる
+    static void verifyRayAABB(Benchmark& benchmark, const BenchmarkScene& scene);
+    //レイと基本形状の判定
+    static void runRay(Benchmark& benchmark, const BenchmarkScene& scene);
+    //レイとメッシュの判定
+    static void runMesh(Benchmark& benchmark, const BenchmarkScene& scene);
+    //形状同士の総当たり判定
+    static void runOverlap(Benchmark& benchmark, const BenchmarkScene& scene);
+    //ブロードフェーズ
+    static void runBroadphase(Benchmark& benchmark, const BenchmarkScene& scene);
+    //オブジェクト数ごとのSweep and Pruneの毎フレームの更新
+    static void runSweepAndPrune(Benchmark& benchmark, unsigned seed);
+    //Assets/Dataの配置を複製したシーンで、各ブロードフェーズのペア検出を同じ入力に対して計測する
+    static void runLayout(Benchmark& benchmark);
+
+private:
+    //総当たりで調べるポリゴン数の上限
+    static constexpr unsigned BRUTE_FORCE_POLYGON_COUNT = 2048;
+    //総当たりで調べる形状数の上限
+    static constexpr unsigned BRUTE_FORCE_SHAPE_COUNT = 4096;
+    //突き合わせに使うAABBの数
+    static constexpr unsigned VERIFY_AABB_COUNT = 256;
+    //メッシュとの交点の位置をスカラーとパケットで突き合わせるときの許容誤差
+    static constexpr float MESH_T_TOLERANCE = 0.0001f;
+    //Sweep and Pruneを計測するオブジェクト数
+    static constexpr unsigned SAP_OBJECT_COUNTS[] = { 1000, 10000, 50000 };
+    //Sweep and Pruneで1フレームに動かす距離の上限
+    static constexpr float SAP_MOVE = 0.1f;
+    //Assets/Dataの配置を複製する数
+    static constexpr unsigned LAYOUT_COPIES = 100;
+    //Assets/Dataの配置で使うグリッドのセルの大きさ Global.jsonの値に合わせる
+    static constexpr float LAYOUT_CELL_SIZE = 4.f;
+};
@@ -0,0 +1,64 @@
+﻿#include "Benchmark.h"
+#include "BenchmarkScene.h"
+#include "CollisionBenchmark.h"
+#include "MathBenchmark.h"
+#include "TransformBenchmark.h"
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+//使い方: Benchmark [--seed N] [--samples N] [--objects N] [--rays N] [--triangles N] [--out file.json]
+//結果のJSONは--outがなければ標準出力に書き出す
+//実装間の結果の突き合わせで食い違いがあれば終了コード2を返す
+int main(int argc, char* argv[]) {
+    unsigned seed = 12345;
+    int samples = 5;
+    BenchmarkSceneSettings settings;
+    const char* outPath = nullptr;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const char* key = argv[i];
+        const char* value = argv[i + 1];
+        if (strcmp(key, "--seed") == 0) {
+            seed = static_cast<unsigned>(strtoul(value, nullptr, 10));
+        } else if (strcmp(key, "--samples") == 0) {
+            samples = atoi(value);
+        } else if (strcmp(key, "--objects") == 0) {
+            settings.objectCount = static_cast<unsigned>(strtoul(value, nullptr, 10));
+        } else if (strcmp(key, "--rays") == 0) {
+            settings.rayCount = static_cast<unsigned>(strtoul(value, nullptr, 10));
+        } else if (strcmp(key, "--triangles") == 0) {
+            settings.triangleCount = static_cast<unsigned>(strtoul(value, nullptr, 10));
+        } else if (strcmp(key, "--out") == 0) {
+            outPath = value;
+        } else {
+            std::cerr << "unknown option: " << key << std::endl;
+            return 1;
+        }
+    }
+
+    BenchmarkScene scene;
+    scene.generate(settings, seed);
+
+    Benchmark benchmark(samples, seed);
+    MathBenchmark::run(benchmark, seed);
+    TransformBenchmark::run(benchmark, seed);
+    CollisionBenchmark::run(benchmark, scene, seed);
+
+    //実装間で結果が食い違った場合は失敗として終了する
+    const int result = (benchmark.passed()) ? 0 : 2;
+    if (!outPath) {
+        benchmark.writeJson(std::cout);
+        return result;
+    }
+
+    std::ofstream file(outPath);
+    if (!file) {
+        std::cerr << "failed to open: " << outPath << std::endl;
+        return 1;
+    }
+    benchmark.writeJson(file);
+
+    return result;
+}
@@ -0,0 +1,225 @@
+﻿#include "MathBenchmark.h"
+#include "Benchmark.h"
+#include "../DirectX/Utility/Random.h"
+
+void MathBenchmark::run(Benchmark& benchmark, unsigned seed) {
+    std::vector<Matrix4> matrices;
+    createMatrices(matrices, seed);
+
+    runMatrix(benchmark, matrices);
+    runTransform(benchmark, matrices[0]);
+    runQuaternion(benchmark);
+}
+
+void MathBenchmark::runMatrix(Benchmark& benchmark, const std::vector<Matrix4>& matrices) {
+    //行列の結果は符号ビットの数を集計して比較に使う
+    auto countNegative = [](const Matrix4& mat) {
+        unsigned long long count = 0;
+        for (int i = 0; i < 4; ++i) {
+            for (int j = 0; j < 4; ++j) {
+                if (mat.m[i][j] < 0.f) {
+                    ++count;
+                }
+            }
+        }
+        return count;
+    };
+
+    std::vector<Matrix4> out(matrices.size());
+
+    benchmark.run("Matrix4::operator*", matrices.size(), [&]() {
+        for (size_t i = 0; i < matrices.size(); ++i) {
+            out[i] = matrices[i] * matrices[(i + 1) % matrices.size()];
+        }
+        return countNegative(out[0]) + countNegative(out.back());
+    });
+
+    benchmark.run("Matrix4::transpose", matrices.size(), [&]() {
+        for (size_t i = 0; i < matrices.size(); ++i) {
+            out[i] = matrices[i];
+            out[i].transpose();
+        }
+        return countNegative(out[0]) + countNegative(out.back());
+    });
+
+    benchmark.run("Matrix4::inverse", matrices.size(), [&]() {
+        for (size_t i = 0; i < matrices.size(); ++i) {
+            out[i] = Matrix4::inverse(matrices[i]);
+        }
+        return countNegative(out[0]) + countNegative(out.back());
+    });
+
+    benchmark.run("Matrix4::inverseAffine", matrices.size(), [&]() {
+        for (size_t i = 0; i < matrices.size(); ++i) {
+            out[i] = Matrix4::inverseAffine(matrices[i]);
+        }
+        return countNegative(out[0]) + countNegative(out.back());
+    });
+}
+
+void MathBenchmark::runTransform(Benchmark& benchmark, const Matrix4& mat) {
+    std::vector<Vector3> points(POINT_COUNT);
+    for (auto&& p : points) {
+        p = Random::randomRange(Vector3::one * -100.f, Vector3::one * 100.f);
+    }
+    std::vector<float> xs(POINT_COUNT), ys(POINT_COUNT), zs(POINT_COUNT), ws(POINT_COUNT, 1.f);
+    for (size_t i = 0; i < points.size(); ++i) {
+        xs[i] = points[i].x;
+        ys[i] = points[i].y;
+        zs[i] = points[i].z;
+    }
+
+    //結果は正の成分の数を集計して比較に使う
+    std::vector<Vector3> out(POINT_COUNT);
+    auto countPositive = [&]() {
+        unsigned long long count = 0;
+        for (const auto& p : out) {
+            count += (p.x > 0.f) + (p.y > 0.f) + (p.z > 0.f);
+        }
+        return count;
+    };
+
+    //1点ずつ変換する場合との比較用
+    benchmark.run("Vector3::transform", points.size(), [&]() {
+        for (size_t i = 0; i < points.size(); ++i) {
+            out[i] = Vector3::transform(points[i], mat);
+        }
+        return countPositive();
+    });
+
+    benchmark.run("Vector3::transformArray", points.size(), [&]() {
+        Vector3::transformArray(points.data(), out.data(), points.size(), mat);
+        return countPositive();
+    });
+
+    benchmark.run("Vector3::transformNormalArray", points.size(), [&]() {
+        Vector3::transformNormalArray(points.data(), out.data(), points.size(), mat);
+        return countPositive();
+    });
+
+    std::vector<float> ox(POINT_COUNT), oy(POINT_COUNT), oz(POINT_COUNT), ow(POINT_COUNT);
+    benchmark.run("Vector3::transformArray(SoA)", points.size(), [&]() {
+        Vector3::transformArray(xs.data(), ys.data(), zs.data(), ox.data(), oy.data(), oz.data(), points.size(), mat);
+        unsigned long long count = 0;
+        for (size_t i = 0; i < points.size(); ++i) {
+            count += (ox[i] > 0.f) + (oy[i] > 0.f) + (oz[i] > 0.f);
+        }
+        return count;
+    });
+
+    std::vector<Vector4> out4(POINT_COUNT);
+    benchmark.run("Vector4::transformArray", points.size(), [&]() {
+        Vector4::transformArray(points.data(), out4.data(), points.size(), mat);
+        unsigned long long count = 0;
+        for (const auto& p : out4) {
+            count += (p.x > 0.f) + (p.y > 0.f) + (p.z > 0.f);
+        }
+        return count;
+    });
+
+    benchmark.run("Vector4::transformArray(SoA)", points.size(), [&]() {
+        Vector4::transformArray(xs.data(), ys.data(), zs.data(), ws.data(), ox.data(), oy.data(), oz.data(), ow.data(), points.size(), mat);
+        unsigned long long count = 0;
+        for (size_t i = 0; i < points.size(); ++i) {
+            count += (ox[i] > 0.f) + (oy[i] > 0.f) + (oz[i] > 0.f);
+        }
+        return count;
+    });
+}
+
+void MathBenchmark::runQuaternion(Benchmark& benchmark) {
+    std::vector<Quaternion> a(MATRIX_COUNT), b(MATRIX_COUNT);
+    std::vector<Vector3> scales(MATRIX_COUNT), positions(MATRIX_COUNT);
+    for (size_t i = 0; i < MATRIX_COUNT; ++i) {
+        auto axis = Random::randomRange(Vector3::one * -1.f, Vector3::one) + Vector3::up * 2.f;
+        a[i] = Quaternion(Vector3::normalize(axis), Random::randomRange(-180.f, 180.f));
+        b[i] = Quaternion(Vector3::normalize(axis), Random::randomRange(-180.f, 180.f));
+        scales[i] = Random::randomRange(Vector3::one * 0.5f, Vector3::one * 2.f);
+        positions[i] = Random::randomRange(Vector3::one * -100.f, Vector3::one * 100.f);
+    }
+
+    //結果は正の成分の数を集計して比較に使う
+    std::vector<Quaternion> out(MATRIX_COUNT);
+    auto countPositive = [&]() {
+        unsigned long long count = 0;
+        for (const auto& q : out) {
+            count += (q.x > 0.f) + (q.y > 0.f) + (q.z > 0.f) + (q.w > 0.f);
+        }
+        return count;
+    };
+
+    benchmark.run("Quaternion::lerp", out.size(), [&]() {
+        for (size_t i = 0; i < out.size(); ++i) {
+            out[i] = Quaternion::lerp(a[i], b[i], 0.3f);
+        }
+        return countPositive();
+    });
+
+    benchmark.run("Quaternion::lerpArray", out.size(), [&]() {
+        Quaternion::lerpArray(a.data(), b.data(), out.data(), out.size(), 0.3f);
+        return countPositive();
+    });
+
+    benchmark.run("Quaternion::slerp", out.size(), [&]() {
+        for (size_t i = 0; i < out.size(); ++i) {
+            out[i] = Quaternion::slerp(a[i], b[i], 0.3f);
+        }
+        return countPositive();
+    });
+
+    benchmark.run("Quaternion::slerpArray", out.size(), [&]() {
+        Quaternion::slerpArray(a.data(), b.data(), out.data(), out.size(), 0.3f);
+        return countPositive();
+    });
+
+    std::vector<Matrix4> matrices(MATRIX_COUNT);
+    auto countNegative = [&]() {
+        unsigned long long count = 0;
+        for (const auto& mat : matrices) {
+            for (int i = 0; i < 4; ++i) {
+                count += (mat.m[i][0] < 0.f) + (mat.m[i][1] < 0.f) + (mat.m[i][2] < 0.f);
+            }
+        }
+        return count;
+    };
+
+    benchmark.run("Matrix4::createFromQuaternion", matrices.size(), [&]() {
+        for (size_t i = 0; i < matrices.size(); ++i) {
+            matrices[i] = Matrix4::createFromQuaternion(a[i]);
+        }
+        return countNegative();
+    });
+
+    benchmark.run("Matrix4::createFromQuaternionArray", matrices.size(), [&]() {
+        Matrix4::createFromQuaternionArray(a.data(), matrices.data(), matrices.size());
+        return countNegative();
+    });
+
+    //Transform3Dが以前行っていた、行列を3つ作って掛け合わせる方法
+    benchmark.run("Matrix4 TRS", matrices.size(), [&]() {
+        for (size_t i = 0; i < matrices.size(); ++i) {
+            matrices[i] = Matrix4::createScale(scales[i]) * Matrix4::createFromQuaternion(a[i]) * Matrix4::createTranslation(positions[i]);
+        }
+        return countNegative();
+    });
+
+    benchmark.run("Matrix4::createTRSArray", matrices.size(), [&]() {
+        Matrix4::createTRSArray(scales.data(), a.data(), positions.data(), matrices.data(), matrices.size());
+        return countNegative();
+    });
+}
+
+void MathBenchmark::createMatrices(std::vector<Matrix4>& out, unsigned seed) {
+    Random::initialize(seed);
+
+    out.resize(MATRIX_COUNT);
+    for (auto&& mat : out) {
+        auto scale = Random::randomRange(Vector3::one * 0.5f, Vector3::one * 2.f);
+        auto axis = Random::randomRange(Vector3::one * -1.f, Vector3::one) + Vector3::up * 2.f;
+        auto angle = Random::randomRange(-180.f, 180.f);
+        auto pos = Random::randomRange(Vector3::one * -100.f, Vector3::one * 100.f);
+        mat = Matrix4::createScale(scale)
+            * Matrix4::createFromQuaternion(Quaternion(Vector3::normalize(axis), angle))
+            * Matrix4::createTranslation(pos);
+    }
+}
@@ -0,0 +1,32 @@
+﻿#pragma once
+
+#include "../DirectX/Math/Math.h"
+#include <vector>
+
+class Benchmark;
+
+//行列やベクトルの演算の計測項目
+class MathBenchmark {
+public:
+    //全項目を計測する
+    static void run(Benchmark& benchmark, unsigned seed);
+
+private:
+    MathBenchmark() = delete;
+    ~MathBenchmark() = delete;
+
+    //行列の演算
+    static void runMatrix(Benchmark& benchmark, const std::vector<Matrix4>& matrices);
+    //点の配列への行列の適用
+    static void runTransform(Benchmark& benchmark, const Matrix4& mat);
+    //クォータニオンの補間とTRS行列の生成
+    static void runQuaternion(Benchmark& benchmark);
+    //乱数でTRS行列を生成する
+    static void createMatrices(std::vector<Matrix4>& out, unsigned seed);
+
+private:
+    //計測に使う行列の数
+    static constexpr unsigned MATRIX_COUNT = 4096;
+    //計測に使う点の数
+    static constexpr unsigned POINT_COUNT = 65536;
+};
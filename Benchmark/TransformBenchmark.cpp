@@ -0,0 +1,113 @@
+﻿#include "TransformBenchmark.h"
+#include "Benchmark.h"
+#include "../DirectX/Device/ThreadPool.h"
+#include "../DirectX/Transform/TransformPool.h"
+#include "../DirectX/Utility/Random.h"
+
+void TransformBenchmark::run(Benchmark& benchmark, unsigned seed) {
+    Random::initialize(seed);
+
+    //ゲームではSceneManagerが持つスレッドプールを渡すので、同じように外から渡す
+    ThreadPool threadPool;
+    TransformPool::instance().setThreadPool(&threadPool);
+
+    std::vector<unsigned> handles;
+    std::vector<unsigned> roots;
+
+    createWide(handles, roots);
+    runHierarchy(benchmark, "Transform(wide)", handles, roots);
+    destroy(handles);
+
+    createDeep(handles, roots);
+    runHierarchy(benchmark, "Transform(deep)", handles, roots);
+    destroy(handles);
+
+    TransformPool::instance().setThreadPool(nullptr);
+}
+
+void TransformBenchmark::createWide(std::vector<unsigned>& handles, std::vector<unsigned>& roots) {
+    handles.clear();
+    roots.clear();
+
+    auto root = createTransform(TransformPool::INVALID_HANDLE);
+    handles.emplace_back(root);
+    roots.emplace_back(root);
+    for (unsigned i = 1; i < TRANSFORM_COUNT; ++i) {
+        handles.emplace_back(createTransform(root));
+    }
+}
+
+void TransformBenchmark::createDeep(std::vector<unsigned>& handles, std::vector<unsigned>& roots) {
+    handles.clear();
+    roots.clear();
+
+    //鎖ごとに根から順に繋げる
+    const auto depth = TRANSFORM_COUNT / CHAIN_COUNT;
+    for (unsigned c = 0; c < CHAIN_COUNT; ++c) {
+        auto parent = createTransform(TransformPool::INVALID_HANDLE);
+        handles.emplace_back(parent);
+        roots.emplace_back(parent);
+        for (unsigned d = 1; d < depth; ++d) {
+            parent = createTransform(parent);
+            handles.emplace_back(parent);
+        }
+    }
+}
+
+unsigned TransformBenchmark::createTransform(unsigned parent) {
+    auto& pool = TransformPool::instance();
+    auto handle = pool.create(nullptr);
+
+    //深い鎖でも値が発散しないよう、移動量は小さく、スケールは1付近にする
+    pool.setLocalPosition(handle, Random::randomRange(Vector3::one * -1.f, Vector3::one));
+    pool.setLocalRotation(handle, Quaternion(Vector3::up, Random::randomRange(-180.f, 180.f)));
+    pool.setLocalScale(handle, Random::randomRange(Vector3::one * 0.99f, Vector3::one * 1.01f));
+    if (parent != TransformPool::INVALID_HANDLE) {
+        pool.setParent(handle, parent);
+    }
+
+    return handle;
+}
+
+void TransformBenchmark::runHierarchy(Benchmark& benchmark, const std::string& name, const std::vector<unsigned>& handles, const std::vector<unsigned>& roots) {
+    auto& pool = TransformPool::instance();
+
+    //根を書き換えて、子孫がすべて求め直しになるようにする
+    auto touchRoots = [&]() {
+        for (auto root : roots) {
+            pool.setLocalPosition(root, pool.getLocalPosition(root));
+        }
+    };
+
+    //結果は位置成分の負の数を集計して比較に使う
+    auto countNegative = [&]() {
+        unsigned long long count = 0;
+        for (auto handle : handles) {
+            const auto& world = pool.getWorldTransform(handle);
+            count += (world.m[3][0] < 0.f) + (world.m[3][1] < 0.f) + (world.m[3][2] < 0.f);
+        }
+        return count;
+    };
+
+    //Transform3D::computeWorldTransformと同じく1つずつ祖先を辿って更新する
+    benchmark.run(name + " serial", handles.size(), [&]() {
+        touchRoots();
+        for (auto handle : handles) {
+            pool.computeWorldTransform(handle);
+        }
+        return countNegative();
+    });
+
+    benchmark.run(name + " parallel", handles.size(), [&]() {
+        touchRoots();
+        pool.computeWorldTransforms();
+        return countNegative();
+    });
+}
+
+void TransformBenchmark::destroy(const std::vector<unsigned>& handles) {
+    auto& pool = TransformPool::instance();
+    for (auto itr = handles.rbegin(); itr != handles.rend(); ++itr) {
+        pool.destroy(*itr);
+    }
+}
@@ -0,0 +1,34 @@
+﻿#pragma once
+
+#include <string>
+#include <vector>
+
+class Benchmark;
+
+//トランスフォーム階層のワールド行列更新の計測項目
+class TransformBenchmark {
+public:
+    //全項目を計測する
+    static void run(Benchmark& benchmark, unsigned seed);
+
+private:
+    TransformBenchmark() = delete;
+    ~TransformBenchmark() = delete;
+
+    //1つの根の直下にすべてが並ぶ、浅く広い階層を作る
+    static void createWide(std::vector<unsigned>& handles, std::vector<unsigned>& roots);
+    //CHAIN_COUNT本の鎖がそれぞれ深く連なる階層を作る
+    static void createDeep(std::vector<unsigned>& handles, std::vector<unsigned>& roots);
+    //乱数でローカル値を持つトランスフォームを作る
+    static unsigned createTransform(unsigned parent);
+    //1つずつ更新する場合と、深さごとに並列に更新する場合を比べる
+    static void runHierarchy(Benchmark& benchmark, const std::string& name, const std::vector<unsigned>& handles, const std::vector<unsigned>& roots);
+    //作ったトランスフォームを破棄する
+    static void destroy(const std::vector<unsigned>& handles);
+
+private:
+    //階層ごとのトランスフォームの数
+    static constexpr unsigned TRANSFORM_COUNT = 65536;
+    //深い階層の鎖の本数
+    static constexpr unsigned CHAIN_COUNT = 256;
+};
@@ -47,6 +47,20 @@ void AABB::rotate(const Quaternion& q) {
     }
 }
 
+AABB AABB::transform(const Matrix4& mat) const {
+    //中心は普通に変換し、広がりは行列の各要素の絶対値で変換する
+    const auto& m = mat.m;
+    auto center = (min + max) * 0.5f;
+    auto extents = (max - min) * 0.5f;
+    auto worldCenter = Vector3::transform(center, mat);
+    Vector3 worldExtents(
+        Math::abs(m[0][0]) * extents.x + Math::abs(m[1][0]) * extents.y + Math::abs(m[2][0]) * extents.z,
+        Math::abs(m[0][1]) * extents.x + Math::abs(m[1][1]) * extents.y + Math::abs(m[2][1]) * extents.z,
+        Math::abs(m[0][2]) * extents.x + Math::abs(m[1][2]) * extents.y + Math::abs(m[2][2]) * extents.z
+    );
+    return AABB(worldCenter - worldExtents, worldCenter + worldExtents);
+}
+
 bool AABB::contains(const Vector3& point) const {
     bool outside = (
         point.x < min.x ||
@@ -60,6 +74,17 @@ bool AABB::contains(const Vector3& point) const {
     return !outside;
 }
 
+bool AABB::contains(const AABB& aabb) const {
+    return (
+        min.x <= aabb.min.x &&
+        min.y <= aabb.min.y &&
+        min.z <= aabb.min.z &&
+        aabb.max.x <= max.x &&
+        aabb.max.y <= max.y &&
+        aabb.max.z <= max.z
+        );
+}
+
 float AABB::minDistanceSquare(const Vector3& point) const {
     //各軸の差を計算する
     float dx = Math::Max(min.x - point.x, 0.f);
@@ -67,7 +92,25 @@ float AABB::minDistanceSquare(const Vector3& point) const {
     float dy = Math::Max(min.y - point.y, 0.f);
     dy = Math::Max(dy, point.y - max.y);
     float dz = Math::Max(min.z - point.z, 0.f);
-    dz = Math::Max(dy, point.z - max.z);
+    dz = Math::Max(dz, point.z - max.z);
     //距離の2乗
     return (dx * dx + dy * dy + dz * dz);
 }
+
+float AABB::surfaceArea() const {
+    auto d = max - min;
+    return 2.f * (d.x * d.y + d.y * d.z + d.z * d.x);
+}
+
+void AABB::expand(float amount) {
+    auto ext = Vector3::one * amount;
+    min -= ext;
+    max += ext;
+}
+
+AABB AABB::combine(const AABB& a, const AABB& b) {
+    AABB aabb(a);
+    aabb.updateMinMax(b.min);
+    aabb.updateMinMax(b.max);
+    return aabb;
+}
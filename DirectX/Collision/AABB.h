@@ -10,6 +10,16 @@ struct AABB {
     AABB(const Vector3& min, const Vector3& max);
     void updateMinMax(const Vector3& point);
     void rotate(const Quaternion& q);
+    //行列で変換した結果を囲むAABBを返す 角を8つ変換せずに中心と広がりから求める
+    AABB transform(const Matrix4& mat) const;
     bool contains(const Vector3& point) const;
+    //AABBを完全に内包しているか
+    bool contains(const AABB& aabb) const;
     float minDistanceSquare(const Vector3& point) const;
+    //表面積
+    float surfaceArea() const;
+    //全方向に広げる
+    void expand(float amount);
+    //2つのAABBを内包するAABBを返す
+    static AABB combine(const AABB& a, const AABB& b);
 };
@@ -0,0 +1,108 @@
+﻿#include "AABBArray.h"
+#include "../Math/SIMD.h"
+
+AABBArray::AABBArray() = default;
+
+void AABBArray::add(const AABB& aabb) {
+    minX.emplace_back(aabb.min.x);
+    minY.emplace_back(aabb.min.y);
+    minZ.emplace_back(aabb.min.z);
+    maxX.emplace_back(aabb.max.x);
+    maxY.emplace_back(aabb.max.y);
+    maxZ.emplace_back(aabb.max.z);
+}
+
+void AABBArray::set(size_t index, const AABB& aabb) {
+    minX[index] = aabb.min.x;
+    minY[index] = aabb.min.y;
+    minZ[index] = aabb.min.z;
+    maxX[index] = aabb.max.x;
+    maxY[index] = aabb.max.y;
+    maxZ[index] = aabb.max.z;
+}
+
+AABB AABBArray::get(size_t index) const {
+    return AABB(
+        Vector3(minX[index], minY[index], minZ[index]),
+        Vector3(maxX[index], maxY[index], maxZ[index])
+    );
+}
+
+void AABBArray::resize(size_t size) {
+    minX.resize(size);
+    minY.resize(size);
+    minZ.resize(size);
+    maxX.resize(size);
+    maxY.resize(size);
+    maxZ.resize(size);
+}
+
+void AABBArray::clear() {
+    minX.clear();
+    minY.clear();
+    minZ.clear();
+    maxX.clear();
+    maxY.clear();
+    maxZ.clear();
+}
+
+size_t AABBArray::size() const {
+    return minX.size();
+}
+
+void AABBArray::transform(const std::vector<Matrix4>& matrices, AABBArray& out) const {
+    const auto count = size();
+    out.resize(count);
+    size_t i = 0;
+
+#ifdef MATH_SSE
+    //4つのAABBをまとめて変換する 行列は要素ごとにレーンへ集める
+    const auto signMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    const auto half = _mm_set1_ps(0.5f);
+    for (; i + 4 <= count; i += 4) {
+        const auto& m0 = matrices[i].m;
+        const auto& m1 = matrices[i + 1].m;
+        const auto& m2 = matrices[i + 2].m;
+        const auto& m3 = matrices[i + 3].m;
+        auto lane = [&](int row, int column) {
+            return _mm_set_ps(m3[row][column], m2[row][column], m1[row][column], m0[row][column]);
+        };
+
+        auto minXs = _mm_loadu_ps(&minX[i]);
+        auto minYs = _mm_loadu_ps(&minY[i]);
+        auto minZs = _mm_loadu_ps(&minZ[i]);
+        auto maxXs = _mm_loadu_ps(&maxX[i]);
+        auto maxYs = _mm_loadu_ps(&maxY[i]);
+        auto maxZs = _mm_loadu_ps(&maxZ[i]);
+        auto cx = _mm_mul_ps(_mm_add_ps(minXs, maxXs), half);
+        auto cy = _mm_mul_ps(_mm_add_ps(minYs, maxYs), half);
+        auto cz = _mm_mul_ps(_mm_add_ps(minZs, maxZs), half);
+        auto ex = _mm_mul_ps(_mm_sub_ps(maxXs, minXs), half);
+        auto ey = _mm_mul_ps(_mm_sub_ps(maxYs, minYs), half);
+        auto ez = _mm_mul_ps(_mm_sub_ps(maxZs, minZs), half);
+
+        float* outMin[3] = { &out.minX[i], &out.minY[i], &out.minZ[i] };
+        float* outMax[3] = { &out.maxX[i], &out.maxY[i], &out.maxZ[i] };
+        for (int column = 0; column < 3; ++column) {
+            auto r0 = lane(0, column);
+            auto r1 = lane(1, column);
+            auto r2 = lane(2, column);
+            auto center = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(cx, r0), _mm_mul_ps(cy, r1)),
+                _mm_add_ps(_mm_mul_ps(cz, r2), lane(3, column))
+            );
+            auto extent = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(ex, _mm_and_ps(r0, signMask)), _mm_mul_ps(ey, _mm_and_ps(r1, signMask))),
+                _mm_mul_ps(ez, _mm_and_ps(r2, signMask))
+            );
+            _mm_storeu_ps(outMin[column], _mm_sub_ps(center, extent));
+            _mm_storeu_ps(outMax[column], _mm_add_ps(center, extent));
+        }
+    }
+#endif // MATH_SSE
+
+    //残りはスカラーで変換する
+    for (; i < count; ++i) {
+        out.set(i, get(i).transform(matrices[i]));
+    }
+}
@@ -0,0 +1,30 @@
+﻿#pragma once
+
+#include "AABB.h"
+#include <vector>
+
+//SIMDでまとめて判定するためのAABBのSoA配列
+struct AABBArray {
+    std::vector<float> minX;
+    std::vector<float> minY;
+    std::vector<float> minZ;
+    std::vector<float> maxX;
+    std::vector<float> maxY;
+    std::vector<float> maxZ;
+
+    AABBArray();
+    //AABBを末尾に追加する
+    void add(const AABB& aabb);
+    //指定位置のAABBを設定する
+    void set(size_t index, const AABB& aabb);
+    //指定位置のAABBを取得する
+    AABB get(size_t index) const;
+    //要素数を変更する
+    void resize(size_t size);
+    //全削除
+    void clear();
+    //要素数
+    size_t size() const;
+    //各AABBを同じ番号の行列で変換し、結果をoutに書き込む
+    void transform(const std::vector<Matrix4>& matrices, AABBArray& out) const;
+};
@@ -2,7 +2,11 @@
 
 #include "AABB.h"
 #include "Circle.h"
+#include "ConvexHull.h"
+#include "Frustum.h"
+#include "GJK.h"
 #include "Intersect.h"
+#include "OBB.h"
 #include "Ray.h"
 #include "Sphere.h"
 #include "Square.h"
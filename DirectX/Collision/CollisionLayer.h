@@ -0,0 +1,15 @@
+﻿#pragma once
+
+//コライダーの衝突レイヤー
+//コライダーは1つのレイヤーに属し、マスクでビットが立っているレイヤーのコライダーとだけ判定する
+namespace CollisionLayer {
+//レイヤーの数
+constexpr int COUNT = 32;
+//すべてのレイヤーと判定するマスク
+constexpr unsigned ALL = 0xffffffff;
+
+//レイヤー番号からマスクのビットを求める
+constexpr unsigned toBit(int layer) {
+    return 1u << layer;
+}
+};
@@ -0,0 +1,297 @@
+﻿#include "ConvexHull.h"
+#include <cassert>
+#include <unordered_map>
+
+ConvexHull::ConvexHull() :
+    mBounds(Vector3::zero, Vector3::zero) {
+}
+
+ConvexHull::~ConvexHull() = default;
+
+void ConvexHull::build(const std::vector<MeshVertices>& meshesVertices) {
+    std::vector<Vector3> points;
+    for (const auto& meshVertices : meshesVertices) {
+        for (const auto& v : meshVertices) {
+            points.emplace_back(v.pos);
+        }
+    }
+
+    build(points);
+}
+
+void ConvexHull::build(const std::vector<Vector3>& points) {
+    mVertices.clear();
+    mIndices.clear();
+    mBounds = AABB(Vector3::zero, Vector3::zero);
+
+    if (points.empty()) {
+        return;
+    }
+
+    mBounds = AABB(points[0], points[0]);
+    for (const auto& p : points) {
+        mBounds.updateMinMax(p);
+    }
+
+    //許容誤差は点群の大きさに合わせる
+    auto size = mBounds.max - mBounds.min;
+    auto epsilon = Math::Max(Math::Max(size.x, size.y), size.z) * 1e-5f;
+
+    std::vector<Face> faces;
+    if (!createInitialTetrahedron(points, faces, epsilon)) {
+        //平面や直線に潰れている場合は面を作らず、サポート写像用に全頂点を残す
+        mVertices = points;
+        return;
+    }
+
+    std::vector<unsigned> all(points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+        all[i] = static_cast<unsigned>(i);
+    }
+    assignOutside(points, faces, 0, all, epsilon);
+
+    //辺(始点, 終点)から、その辺を持つ面への対応 逆向きの辺を引けば隣の面が分かる
+    std::unordered_map<unsigned long long, unsigned> edgeToFace;
+    auto edgeKey = [](unsigned a, unsigned b) {
+        return (static_cast<unsigned long long>(a) << 32) | b;
+    };
+    for (unsigned i = 0; i < faces.size(); ++i) {
+        for (int e = 0; e < 3; ++e) {
+            edgeToFace[edgeKey(faces[i].v[e], faces[i].v[(e + 1) % 3])] = i;
+        }
+    }
+
+    std::vector<unsigned> stack;
+    std::vector<unsigned> visibleFaces;
+    std::vector<std::pair<unsigned, unsigned>> horizon;
+    std::vector<unsigned> orphans;
+
+    for (unsigned f = 0; f < faces.size(); ++f) {
+        if (faces[f].removed || faces[f].outside.empty()) {
+            continue;
+        }
+
+        //面から最も遠い点を次に凸包へ加える
+        unsigned eye = faces[f].outside[0];
+        auto maxDist = Math::negInfinity;
+        for (auto i : faces[f].outside) {
+            auto d = Vector3::dot(points[i], faces[f].normal) - faces[f].distance;
+            if (d > maxDist) {
+                maxDist = d;
+                eye = i;
+            }
+        }
+
+        //その面から隣をたどって点から見える面を集める
+        //見える面の辺のうち、隣の面が見えないものが境界になる
+        visibleFaces.clear();
+        horizon.clear();
+        faces[f].visitedEye = eye;
+        stack.clear();
+        stack.emplace_back(f);
+        while (!stack.empty()) {
+            auto i = stack.back();
+            stack.pop_back();
+            visibleFaces.emplace_back(i);
+
+            for (int e = 0; e < 3; ++e) {
+                auto a = faces[i].v[e];
+                auto b = faces[i].v[(e + 1) % 3];
+                //閉じた凸包なら逆向きの辺を持つ面が必ずある
+                auto itr = edgeToFace.find(edgeKey(b, a));
+                assert(itr != edgeToFace.end());
+                if (itr == edgeToFace.end()) {
+                    horizon.emplace_back(a, b);
+                    continue;
+                }
+                auto neighbor = itr->second;
+                auto& face = faces[neighbor];
+                if (face.visitedEye == eye) {
+                    continue;
+                }
+                //外側の点の振り分けと同じ閾値で判定しないと、ほぼ同一平面の面で判定が食い違う
+                if (Vector3::dot(points[eye], face.normal) - face.distance > epsilon) {
+                    face.visitedEye = eye;
+                    stack.emplace_back(neighbor);
+                } else {
+                    horizon.emplace_back(a, b);
+                }
+            }
+        }
+
+        orphans.clear();
+        for (auto i : visibleFaces) {
+            auto& face = faces[i];
+            for (int e = 0; e < 3; ++e) {
+                edgeToFace.erase(edgeKey(face.v[e], face.v[(e + 1) % 3]));
+            }
+            for (auto p : face.outside) {
+                if (p != eye) {
+                    orphans.emplace_back(p);
+                }
+            }
+            face.outside.clear();
+            face.outside.shrink_to_fit();
+            face.removed = true;
+        }
+
+        //境界の辺と新しい点で面を張り直す
+        auto firstNew = faces.size();
+        for (const auto& e : horizon) {
+            auto index = static_cast<unsigned>(faces.size());
+            addFace(points, faces, e.first, e.second, eye);
+            edgeToFace[edgeKey(e.first, e.second)] = index;
+            edgeToFace[edgeKey(e.second, eye)] = index;
+            edgeToFace[edgeKey(eye, e.first)] = index;
+        }
+        //外側の点は新しい面にしか振り分けないので、処理済みの面を見直す必要はない
+        assignOutside(points, faces, firstNew, orphans, epsilon);
+    }
+
+    compact(points, faces);
+}
+
+Vector3 ConvexHull::support(const Vector3& dir) const {
+    auto best = Vector3::zero;
+    auto bestDot = Math::negInfinity;
+    for (const auto& v : mVertices) {
+        auto d = Vector3::dot(v, dir);
+        if (d > bestDot) {
+            bestDot = d;
+            best = v;
+        }
+    }
+    return best;
+}
+
+const std::vector<Vector3>& ConvexHull::getVertices() const {
+    return mVertices;
+}
+
+const std::vector<unsigned>& ConvexHull::getIndices() const {
+    return mIndices;
+}
+
+const AABB& ConvexHull::getBounds() const {
+    return mBounds;
+}
+
+bool ConvexHull::empty() const {
+    return mVertices.empty();
+}
+
+bool ConvexHull::createInitialTetrahedron(const std::vector<Vector3>& points, std::vector<Face>& faces, float epsilon) const {
+    //各軸の最小、最大の点から最も離れた2点を選ぶ
+    unsigned extremes[6] = {};
+    for (unsigned i = 0; i < points.size(); ++i) {
+        for (int axis = 0; axis < 3; ++axis) {
+            if (points[i][axis] < points[extremes[axis * 2]][axis]) {
+                extremes[axis * 2] = i;
+            }
+            if (points[i][axis] > points[extremes[axis * 2 + 1]][axis]) {
+                extremes[axis * 2 + 1] = i;
+            }
+        }
+    }
+
+    unsigned i0 = 0;
+    unsigned i1 = 0;
+    float maxDistSq = 0.f;
+    for (int i = 0; i < 6; ++i) {
+        for (int j = i + 1; j < 6; ++j) {
+            auto d = (points[extremes[i]] - points[extremes[j]]).lengthSq();
+            if (d > maxDistSq) {
+                maxDistSq = d;
+                i0 = extremes[i];
+                i1 = extremes[j];
+            }
+        }
+    }
+    if (maxDistSq <= epsilon * epsilon) {
+        return false;
+    }
+
+    //直線から最も離れた点
+    auto lineDir = Vector3::normalize(points[i1] - points[i0]);
+    unsigned i2 = 0;
+    maxDistSq = 0.f;
+    for (unsigned i = 0; i < points.size(); ++i) {
+        auto v = points[i] - points[i0];
+        auto d = (v - lineDir * Vector3::dot(v, lineDir)).lengthSq();
+        if (d > maxDistSq) {
+            maxDistSq = d;
+            i2 = i;
+        }
+    }
+    if (maxDistSq <= epsilon * epsilon) {
+        return false;
+    }
+
+    //平面から最も離れた点
+    auto normal = Vector3::normalize(Vector3::cross(points[i1] - points[i0], points[i2] - points[i0]));
+    unsigned i3 = 0;
+    float maxDist = 0.f;
+    for (unsigned i = 0; i < points.size(); ++i) {
+        auto d = Math::abs(Vector3::dot(points[i] - points[i0], normal));
+        if (d > maxDist) {
+            maxDist = d;
+            i3 = i;
+        }
+    }
+    if (maxDist <= epsilon) {
+        return false;
+    }
+
+    //4点目が表側にあるなら裏返して、全ての面が外を向くようにする
+    if (Vector3::dot(points[i3] - points[i0], normal) > 0.f) {
+        std::swap(i1, i2);
+    }
+    addFace(points, faces, i0, i1, i2);
+    addFace(points, faces, i0, i3, i1);
+    addFace(points, faces, i1, i3, i2);
+    addFace(points, faces, i2, i3, i0);
+
+    return true;
+}
+
+void ConvexHull::addFace(const std::vector<Vector3>& points, std::vector<Face>& faces, unsigned a, unsigned b, unsigned c) const {
+    Face face;
+    face.v[0] = a;
+    face.v[1] = b;
+    face.v[2] = c;
+    face.normal = Vector3::normalize(Vector3::cross(points[b] - points[a], points[c] - points[a]));
+    face.distance = Vector3::dot(face.normal, points[a]);
+    face.visitedEye = INVALID_INDEX;
+    face.removed = false;
+    faces.emplace_back(std::move(face));
+}
+
+void ConvexHull::assignOutside(const std::vector<Vector3>& points, std::vector<Face>& faces, size_t firstFace, const std::vector<unsigned>& candidates, float epsilon) const {
+    //最初に外側と判定された面に登録する どの面の外にも無ければ凸包の内側
+    for (auto p : candidates) {
+        for (size_t i = firstFace; i < faces.size(); ++i) {
+            auto& face = faces[i];
+            if (Vector3::dot(points[p], face.normal) - face.distance > epsilon) {
+                face.outside.emplace_back(p);
+                break;
+            }
+        }
+    }
+}
+
+void ConvexHull::compact(const std::vector<Vector3>& points, const std::vector<Face>& faces) {
+    //元の点の番号から凸包の頂点番号への対応
+    std::unordered_map<unsigned, unsigned> remap;
+    for (const auto& face : faces) {
+        if (face.removed) {
+            continue;
+        }
+        for (int i = 0; i < 3; ++i) {
+            auto result = remap.emplace(face.v[i], static_cast<unsigned>(mVertices.size()));
+            if (result.second) {
+                mVertices.emplace_back(points[face.v[i]]);
+            }
+            mIndices.emplace_back(result.first->second);
+        }
+    }
+}
@@ -0,0 +1,62 @@
+﻿#pragma once
+
+#include "AABB.h"
+#include "../Math/Math.h"
+#include "../Mesh/IMeshLoader.h"
+#include <vector>
+
+//メッシュの頂点からクイックハルで構築する凸包
+//メッシュ読み込み時に1度だけ構築し、GJK/EPAのサポート写像として使う
+class ConvexHull {
+    //構築中の面
+    struct Face {
+        unsigned v[3];
+        Vector3 normal;
+        float distance;
+        //この面の外側にある未処理の点
+        std::vector<unsigned> outside;
+        //見える面を探す際に最後に調べた点
+        unsigned visitedEye;
+        bool removed;
+    };
+
+public:
+    ConvexHull();
+    ~ConvexHull();
+
+    //全サブメッシュの頂点から凸包を構築する
+    void build(const std::vector<MeshVertices>& meshesVertices);
+    //点群から凸包を構築する
+    void build(const std::vector<Vector3>& points);
+    //オブジェクト空間で方向に最も遠い頂点を返す
+    Vector3 support(const Vector3& dir) const;
+    //凸包の頂点
+    const std::vector<Vector3>& getVertices() const;
+    //凸包の面の頂点番号 3つで1つの三角形
+    //点群が平面や直線に潰れている場合は空になる
+    const std::vector<unsigned>& getIndices() const;
+    //全体を囲むAABB
+    const AABB& getBounds() const;
+    //頂点が無いか
+    bool empty() const;
+
+private:
+    ConvexHull(const ConvexHull&) = delete;
+    ConvexHull& operator=(const ConvexHull&) = delete;
+
+    //最初の四面体を作る 作れなければfalse
+    bool createInitialTetrahedron(const std::vector<Vector3>& points, std::vector<Face>& faces, float epsilon) const;
+    //面を追加する
+    void addFace(const std::vector<Vector3>& points, std::vector<Face>& faces, unsigned a, unsigned b, unsigned c) const;
+    //点を面の外側リストに振り分ける
+    void assignOutside(const std::vector<Vector3>& points, std::vector<Face>& faces, size_t firstFace, const std::vector<unsigned>& candidates, float epsilon) const;
+    //構築した面から使用している頂点だけを取り出す
+    void compact(const std::vector<Vector3>& points, const std::vector<Face>& faces);
+
+private:
+    std::vector<Vector3> mVertices;
+    std::vector<unsigned> mIndices;
+    AABB mBounds;
+
+    static constexpr unsigned INVALID_INDEX = 0xFFFFFFFF;
+};
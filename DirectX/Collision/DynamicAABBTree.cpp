@@ -0,0 +1,405 @@
+﻿#include "DynamicAABBTree.h"
+#include "Intersect.h"
+#include <cassert>
+
+DynamicAABBTree::DynamicAABBTree() :
+    mRoot(NULL_NODE),
+    mFreeList(NULL_NODE) {
+}
+
+DynamicAABBTree::~DynamicAABBTree() = default;
+
+int DynamicAABBTree::createProxy(const AABB& aabb, unsigned userID) {
+    auto proxyID = allocateNode();
+
+    //少し広げておくことで、小さな移動では木を組み替えずに済む
+    auto& node = mNodes[proxyID];
+    node.aabb = aabb;
+    node.aabb.expand(AABB_MARGIN);
+    node.userID = userID;
+    node.height = 0;
+
+    insertLeaf(proxyID);
+
+    return proxyID;
+}
+
+void DynamicAABBTree::destroyProxy(int proxyID) {
+    assert(0 <= proxyID && proxyID < static_cast<int>(mNodes.size()));
+    assert(mNodes[proxyID].isLeaf());
+
+    removeLeaf(proxyID);
+    freeNode(proxyID);
+}
+
+bool DynamicAABBTree::moveProxy(int proxyID, const AABB& aabb) {
+    assert(0 <= proxyID && proxyID < static_cast<int>(mNodes.size()));
+    assert(mNodes[proxyID].isLeaf());
+
+    //広げたAABBに収まっているなら何もしない
+    if (mNodes[proxyID].aabb.contains(aabb)) {
+        return false;
+    }
+
+    removeLeaf(proxyID);
+
+    mNodes[proxyID].aabb = aabb;
+    mNodes[proxyID].aabb.expand(AABB_MARGIN);
+
+    insertLeaf(proxyID);
+
+    return true;
+}
+
+void DynamicAABBTree::clear() {
+    mNodes.clear();
+    mRoot = NULL_NODE;
+    mFreeList = NULL_NODE;
+}
+
+unsigned DynamicAABBTree::getUserID(int proxyID) const {
+    return mNodes[proxyID].userID;
+}
+
+const AABB& DynamicAABBTree::getFatAABB(int proxyID) const {
+    return mNodes[proxyID].aabb;
+}
+
+void DynamicAABBTree::query(const AABB& aabb, std::vector<unsigned>& out) const {
+    if (mRoot == NULL_NODE) {
+        return;
+    }
+
+    std::vector<int> stack;
+    stack.emplace_back(mRoot);
+    while (!stack.empty()) {
+        auto nodeID = stack.back();
+        stack.pop_back();
+
+        const auto& node = mNodes[nodeID];
+        if (!Intersect::intersectAABB(node.aabb, aabb)) {
+            continue;
+        }
+
+        if (node.isLeaf()) {
+            out.emplace_back(node.userID);
+        } else {
+            stack.emplace_back(node.child1);
+            stack.emplace_back(node.child2);
+        }
+    }
+}
+
+void DynamicAABBTree::raycast(const Ray& ray, std::vector<unsigned>& out) const {
+    if (mRoot == NULL_NODE) {
+        return;
+    }
+
+    //全ノードで同じレイを使うので方向の逆数は1度だけ求める
+    auto invDir = ray.inverseDirection();
+    float t = 0.f;
+
+    std::vector<int> stack;
+    stack.emplace_back(mRoot);
+    while (!stack.empty()) {
+        auto nodeID = stack.back();
+        stack.pop_back();
+
+        const auto& node = mNodes[nodeID];
+        if (!Intersect::intersectRayAABB(ray.start, invDir, node.aabb, 1.f, t)) {
+            continue;
+        }
+
+        if (node.isLeaf()) {
+            out.emplace_back(node.userID);
+        } else {
+            stack.emplace_back(node.child1);
+            stack.emplace_back(node.child2);
+        }
+    }
+}
+
+bool DynamicAABBTree::queryNearest(const Vector3& point, const std::function<float(unsigned)>& distanceSq, unsigned& outUserID) const {
+    if (mRoot == NULL_NODE) {
+        return false;
+    }
+
+    auto bestDistSq = Math::infinity;
+    bool found = false;
+
+    std::vector<int> stack;
+    stack.emplace_back(mRoot);
+    while (!stack.empty()) {
+        auto nodeID = stack.back();
+        stack.pop_back();
+
+        //ノードのAABBまでの距離は中身の距離の下限なので、現在の最短以上なら調べる必要がない
+        const auto& node = mNodes[nodeID];
+        if (node.aabb.minDistanceSquare(point) >= bestDistSq) {
+            continue;
+        }
+
+        if (node.isLeaf()) {
+            auto d = distanceSq(node.userID);
+            if (d < bestDistSq) {
+                bestDistSq = d;
+                outUserID = node.userID;
+                found = true;
+            }
+            continue;
+        }
+
+        //近い子を先に調べるため後に積む
+        auto d1 = mNodes[node.child1].aabb.minDistanceSquare(point);
+        auto d2 = mNodes[node.child2].aabb.minDistanceSquare(point);
+        if (d1 < d2) {
+            stack.emplace_back(node.child2);
+            stack.emplace_back(node.child1);
+        } else {
+            stack.emplace_back(node.child1);
+            stack.emplace_back(node.child2);
+        }
+    }
+
+    return found;
+}
+
+int DynamicAABBTree::getHeight() const {
+    if (mRoot == NULL_NODE) {
+        return 0;
+    }
+    return mNodes[mRoot].height;
+}
+
+int DynamicAABBTree::allocateNode() {
+    int nodeID = NULL_NODE;
+    if (mFreeList == NULL_NODE) {
+        nodeID = static_cast<int>(mNodes.size());
+        mNodes.emplace_back();
+    } else {
+        nodeID = mFreeList;
+        mFreeList = mNodes[nodeID].parent;
+    }
+
+    auto& node = mNodes[nodeID];
+    node.aabb = AABB();
+    node.parent = NULL_NODE;
+    node.child1 = NULL_NODE;
+    node.child2 = NULL_NODE;
+    node.height = 0;
+    node.userID = 0;
+
+    return nodeID;
+}
+
+void DynamicAABBTree::freeNode(int nodeID) {
+    mNodes[nodeID].parent = mFreeList;
+    mNodes[nodeID].height = -1;
+    mFreeList = nodeID;
+}
+
+void DynamicAABBTree::insertLeaf(int leaf) {
+    if (mRoot == NULL_NODE) {
+        mRoot = leaf;
+        mNodes[mRoot].parent = NULL_NODE;
+        return;
+    }
+
+    //表面積の増加が最も少なくなる兄弟ノードを探す
+    auto leafAABB = mNodes[leaf].aabb;
+    auto index = mRoot;
+    while (!mNodes[index].isLeaf()) {
+        const auto& node = mNodes[index];
+        auto child1 = node.child1;
+        auto child2 = node.child2;
+
+        auto area = node.aabb.surfaceArea();
+        auto combinedArea = AABB::combine(node.aabb, leafAABB).surfaceArea();
+
+        //このノードと葉で新しい親を作るコスト
+        auto cost = 2.f * combinedArea;
+        //さらに下に降りる場合に祖先が広がる分のコスト
+        auto inheritanceCost = 2.f * (combinedArea - area);
+
+        auto descendCost = [&](int child) {
+            const auto& c = mNodes[child];
+            auto newArea = AABB::combine(leafAABB, c.aabb).surfaceArea();
+            if (c.isLeaf()) {
+                return newArea + inheritanceCost;
+            }
+            return (newArea - c.aabb.surfaceArea()) + inheritanceCost;
+        };
+        auto cost1 = descendCost(child1);
+        auto cost2 = descendCost(child2);
+
+        if (cost < cost1 && cost < cost2) {
+            break;
+        }
+
+        index = (cost1 < cost2) ? child1 : child2;
+    }
+
+    auto sibling = index;
+
+    //新しい親を作る ノード確保で配列が再確保されるので参照は後で取る
+    auto oldParent = mNodes[sibling].parent;
+    auto newParent = allocateNode();
+    mNodes[newParent].parent = oldParent;
+    mNodes[newParent].aabb = AABB::combine(leafAABB, mNodes[sibling].aabb);
+    mNodes[newParent].height = mNodes[sibling].height + 1;
+    mNodes[newParent].child1 = sibling;
+    mNodes[newParent].child2 = leaf;
+    mNodes[sibling].parent = newParent;
+    mNodes[leaf].parent = newParent;
+
+    if (oldParent == NULL_NODE) {
+        mRoot = newParent;
+    } else if (mNodes[oldParent].child1 == sibling) {
+        mNodes[oldParent].child1 = newParent;
+    } else {
+        mNodes[oldParent].child2 = newParent;
+    }
+
+    refitAncestors(mNodes[leaf].parent);
+}
+
+void DynamicAABBTree::removeLeaf(int leaf) {
+    if (leaf == mRoot) {
+        mRoot = NULL_NODE;
+        return;
+    }
+
+    auto parent = mNodes[leaf].parent;
+    auto grandParent = mNodes[parent].parent;
+    auto sibling = (mNodes[parent].child1 == leaf) ? mNodes[parent].child2 : mNodes[parent].child1;
+
+    //親を消して兄弟を繰り上げる
+    if (grandParent == NULL_NODE) {
+        mRoot = sibling;
+        mNodes[sibling].parent = NULL_NODE;
+        freeNode(parent);
+        return;
+    }
+
+    if (mNodes[grandParent].child1 == parent) {
+        mNodes[grandParent].child1 = sibling;
+    } else {
+        mNodes[grandParent].child2 = sibling;
+    }
+    mNodes[sibling].parent = grandParent;
+    freeNode(parent);
+
+    refitAncestors(grandParent);
+}
+
+int DynamicAABBTree::balance(int iA) {
+    auto& A = mNodes[iA];
+    if (A.isLeaf() || A.height < 2) {
+        return iA;
+    }
+
+    auto iB = A.child1;
+    auto iC = A.child2;
+    auto& B = mNodes[iB];
+    auto& C = mNodes[iC];
+
+    auto diff = C.height - B.height;
+
+    //Cを持ち上げる
+    if (diff > 1) {
+        auto iF = C.child1;
+        auto iG = C.child2;
+        auto& F = mNodes[iF];
+        auto& G = mNodes[iG];
+
+        C.child1 = iA;
+        C.parent = A.parent;
+        A.parent = iC;
+
+        if (C.parent == NULL_NODE) {
+            mRoot = iC;
+        } else if (mNodes[C.parent].child1 == iA) {
+            mNodes[C.parent].child1 = iC;
+        } else {
+            mNodes[C.parent].child2 = iC;
+        }
+
+        //高い方の孫をCの下に残す
+        if (F.height > G.height) {
+            C.child2 = iF;
+            A.child2 = iG;
+            G.parent = iA;
+            A.aabb = AABB::combine(B.aabb, G.aabb);
+            C.aabb = AABB::combine(A.aabb, F.aabb);
+            A.height = 1 + Math::Max(B.height, G.height);
+            C.height = 1 + Math::Max(A.height, F.height);
+        } else {
+            C.child2 = iG;
+            A.child2 = iF;
+            F.parent = iA;
+            A.aabb = AABB::combine(B.aabb, F.aabb);
+            C.aabb = AABB::combine(A.aabb, G.aabb);
+            A.height = 1 + Math::Max(B.height, F.height);
+            C.height = 1 + Math::Max(A.height, G.height);
+        }
+
+        return iC;
+    }
+
+    //Bを持ち上げる
+    if (diff < -1) {
+        auto iD = B.child1;
+        auto iE = B.child2;
+        auto& D = mNodes[iD];
+        auto& E = mNodes[iE];
+
+        B.child1 = iA;
+        B.parent = A.parent;
+        A.parent = iB;
+
+        if (B.parent == NULL_NODE) {
+            mRoot = iB;
+        } else if (mNodes[B.parent].child1 == iA) {
+            mNodes[B.parent].child1 = iB;
+        } else {
+            mNodes[B.parent].child2 = iB;
+        }
+
+        if (D.height > E.height) {
+            B.child2 = iD;
+            A.child1 = iE;
+            E.parent = iA;
+            A.aabb = AABB::combine(C.aabb, E.aabb);
+            B.aabb = AABB::combine(A.aabb, D.aabb);
+            A.height = 1 + Math::Max(C.height, E.height);
+            B.height = 1 + Math::Max(A.height, D.height);
+        } else {
+            B.child2 = iE;
+            A.child1 = iD;
+            D.parent = iA;
+            A.aabb = AABB::combine(C.aabb, D.aabb);
+            B.aabb = AABB::combine(A.aabb, E.aabb);
+            A.height = 1 + Math::Max(C.height, D.height);
+            B.height = 1 + Math::Max(A.height, E.height);
+        }
+
+        return iB;
+    }
+
+    return iA;
+}
+
+void DynamicAABBTree::refitAncestors(int nodeID) {
+    auto index = nodeID;
+    while (index != NULL_NODE) {
+        index = balance(index);
+
+        auto& node = mNodes[index];
+        const auto& c1 = mNodes[node.child1];
+        const auto& c2 = mNodes[node.child2];
+        node.height = 1 + Math::Max(c1.height, c2.height);
+        node.aabb = AABB::combine(c1.aabb, c2.aabb);
+
+        index = node.parent;
+    }
+}
@@ -0,0 +1,81 @@
+﻿#pragma once
+
+#include "AABB.h"
+#include "Ray.h"
+#include <functional>
+#include <vector>
+
+//移動するAABBを管理する動的な境界ボリューム階層
+//葉には少し広げたAABBを持たせ、その範囲内の移動なら木を組み替えない
+class DynamicAABBTree {
+    //木のノード
+    struct Node {
+        //葉なら広げたAABB、枝なら子を内包するAABB
+        AABB aabb;
+        //親ノード 未使用ノードなら次の空きノード
+        int parent;
+        int child1;
+        int child2;
+        //葉は0 未使用は-1
+        int height;
+        //葉が持つ利用者側の番号
+        unsigned userID;
+
+        bool isLeaf() const {
+            return child1 == NULL_NODE;
+        }
+    };
+
+public:
+    DynamicAABBTree();
+    ~DynamicAABBTree();
+
+    //プロキシを追加してその番号を返す
+    int createProxy(const AABB& aabb, unsigned userID);
+    //プロキシを削除する
+    void destroyProxy(int proxyID);
+    //プロキシを移動する 木を組み替えたならtrueを返す
+    bool moveProxy(int proxyID, const AABB& aabb);
+    //全削除
+    void clear();
+
+    //プロキシの利用者側の番号を取得する
+    unsigned getUserID(int proxyID) const;
+    //プロキシの広げたAABBを取得する
+    const AABB& getFatAABB(int proxyID) const;
+
+    //AABBと重なるプロキシの利用者番号をすべて取得する
+    void query(const AABB& aabb, std::vector<unsigned>& out) const;
+    //レイと交差するプロキシの利用者番号をすべて取得する
+    void raycast(const Ray& ray, std::vector<unsigned>& out) const;
+    //点から最も近いプロキシを探す
+    //distanceSqには利用者番号から正確な距離の2乗を求める関数を渡す
+    bool queryNearest(const Vector3& point, const std::function<float(unsigned)>& distanceSq, unsigned& outUserID) const;
+
+    //木の高さ
+    int getHeight() const;
+
+private:
+    DynamicAABBTree(const DynamicAABBTree&) = delete;
+    DynamicAABBTree& operator=(const DynamicAABBTree&) = delete;
+
+    //ノードを確保・解放する
+    int allocateNode();
+    void freeNode(int nodeID);
+    //葉を木に挿入・木から取り外す
+    void insertLeaf(int leaf);
+    void removeLeaf(int leaf);
+    //回転で部分木の高さを揃える
+    int balance(int iA);
+    //葉から根に向かってAABBと高さを更新する
+    void refitAncestors(int nodeID);
+
+private:
+    std::vector<Node> mNodes;
+    int mRoot;
+    int mFreeList;
+
+    //葉のAABBを広げる量
+    static constexpr float AABB_MARGIN = 0.1f;
+    static constexpr int NULL_NODE = -1;
+};
@@ -0,0 +1,39 @@
+﻿#include "Frustum.h"
+
+Frustum::Frustum() = default;
+
+Frustum::Frustum(const Matrix4& viewProjection) {
+    extract(viewProjection);
+}
+
+void Frustum::extract(const Matrix4& viewProjection) {
+    //行ベクトルなのでクリップ座標の各成分は行列の列との内積になる
+    //DirectXのクリップ空間 -w <= x, y <= w, 0 <= z <= w から各平面を求める
+    const auto& m = viewProjection.m;
+    auto column = [&m](int i) {
+        return Plane(m[0][i], m[1][i], m[2][i], m[3][i]);
+    };
+    auto add = [](const Plane& p1, const Plane& p2, float sign) {
+        return Plane(p1.a + p2.a * sign, p1.b + p2.b * sign, p1.c + p2.c * sign, p1.d + p2.d * sign);
+    };
+
+    auto x = column(0);
+    auto y = column(1);
+    auto z = column(2);
+    auto w = column(3);
+    planes[0] = add(w, x, 1.f);
+    planes[1] = add(w, x, -1.f);
+    planes[2] = add(w, y, 1.f);
+    planes[3] = add(w, y, -1.f);
+    planes[4] = z;
+    planes[5] = add(w, z, -1.f);
+
+    //球の判定で距離として使えるよう正規化する
+    for (auto& p : planes) {
+        auto len = p.normal().length();
+        p.a /= len;
+        p.b /= len;
+        p.c /= len;
+        p.d /= len;
+    }
+}
@@ -0,0 +1,18 @@
+﻿#pragma once
+
+#include "../Math/Math.h"
+
+//視錐台
+//各平面の法線は内側を向き、ax + by + cz + d >= 0 が内側になる
+struct Frustum {
+    static constexpr int PLANE_COUNT = 6;
+
+    //左, 右, 下, 上, 手前, 奥の順
+    Plane planes[PLANE_COUNT];
+
+    Frustum();
+    //ビュー射影行列から6平面を抽出する
+    Frustum(const Matrix4& viewProjection);
+    //ビュー射影行列から6平面を抽出し直す
+    void extract(const Matrix4& viewProjection);
+};
@@ -0,0 +1,442 @@
+﻿#include "GJK.h"
+#include "ConvexHull.h"
+#include <algorithm>
+#include <utility>
+
+ConvexShape::ConvexShape(const ConvexHull& hull, const Matrix4& world) :
+    hull(&hull),
+    world(world) {
+}
+
+Vector3 ConvexShape::support(const Vector3& dir) const {
+    //方向をオブジェクト空間に移す 行ベクトルなので回転拡縮部分の転置を掛ける
+    const auto& m = world.m;
+    Vector3 localDir(
+        m[0][0] * dir.x + m[0][1] * dir.y + m[0][2] * dir.z,
+        m[1][0] * dir.x + m[1][1] * dir.y + m[1][2] * dir.z,
+        m[2][0] * dir.x + m[2][1] * dir.y + m[2][2] * dir.z
+    );
+    return Vector3::transform(hull->support(localDir), world);
+}
+
+bool GJK::intersect(const ConvexShape& a, const ConvexShape& b) {
+    SupportPoint simplex[4];
+    int count = 0;
+    float lambda[4];
+    return solve(a, b, simplex, count, lambda, true) <= INTERSECT_EPSILON_SQ;
+}
+
+float GJK::distance(const ConvexShape& a, const ConvexShape& b, Vector3& outPointA, Vector3& outPointB) {
+    SupportPoint simplex[4];
+    int count = 0;
+    float lambda[4];
+    auto distSq = solve(a, b, simplex, count, lambda, false);
+
+    //重心座標からそれぞれの形状上の点を復元する
+    outPointA = Vector3::zero;
+    outPointB = Vector3::zero;
+    for (int i = 0; i < count; ++i) {
+        outPointA += simplex[i].a * lambda[i];
+        outPointB += simplex[i].b * lambda[i];
+    }
+
+    if (distSq <= INTERSECT_EPSILON_SQ) {
+        return 0.f;
+    }
+    return Math::sqrt(distSq);
+}
+
+bool GJK::penetration(const ConvexShape& a, const ConvexShape& b, Vector3& outNormal, float& outDepth) {
+    SupportPoint simplex[4];
+    int count = 0;
+    float lambda[4];
+    if (solve(a, b, simplex, count, lambda, true) > INTERSECT_EPSILON_SQ) {
+        return false;
+    }
+
+    //接しているだけで体積を持つ四面体が作れないなら深さは0
+    if (!expandToTetrahedron(a, b, simplex, count)) {
+        outNormal = Vector3::up;
+        outDepth = 0.f;
+        return true;
+    }
+
+    std::vector<SupportPoint> vertices(simplex, simplex + 4);
+    std::vector<Face> faces;
+    addFace(vertices, faces, 0, 1, 2);
+    addFace(vertices, faces, 0, 3, 1);
+    addFace(vertices, faces, 1, 3, 2);
+    addFace(vertices, faces, 2, 3, 0);
+    //全ての面が外を向くように揃える
+    auto centroid = (vertices[0].w + vertices[1].w + vertices[2].w + vertices[3].w) / 4.f;
+    for (auto& face : faces) {
+        if (Vector3::dot(face.normal, centroid - vertices[face.v[0]].w) > 0.f) {
+            std::swap(face.v[1], face.v[2]);
+            face.normal = -1.f * face.normal;
+            face.distance = -face.distance;
+        }
+    }
+
+    std::vector<std::pair<unsigned, unsigned>> horizon;
+    for (int n = 0; n < MAX_ITERATION && !faces.empty(); ++n) {
+        //原点に最も近い面を探す
+        size_t closest = 0;
+        for (size_t i = 1; i < faces.size(); ++i) {
+            if (faces[i].distance < faces[closest].distance) {
+                closest = i;
+            }
+        }
+
+        //その面の法線方向にこれ以上広がらなければ収束
+        const auto normal = faces[closest].normal;
+        const auto dist = faces[closest].distance;
+        auto p = support(a, b, normal);
+        if (Vector3::dot(p.w, normal) - dist < EPA_TOLERANCE) {
+            break;
+        }
+
+        //新しい点から見える面を消し、その境界の辺を集める
+        auto newIndex = static_cast<unsigned>(vertices.size());
+        vertices.emplace_back(p);
+        horizon.clear();
+        for (size_t i = 0; i < faces.size();) {
+            const auto& face = faces[i];
+            if (Vector3::dot(face.normal, p.w - vertices[face.v[0]].w) <= 0.f) {
+                ++i;
+                continue;
+            }
+
+            //隣り合う見える面同士で共有する辺は逆向きに現れるので打ち消す
+            for (int e = 0; e < 3; ++e) {
+                auto edge = std::make_pair(face.v[e], face.v[(e + 1) % 3]);
+                auto itr = std::find(horizon.begin(), horizon.end(), std::make_pair(edge.second, edge.first));
+                if (itr != horizon.end()) {
+                    horizon.erase(itr);
+                } else {
+                    horizon.emplace_back(edge);
+                }
+            }
+
+            faces[i] = faces.back();
+            faces.pop_back();
+        }
+
+        for (const auto& e : horizon) {
+            addFace(vertices, faces, e.first, e.second, newIndex);
+        }
+    }
+
+    if (faces.empty()) {
+        outNormal = Vector3::up;
+        outDepth = 0.f;
+        return true;
+    }
+
+    size_t closest = 0;
+    for (size_t i = 1; i < faces.size(); ++i) {
+        if (faces[i].distance < faces[closest].distance) {
+            closest = i;
+        }
+    }
+    outNormal = faces[closest].normal;
+    outDepth = Math::Max(faces[closest].distance, 0.f);
+    return true;
+}
+
+GJK::SupportPoint GJK::support(const ConvexShape& a, const ConvexShape& b, const Vector3& dir) {
+    SupportPoint p;
+    p.a = a.support(dir);
+    p.b = b.support(-1.f * dir);
+    p.w = p.a - p.b;
+    return p;
+}
+
+float GJK::solve(const ConvexShape& a, const ConvexShape& b, SupportPoint* simplex, int& count, float* lambda, bool stopIfSeparated) {
+    //適当な方向のサポート点から始める
+    simplex[0] = support(a, b, Vector3::right);
+    count = 1;
+
+    //前回の単体 近づかなかった場合に戻す
+    SupportPoint prevSimplex[4];
+    float prevLambda[4];
+    int prevCount = 0;
+
+    auto distSq = Math::infinity;
+    for (int n = 0; n < MAX_ITERATION; ++n) {
+        auto v = closestOnSimplex(simplex, count, lambda);
+        auto vSq = v.lengthSq();
+        //前回より近づかなければ数値誤差で振動しているので打ち切る
+        if (vSq >= distSq) {
+            count = prevCount;
+            std::copy(prevSimplex, prevSimplex + prevCount, simplex);
+            std::copy(prevLambda, prevLambda + prevCount, lambda);
+            break;
+        }
+        distSq = vSq;
+        prevCount = count;
+        std::copy(simplex, simplex + count, prevSimplex);
+        std::copy(lambda, lambda + count, prevLambda);
+
+        //原点を含んでいる
+        if (distSq <= INTERSECT_EPSILON_SQ || count == 4) {
+            return 0.f;
+        }
+
+        auto w = support(a, b, -1.f * v);
+        auto vw = Vector3::dot(v, w.w);
+        //原点側にこれ以上進めない方向が見つかったので離れている
+        if (stopIfSeparated && vw > 0.f) {
+            return distSq;
+        }
+        //これ以上近づけない
+        if (distSq - vw <= RELATIVE_TOLERANCE * distSq) {
+            break;
+        }
+
+        simplex[count++] = w;
+    }
+
+    return distSq;
+}
+
+Vector3 GJK::closestOnSimplex(SupportPoint* simplex, int& count, float* lambda) {
+    switch (count) {
+    case 1:
+        lambda[0] = 1.f;
+        return simplex[0].w;
+    case 2:
+        return closestOnSegment(simplex, count, lambda);
+    case 3:
+        return closestOnTriangle(simplex, count, lambda);
+    default:
+        return closestOnTetrahedron(simplex, count, lambda);
+    }
+}
+
+Vector3 GJK::closestOnSegment(SupportPoint* simplex, int& count, float* lambda) {
+    const auto& a = simplex[0].w;
+    auto ab = simplex[1].w - a;
+    auto lenSq = ab.lengthSq();
+    auto t = (lenSq > 0.f) ? -Vector3::dot(a, ab) / lenSq : 0.f;
+
+    if (t <= 0.f) {
+        count = 1;
+        lambda[0] = 1.f;
+        return simplex[0].w;
+    }
+    if (t >= 1.f) {
+        simplex[0] = simplex[1];
+        count = 1;
+        lambda[0] = 1.f;
+        return simplex[0].w;
+    }
+
+    lambda[0] = 1.f - t;
+    lambda[1] = t;
+    return a + ab * t;
+}
+
+Vector3 GJK::closestOnTriangle(SupportPoint* simplex, int& count, float* lambda) {
+    //原点に最も近い点がどの領域にあるかを順に調べる
+    const auto a = simplex[0];
+    const auto b = simplex[1];
+    const auto c = simplex[2];
+    auto ab = b.w - a.w;
+    auto ac = c.w - a.w;
+    auto ap = -1.f * a.w;
+
+    auto d1 = Vector3::dot(ab, ap);
+    auto d2 = Vector3::dot(ac, ap);
+    if (d1 <= 0.f && d2 <= 0.f) {
+        count = 1;
+        lambda[0] = 1.f;
+        return a.w;
+    }
+
+    auto bp = -1.f * b.w;
+    auto d3 = Vector3::dot(ab, bp);
+    auto d4 = Vector3::dot(ac, bp);
+    if (d3 >= 0.f && d4 <= d3) {
+        simplex[0] = b;
+        count = 1;
+        lambda[0] = 1.f;
+        return b.w;
+    }
+
+    auto vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.f && d1 >= 0.f && d3 <= 0.f) {
+        auto t = d1 / (d1 - d3);
+        count = 2;
+        lambda[0] = 1.f - t;
+        lambda[1] = t;
+        return a.w + ab * t;
+    }
+
+    auto cp = -1.f * c.w;
+    auto d5 = Vector3::dot(ab, cp);
+    auto d6 = Vector3::dot(ac, cp);
+    if (d6 >= 0.f && d5 <= d6) {
+        simplex[0] = c;
+        count = 1;
+        lambda[0] = 1.f;
+        return c.w;
+    }
+
+    auto vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.f && d2 >= 0.f && d6 <= 0.f) {
+        auto t = d2 / (d2 - d6);
+        simplex[1] = c;
+        count = 2;
+        lambda[0] = 1.f - t;
+        lambda[1] = t;
+        return a.w + ac * t;
+    }
+
+    auto va = d3 * d6 - d5 * d4;
+    if (va <= 0.f && (d4 - d3) >= 0.f && (d5 - d6) >= 0.f) {
+        auto t = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+        simplex[0] = b;
+        simplex[1] = c;
+        count = 2;
+        lambda[0] = 1.f - t;
+        lambda[1] = t;
+        return b.w + (c.w - b.w) * t;
+    }
+
+    //面の内側
+    auto denom = va + vb + vc;
+    if (Math::abs(denom) <= 0.f) {
+        //潰れた三角形なので辺で調べ直す
+        count = 2;
+        return closestOnSegment(simplex, count, lambda);
+    }
+    auto v = vb / denom;
+    auto w = vc / denom;
+    lambda[0] = 1.f - v - w;
+    lambda[1] = v;
+    lambda[2] = w;
+    return a.w + ab * v + ac * w;
+}
+
+Vector3 GJK::closestOnTetrahedron(SupportPoint* simplex, int& count, float* lambda) {
+    //各面について、残りの頂点と反対側に原点があるかを調べる
+    static constexpr int FACES[4][4] = {
+        { 0, 1, 2, 3 },
+        { 0, 3, 1, 2 },
+        { 0, 2, 3, 1 },
+        { 1, 3, 2, 0 }
+    };
+
+    SupportPoint best[3];
+    float bestLambda[3] = {};
+    int bestCount = 0;
+    auto bestDistSq = Math::infinity;
+    bool inside = true;
+
+    for (const auto& f : FACES) {
+        const auto& a = simplex[f[0]].w;
+        auto n = Vector3::cross(simplex[f[1]].w - a, simplex[f[2]].w - a);
+        auto signP = Vector3::dot(-1.f * a, n);
+        auto signD = Vector3::dot(simplex[f[3]].w - a, n);
+        //体積が無い場合はどちら側か決められないので面を調べる
+        if (signP * signD > 0.f) {
+            continue;
+        }
+        inside = false;
+
+        SupportPoint tri[3] = { simplex[f[0]], simplex[f[1]], simplex[f[2]] };
+        int triCount = 3;
+        float triLambda[3];
+        auto p = closestOnTriangle(tri, triCount, triLambda);
+        auto distSq = p.lengthSq();
+        if (distSq < bestDistSq) {
+            bestDistSq = distSq;
+            bestCount = triCount;
+            for (int i = 0; i < triCount; ++i) {
+                best[i] = tri[i];
+                bestLambda[i] = triLambda[i];
+            }
+        }
+    }
+
+    //全ての面の内側なら原点を含んでいる
+    if (inside) {
+        count = 4;
+        for (int i = 0; i < 4; ++i) {
+            lambda[i] = 0.25f;
+        }
+        return Vector3::zero;
+    }
+
+    auto result = Vector3::zero;
+    count = bestCount;
+    for (int i = 0; i < bestCount; ++i) {
+        simplex[i] = best[i];
+        lambda[i] = bestLambda[i];
+        result += best[i].w * bestLambda[i];
+    }
+    return result;
+}
+
+bool GJK::expandToTetrahedron(const ConvexShape& a, const ConvexShape& b, SupportPoint* simplex, int& count) {
+    static const Vector3 AXES[6] = {
+        Vector3::right, Vector3::left, Vector3::up, Vector3::down, Vector3::forward, Vector3::back
+    };
+    constexpr float EPSILON = 1e-6f;
+
+    if (count == 1) {
+        for (const auto& axis : AXES) {
+            auto p = support(a, b, axis);
+            if ((p.w - simplex[0].w).lengthSq() > EPSILON) {
+                simplex[count++] = p;
+                break;
+            }
+        }
+    }
+
+    if (count == 2) {
+        //線分と直交する方向を探す
+        auto d = simplex[1].w - simplex[0].w;
+        for (const auto& axis : AXES) {
+            auto dir = Vector3::cross(d, axis);
+            if (dir.lengthSq() <= EPSILON) {
+                continue;
+            }
+            auto p = support(a, b, dir);
+            if (Vector3::cross(p.w - simplex[0].w, d).lengthSq() > EPSILON) {
+                simplex[count++] = p;
+                break;
+            }
+        }
+    }
+
+    if (count == 3) {
+        //三角形の法線の表裏どちらかに広げる
+        auto n = Vector3::cross(simplex[1].w - simplex[0].w, simplex[2].w - simplex[0].w);
+        auto p = support(a, b, n);
+        if (Math::abs(Vector3::dot(p.w - simplex[0].w, n)) <= EPSILON) {
+            p = support(a, b, -1.f * n);
+        }
+        if (Math::abs(Vector3::dot(p.w - simplex[0].w, n)) > EPSILON) {
+            simplex[count++] = p;
+        }
+    }
+
+    return (count == 4);
+}
+
+bool GJK::addFace(const std::vector<SupportPoint>& vertices, std::vector<Face>& faces, unsigned a, unsigned b, unsigned c) {
+    auto n = Vector3::cross(vertices[b].w - vertices[a].w, vertices[c].w - vertices[a].w);
+    if (n.lengthSq() <= 0.f) {
+        return false;
+    }
+
+    Face face;
+    face.v[0] = a;
+    face.v[1] = b;
+    face.v[2] = c;
+    face.normal = Vector3::normalize(n);
+    face.distance = Vector3::dot(face.normal, vertices[a].w);
+    faces.emplace_back(face);
+    return true;
+}
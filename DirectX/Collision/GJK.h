@@ -0,0 +1,72 @@
+﻿#pragma once
+
+#include "../Math/Math.h"
+#include <vector>
+
+class ConvexHull;
+
+//GJK/EPAで判定する凸形状
+//オブジェクト空間の凸包をワールド行列で配置したもの
+struct ConvexShape {
+    const ConvexHull* hull;
+    Matrix4 world;
+
+    ConvexShape(const ConvexHull& hull, const Matrix4& world);
+    //ワールド空間で方向に最も遠い点を返す
+    Vector3 support(const Vector3& dir) const;
+};
+
+//凸形状同士の距離、交差、めり込みを求める
+class GJK {
+    GJK() = delete;
+    ~GJK() = delete;
+
+    //ミンコフスキー差上の点と、それを作ったそれぞれの形状上の点
+    struct SupportPoint {
+        Vector3 w;
+        Vector3 a;
+        Vector3 b;
+    };
+
+    //EPAの多面体の面
+    struct Face {
+        unsigned v[3];
+        Vector3 normal;
+        float distance;
+    };
+
+public:
+    //2つの凸形状が重なっているか
+    static bool intersect(const ConvexShape& a, const ConvexShape& b);
+    //2つの凸形状の最短距離を求める 重なっていれば0を返す
+    //outPointA, outPointBにはそれぞれの形状上で最も近い点を返す
+    static float distance(const ConvexShape& a, const ConvexShape& b, Vector3& outPointA, Vector3& outPointB);
+    //EPAでめり込みを求める 重なっていなければfalse
+    //outNormalはaからbへ向かう向きで、bをoutNormal * outDepthだけ動かすと離れる
+    static bool penetration(const ConvexShape& a, const ConvexShape& b, Vector3& outNormal, float& outDepth);
+
+private:
+    //ミンコフスキー差a - bのサポート点
+    static SupportPoint support(const ConvexShape& a, const ConvexShape& b, const Vector3& dir);
+    //GJKの本体 原点に最も近い点までの距離の2乗を返す
+    //stopIfSeparatedなら分離が確定した時点で打ち切る
+    static float solve(const ConvexShape& a, const ConvexShape& b, SupportPoint* simplex, int& count, float* lambda, bool stopIfSeparated);
+    //単体上で原点に最も近い点を求め、その点を表すのに必要な頂点だけに単体を縮める
+    static Vector3 closestOnSimplex(SupportPoint* simplex, int& count, float* lambda);
+    static Vector3 closestOnSegment(SupportPoint* simplex, int& count, float* lambda);
+    static Vector3 closestOnTriangle(SupportPoint* simplex, int& count, float* lambda);
+    static Vector3 closestOnTetrahedron(SupportPoint* simplex, int& count, float* lambda);
+    //原点を含む単体を四面体まで広げる 広げられなければfalse
+    static bool expandToTetrahedron(const ConvexShape& a, const ConvexShape& b, SupportPoint* simplex, int& count);
+    //EPAの面を追加する
+    static bool addFace(const std::vector<SupportPoint>& vertices, std::vector<Face>& faces, unsigned a, unsigned b, unsigned c);
+
+private:
+    static constexpr int MAX_ITERATION = 64;
+    //原点と重なっているとみなす距離の2乗
+    static constexpr float INTERSECT_EPSILON_SQ = 1e-10f;
+    //GJKの収束判定に使う相対誤差
+    static constexpr float RELATIVE_TOLERANCE = 1e-6f;
+    //EPAの収束判定に使う誤差
+    static constexpr float EPA_TOLERANCE = 1e-4f;
+};
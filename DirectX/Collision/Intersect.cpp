@@ -1,7 +1,7 @@
 ﻿#include "Intersect.h"
-#include "../Transform/Transform3D.h"
-#include <algorithm>
-#include <vector>
+#include "TriangleBVH.h"
+#include "../Math/SIMD.h"
+#include <array>
 
 bool Intersect::intersectCircle(const Circle& a, const Circle& b) {
     Vector2 dist = a.center - b.center;
@@ -30,6 +30,273 @@ bool Intersect::intersectAABB(const AABB& a, const AABB& b) {
     return !no;
 }
 
+bool Intersect::intersectSphereAABB(const Sphere& sphere, const AABB& aabb) {
+    //AABBと球の中心との最短距離が半径以下なら衝突している
+    float distSq = aabb.minDistanceSquare(sphere.center);
+    return distSq <= (sphere.radius * sphere.radius);
+}
+
+bool Intersect::intersectOBB(const OBB& a, const OBB& b) {
+    //bの軸をaの軸の空間で表した回転行列
+    float r[3][3];
+    float absR[3][3];
+    //辺が平行な場合に外積が0になって誤判定しないよう少し大きくしておく
+    constexpr float EPSILON = 1e-6f;
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            r[i][j] = Vector3::dot(a.axes[i], b.axes[j]);
+            absR[i][j] = Math::abs(r[i][j]) + EPSILON;
+        }
+    }
+
+    //中心間のベクトルをaの軸の空間で表す
+    auto d = b.center - a.center;
+    float t[3] = {
+        Vector3::dot(d, a.axes[0]),
+        Vector3::dot(d, a.axes[1]),
+        Vector3::dot(d, a.axes[2])
+    };
+
+    const auto& ea = a.extents;
+    const auto& eb = b.extents;
+    float ra = 0.f;
+    float rb = 0.f;
+
+    //aの3軸
+    for (int i = 0; i < 3; ++i) {
+        ra = ea[i];
+        rb = eb[0] * absR[i][0] + eb[1] * absR[i][1] + eb[2] * absR[i][2];
+        if (Math::abs(t[i]) > ra + rb) {
+            return false;
+        }
+    }
+
+    //bの3軸
+    for (int i = 0; i < 3; ++i) {
+        ra = ea[0] * absR[0][i] + ea[1] * absR[1][i] + ea[2] * absR[2][i];
+        rb = eb[i];
+        if (Math::abs(t[0] * r[0][i] + t[1] * r[1][i] + t[2] * r[2][i]) > ra + rb) {
+            return false;
+        }
+    }
+
+    //aとbの軸同士の外積の9軸
+    for (int i = 0; i < 3; ++i) {
+        auto i1 = (i + 1) % 3;
+        auto i2 = (i + 2) % 3;
+        for (int j = 0; j < 3; ++j) {
+            auto j1 = (j + 1) % 3;
+            auto j2 = (j + 2) % 3;
+            ra = ea[i1] * absR[i2][j] + ea[i2] * absR[i1][j];
+            rb = eb[j1] * absR[i][j2] + eb[j2] * absR[i][j1];
+            if (Math::abs(t[i2] * r[i1][j] - t[i1] * r[i2][j]) > ra + rb) {
+                return false;
+            }
+        }
+    }
+
+    //分離軸が見つからなければ衝突している
+    return true;
+}
+
+bool Intersect::intersectOBBAABB(const OBB& obb, const AABB& aabb) {
+    return intersectOBB(obb, OBB(aabb));
+}
+
+bool Intersect::intersectSphereOBB(const Sphere& sphere, const OBB& obb) {
+    //OBBと球の中心との最短距離が半径以下なら衝突している
+    float distSq = obb.minDistanceSquare(sphere.center);
+    return distSq <= (sphere.radius * sphere.radius);
+}
+
+bool Intersect::intersectFrustumSphere(const Frustum& frustum, const Sphere& sphere) {
+    //どれか1つの平面の完全に外側にあれば見えない
+    for (const auto& p : frustum.planes) {
+        auto dist = Vector3::dot(p.normal(), sphere.center) + p.d;
+        if (dist < -sphere.radius) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Intersect::intersectFrustumAABB(const Frustum& frustum, const AABB& aabb) {
+    auto center = (aabb.min + aabb.max) / 2.f;
+    auto extents = (aabb.max - aabb.min) / 2.f;
+    for (const auto& p : frustum.planes) {
+        //平面の法線方向へのAABBの広がり
+        auto r = Math::abs(p.a) * extents.x + Math::abs(p.b) * extents.y + Math::abs(p.c) * extents.z;
+        auto dist = Vector3::dot(p.normal(), center) + p.d;
+        if (dist < -r) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t Intersect::intersectFrustumSpheres(const Frustum& frustum, const SphereArray& spheres, std::vector<unsigned>& outIndices) {
+    const auto count = spheres.size();
+    const auto& planes = frustum.planes;
+    const auto first = outIndices.size();
+    size_t i = 0;
+
+#ifdef MATH_AVX
+    for (; i + 8 <= count; i += 8) {
+        auto cx = _mm256_loadu_ps(&spheres.centerX[i]);
+        auto cy = _mm256_loadu_ps(&spheres.centerY[i]);
+        auto cz = _mm256_loadu_ps(&spheres.centerZ[i]);
+        auto r = _mm256_loadu_ps(&spheres.radius[i]);
+        auto inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (const auto& p : planes) {
+            auto dist = _mm256_add_ps(
+                _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(p.a), cx), _mm256_mul_ps(_mm256_set1_ps(p.b), cy)),
+                _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(p.c), cz), _mm256_set1_ps(p.d))
+            );
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(dist, r), _mm256_setzero_ps(), _CMP_GE_OQ));
+        }
+        auto mask = _mm256_movemask_ps(inside);
+        for (int j = 0; j < 8; ++j) {
+            if (mask & (1 << j)) {
+                outIndices.emplace_back(static_cast<unsigned>(i + j));
+            }
+        }
+    }
+#endif // MATH_AVX
+
+#ifdef MATH_SSE
+    for (; i + 4 <= count; i += 4) {
+        auto cx = _mm_loadu_ps(&spheres.centerX[i]);
+        auto cy = _mm_loadu_ps(&spheres.centerY[i]);
+        auto cz = _mm_loadu_ps(&spheres.centerZ[i]);
+        auto r = _mm_loadu_ps(&spheres.radius[i]);
+        auto inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (const auto& p : planes) {
+            auto dist = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(_mm_set1_ps(p.a), cx), _mm_mul_ps(_mm_set1_ps(p.b), cy)),
+                _mm_add_ps(_mm_mul_ps(_mm_set1_ps(p.c), cz), _mm_set1_ps(p.d))
+            );
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(dist, r), _mm_setzero_ps()));
+        }
+        auto mask = _mm_movemask_ps(inside);
+        for (int j = 0; j < 4; ++j) {
+            if (mask & (1 << j)) {
+                outIndices.emplace_back(static_cast<unsigned>(i + j));
+            }
+        }
+    }
+#endif // MATH_SSE
+
+    //残りはスカラーで判定する
+    for (; i < count; ++i) {
+        if (intersectFrustumSphere(frustum, spheres.get(i))) {
+            outIndices.emplace_back(static_cast<unsigned>(i));
+        }
+    }
+
+    return outIndices.size() - first;
+}
+
+size_t Intersect::intersectFrustumAABBs(const Frustum& frustum, const AABBArray& aabbs, std::vector<unsigned>& outIndices) {
+    const auto count = aabbs.size();
+    const auto& planes = frustum.planes;
+    const auto first = outIndices.size();
+    size_t i = 0;
+
+#ifdef MATH_AVX
+    {
+        const auto half = _mm256_set1_ps(0.5f);
+        //符号ビットを落として絶対値を取るためのマスク
+        const auto absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+        for (; i + 8 <= count; i += 8) {
+            auto minX = _mm256_loadu_ps(&aabbs.minX[i]);
+            auto minY = _mm256_loadu_ps(&aabbs.minY[i]);
+            auto minZ = _mm256_loadu_ps(&aabbs.minZ[i]);
+            auto maxX = _mm256_loadu_ps(&aabbs.maxX[i]);
+            auto maxY = _mm256_loadu_ps(&aabbs.maxY[i]);
+            auto maxZ = _mm256_loadu_ps(&aabbs.maxZ[i]);
+            auto cx = _mm256_mul_ps(_mm256_add_ps(minX, maxX), half);
+            auto cy = _mm256_mul_ps(_mm256_add_ps(minY, maxY), half);
+            auto cz = _mm256_mul_ps(_mm256_add_ps(minZ, maxZ), half);
+            auto ex = _mm256_mul_ps(_mm256_sub_ps(maxX, minX), half);
+            auto ey = _mm256_mul_ps(_mm256_sub_ps(maxY, minY), half);
+            auto ez = _mm256_mul_ps(_mm256_sub_ps(maxZ, minZ), half);
+            auto inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+            for (const auto& p : planes) {
+                auto a = _mm256_set1_ps(p.a);
+                auto b = _mm256_set1_ps(p.b);
+                auto c = _mm256_set1_ps(p.c);
+                auto dist = _mm256_add_ps(
+                    _mm256_add_ps(_mm256_mul_ps(a, cx), _mm256_mul_ps(b, cy)),
+                    _mm256_add_ps(_mm256_mul_ps(c, cz), _mm256_set1_ps(p.d))
+                );
+                auto r = _mm256_add_ps(
+                    _mm256_add_ps(_mm256_mul_ps(_mm256_and_ps(a, absMask), ex), _mm256_mul_ps(_mm256_and_ps(b, absMask), ey)),
+                    _mm256_mul_ps(_mm256_and_ps(c, absMask), ez)
+                );
+                inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(dist, r), _mm256_setzero_ps(), _CMP_GE_OQ));
+            }
+            auto mask = _mm256_movemask_ps(inside);
+            for (int j = 0; j < 8; ++j) {
+                if (mask & (1 << j)) {
+                    outIndices.emplace_back(static_cast<unsigned>(i + j));
+                }
+            }
+        }
+    }
+#endif // MATH_AVX
+
+#ifdef MATH_SSE
+    {
+        const auto half = _mm_set1_ps(0.5f);
+        const auto absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+        for (; i + 4 <= count; i += 4) {
+            auto minX = _mm_loadu_ps(&aabbs.minX[i]);
+            auto minY = _mm_loadu_ps(&aabbs.minY[i]);
+            auto minZ = _mm_loadu_ps(&aabbs.minZ[i]);
+            auto maxX = _mm_loadu_ps(&aabbs.maxX[i]);
+            auto maxY = _mm_loadu_ps(&aabbs.maxY[i]);
+            auto maxZ = _mm_loadu_ps(&aabbs.maxZ[i]);
+            auto cx = _mm_mul_ps(_mm_add_ps(minX, maxX), half);
+            auto cy = _mm_mul_ps(_mm_add_ps(minY, maxY), half);
+            auto cz = _mm_mul_ps(_mm_add_ps(minZ, maxZ), half);
+            auto ex = _mm_mul_ps(_mm_sub_ps(maxX, minX), half);
+            auto ey = _mm_mul_ps(_mm_sub_ps(maxY, minY), half);
+            auto ez = _mm_mul_ps(_mm_sub_ps(maxZ, minZ), half);
+            auto inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+            for (const auto& p : planes) {
+                auto a = _mm_set1_ps(p.a);
+                auto b = _mm_set1_ps(p.b);
+                auto c = _mm_set1_ps(p.c);
+                auto dist = _mm_add_ps(
+                    _mm_add_ps(_mm_mul_ps(a, cx), _mm_mul_ps(b, cy)),
+                    _mm_add_ps(_mm_mul_ps(c, cz), _mm_set1_ps(p.d))
+                );
+                auto r = _mm_add_ps(
+                    _mm_add_ps(_mm_mul_ps(_mm_and_ps(a, absMask), ex), _mm_mul_ps(_mm_and_ps(b, absMask), ey)),
+                    _mm_mul_ps(_mm_and_ps(c, absMask), ez)
+                );
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(dist, r), _mm_setzero_ps()));
+            }
+            auto mask = _mm_movemask_ps(inside);
+            for (int j = 0; j < 4; ++j) {
+                if (mask & (1 << j)) {
+                    outIndices.emplace_back(static_cast<unsigned>(i + j));
+                }
+            }
+        }
+    }
+#endif // MATH_SSE
+
+    //残りはスカラーで判定する
+    for (; i < count; ++i) {
+        if (intersectFrustumAABB(frustum, aabbs.get(i))) {
+            outIndices.emplace_back(static_cast<unsigned>(i));
+        }
+    }
+
+    return outIndices.size() - first;
+}
+
 bool Intersect::intersectRayPlane(const Ray& ray, const Plane& p, Vector3& intersectPoint) {
     //tの解決策があるかどうかの最初のテスト
     float denom = Vector3::dot(ray.end - ray.start, p.normal());
@@ -128,94 +395,881 @@ bool Intersect::intersectRaySphere(const Ray& ray, const Sphere& sphere, int num
     return false;
 }
 
-bool testSidePlane(float start, float end, float negd, std::vector<float>& out) {
-    float denom = end - start;
-    if (Math::nearZero(denom)) {
+bool Intersect::intersectRayAABB(const Ray& ray, const AABB& aabb) {
+    float t = 0.f;
+    return intersectRayAABB(ray.start, ray.inverseDirection(), aabb, 1.f, t);
+}
+
+bool Intersect::intersectRayAABB(const Ray& ray, const AABB& aabb, Vector3& intersectPoint) {
+    float t = 0.f;
+    if (!intersectRayAABB(ray.start, ray.inverseDirection(), aabb, 1.f, t)) {
         return false;
     }
 
-    float numer = -start + negd;
-    float t = numer / denom;
-    //tが線分の範囲内にあるか
-    if (t >= 0.f && t <= 1.f) {
-        out.emplace_back(t);
-        return true;
+    intersectPoint = ray.pointOnSegment(t);
+    return true;
+}
+
+bool Intersect::intersectRayAABB(const Vector3& start, const Vector3& invDir, const AABB& aabb, float maxT, float& outT) {
+    //スラブ法 各軸の2平面との交差位置から、全軸で重なる区間を求める
+    //線分の範囲[0, maxT]から始めて、軸ごとに区間を狭める
+    auto tNear = 0.f;
+    auto tFar = maxT;
+    auto slab = [&](float min, float max, float s, float inv) {
+        auto t1 = (min - s) * inv;
+        auto t2 = (max - s) * inv;
+        //方向が0の軸で始点がスラブの平面上にあると、0 * 無限大でNaNになる
+        //このとき始点はスラブの内側にあるので、その軸では区間を狭めない
+        if (std::isnan(t1) || std::isnan(t2)) {
+            return;
+        }
+        tNear = Math::Max(tNear, Math::Min(t1, t2));
+        tFar = Math::Min(tFar, Math::Max(t1, t2));
+    };
+    slab(aabb.min.x, aabb.max.x, start.x, invDir.x);
+    slab(aabb.min.y, aabb.max.y, start.y, invDir.y);
+    slab(aabb.min.z, aabb.max.z, start.z, invDir.z);
+
+    outT = tNear;
+    return (tNear <= tFar);
+}
+
+bool Intersect::intersectRayOBB(const Ray& ray, const OBB& obb) {
+    Vector3 intersectPoint;
+    return intersectRayOBB(ray, obb, intersectPoint);
+}
+
+bool Intersect::intersectRayOBB(const Ray& ray, const OBB& obb, Vector3& intersectPoint) {
+    //OBBの中心を原点、軸を座標軸とする空間にレイを移す
+    auto start = ray.start - obb.center;
+    auto dir = ray.end - ray.start;
+    Vector3 localStart;
+    Vector3 invDir;
+    for (int i = 0; i < 3; ++i) {
+        localStart[i] = Vector3::dot(start, obb.axes[i]);
+        invDir[i] = 1.f / Vector3::dot(dir, obb.axes[i]);
     }
 
-    //範囲外
-    return false;
+    float t = 0.f;
+    if (!intersectRayAABB(localStart, invDir, AABB(-1.f * obb.extents, obb.extents), 1.f, t)) {
+        return false;
+    }
+
+    intersectPoint = ray.pointOnSegment(t);
+    return true;
 }
 
-bool Intersect::intersectRayAABB(const Ray& ray, const AABB& aabb) {
-    Vector3 temp;
-    return intersectRayAABB(ray, aabb, temp);
+size_t Intersect::intersectRayAABBs(const Ray& ray, const AABBArray& aabbs, float* outT) {
+    const auto count = aabbs.size();
+    const auto& s = ray.start;
+    const auto invDir = ray.inverseDirection();
+    size_t hitCount = 0;
+    size_t i = 0;
+
+#ifdef MATH_AVX
+    {
+        const auto sx = _mm256_set1_ps(s.x);
+        const auto sy = _mm256_set1_ps(s.y);
+        const auto sz = _mm256_set1_ps(s.z);
+        const auto ix = _mm256_set1_ps(invDir.x);
+        const auto iy = _mm256_set1_ps(invDir.y);
+        const auto iz = _mm256_set1_ps(invDir.z);
+        const auto zero = _mm256_setzero_ps();
+        const auto one = _mm256_set1_ps(1.f);
+        const auto inf = _mm256_set1_ps(Math::infinity);
+        //方向が0の軸で始点がスラブの平面上にあるとNaNになる
+        //その要素は全ビットを立ててNaNにそろえ、第2引数を返すmax/minで捨てて区間を狭めない
+        for (; i + 8 <= count; i += 8) {
+            auto t1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(&aabbs.minX[i]), sx), ix);
+            auto t2 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(&aabbs.maxX[i]), sx), ix);
+            auto unord = _mm256_cmp_ps(t1, t2, _CMP_UNORD_Q);
+            auto tNear = _mm256_max_ps(_mm256_or_ps(_mm256_min_ps(t1, t2), unord), zero);
+            auto tFar = _mm256_min_ps(_mm256_or_ps(_mm256_max_ps(t1, t2), unord), one);
+
+            t1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(&aabbs.minY[i]), sy), iy);
+            t2 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(&aabbs.maxY[i]), sy), iy);
+            unord = _mm256_cmp_ps(t1, t2, _CMP_UNORD_Q);
+            tNear = _mm256_max_ps(_mm256_or_ps(_mm256_min_ps(t1, t2), unord), tNear);
+            tFar = _mm256_min_ps(_mm256_or_ps(_mm256_max_ps(t1, t2), unord), tFar);
+
+            t1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(&aabbs.minZ[i]), sz), iz);
+            t2 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(&aabbs.maxZ[i]), sz), iz);
+            unord = _mm256_cmp_ps(t1, t2, _CMP_UNORD_Q);
+            tNear = _mm256_max_ps(_mm256_or_ps(_mm256_min_ps(t1, t2), unord), tNear);
+            tFar = _mm256_min_ps(_mm256_or_ps(_mm256_max_ps(t1, t2), unord), tFar);
+
+            //衝突していない要素は無限大にする
+            auto hit = _mm256_cmp_ps(tNear, tFar, _CMP_LE_OQ);
+            _mm256_storeu_ps(&outT[i], _mm256_blendv_ps(inf, tNear, hit));
+            for (auto mask = _mm256_movemask_ps(hit); mask; mask &= mask - 1) {
+                ++hitCount;
+            }
+        }
+    }
+#endif // MATH_AVX
+
+#ifdef MATH_SSE
+    {
+        const auto sx = _mm_set1_ps(s.x);
+        const auto sy = _mm_set1_ps(s.y);
+        const auto sz = _mm_set1_ps(s.z);
+        const auto ix = _mm_set1_ps(invDir.x);
+        const auto iy = _mm_set1_ps(invDir.y);
+        const auto iz = _mm_set1_ps(invDir.z);
+        const auto zero = _mm_setzero_ps();
+        const auto one = _mm_set1_ps(1.f);
+        const auto inf = _mm_set1_ps(Math::infinity);
+        for (; i + 4 <= count; i += 4) {
+            auto t1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&aabbs.minX[i]), sx), ix);
+            auto t2 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&aabbs.maxX[i]), sx), ix);
+            auto unord = _mm_cmpunord_ps(t1, t2);
+            auto tNear = _mm_max_ps(_mm_or_ps(_mm_min_ps(t1, t2), unord), zero);
+            auto tFar = _mm_min_ps(_mm_or_ps(_mm_max_ps(t1, t2), unord), one);
+
+            t1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&aabbs.minY[i]), sy), iy);
+            t2 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&aabbs.maxY[i]), sy), iy);
+            unord = _mm_cmpunord_ps(t1, t2);
+            tNear = _mm_max_ps(_mm_or_ps(_mm_min_ps(t1, t2), unord), tNear);
+            tFar = _mm_min_ps(_mm_or_ps(_mm_max_ps(t1, t2), unord), tFar);
+
+            t1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&aabbs.minZ[i]), sz), iz);
+            t2 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&aabbs.maxZ[i]), sz), iz);
+            unord = _mm_cmpunord_ps(t1, t2);
+            tNear = _mm_max_ps(_mm_or_ps(_mm_min_ps(t1, t2), unord), tNear);
+            tFar = _mm_min_ps(_mm_or_ps(_mm_max_ps(t1, t2), unord), tFar);
+
+            //SSE2にはblendがないのでマスクで選ぶ
+            auto hit = _mm_cmple_ps(tNear, tFar);
+            _mm_storeu_ps(&outT[i], _mm_or_ps(_mm_and_ps(hit, tNear), _mm_andnot_ps(hit, inf)));
+            for (auto mask = _mm_movemask_ps(hit); mask; mask &= mask - 1) {
+                ++hitCount;
+            }
+        }
+    }
+#endif // MATH_SSE
+
+    //残りはスカラーで判定する
+    for (; i < count; ++i) {
+        float t = 0.f;
+        if (intersectRayAABB(s, invDir, aabbs.get(i), 1.f, t)) {
+            outT[i] = t;
+            ++hitCount;
+        } else {
+            outT[i] = Math::infinity;
+        }
+    }
+
+    return hitCount;
 }
 
-bool Intersect::intersectRayAABB(const Ray& ray, const AABB& aabb, Vector3& intersectPoint) {
-    //すべてのt値を格納する
-    std::vector<float> tValues;
-    //x平面テスト
-    testSidePlane(ray.start.x, ray.end.x, aabb.min.x, tValues);
-    testSidePlane(ray.start.x, ray.end.x, aabb.max.x, tValues);
-    //y平面テスト
-    testSidePlane(ray.start.y, ray.end.y, aabb.min.y, tValues);
-    testSidePlane(ray.start.y, ray.end.y, aabb.max.y, tValues);
-    //z平面テスト
-    testSidePlane(ray.start.z, ray.end.z, aabb.min.z, tValues);
-    testSidePlane(ray.start.z, ray.end.z, aabb.max.z, tValues);
-
-    //t値を昇順で並べ替える
-    std::sort(tValues.begin(), tValues.end(), [](
-        float a,
-        float b
-        ) {
-            return a < b;
-        });
-
-    //ボックスに交点が含まれているか調べる
-    for (const auto& t : tValues) {
-        auto point = ray.pointOnSegment(t);
-        if (aabb.contains(point)) {
-            intersectPoint = point;
-            return true;
+unsigned Intersect::intersectRayPacketAABB(const RayPacket& packet, const AABB& aabb, float* outT) {
+    float maxT[RayPacket::SIZE];
+    for (auto&& t : maxT) {
+        t = 1.f;
+    }
+    return intersectRayPacketAABB(packet, aabb, maxT, outT);
+}
+
+unsigned Intersect::intersectRayPacketAABB(const RayPacket& packet, const AABB& aabb, const float* maxT, float* outT) {
+    unsigned mask = 0;
+
+#if defined(MATH_AVX)
+    {
+        //始点が共通なら箱との差は全レイで同じ
+        auto sub = [&](float value, const float* start) {
+            return (packet.commonOrigin) ?
+                _mm256_set1_ps(value - start[0]) :
+                _mm256_sub_ps(_mm256_set1_ps(value), _mm256_load_ps(start));
+        };
+
+        //NaNになった軸はintersectRayAABBsと同じく区間を狭めない
+        auto t1 = _mm256_mul_ps(sub(aabb.min.x, packet.startX), _mm256_load_ps(packet.invDirX));
+        auto t2 = _mm256_mul_ps(sub(aabb.max.x, packet.startX), _mm256_load_ps(packet.invDirX));
+        auto unord = _mm256_cmp_ps(t1, t2, _CMP_UNORD_Q);
+        auto tNear = _mm256_max_ps(_mm256_or_ps(_mm256_min_ps(t1, t2), unord), _mm256_setzero_ps());
+        auto tFar = _mm256_min_ps(_mm256_or_ps(_mm256_max_ps(t1, t2), unord), _mm256_loadu_ps(maxT));
+
+        t1 = _mm256_mul_ps(sub(aabb.min.y, packet.startY), _mm256_load_ps(packet.invDirY));
+        t2 = _mm256_mul_ps(sub(aabb.max.y, packet.startY), _mm256_load_ps(packet.invDirY));
+        unord = _mm256_cmp_ps(t1, t2, _CMP_UNORD_Q);
+        tNear = _mm256_max_ps(_mm256_or_ps(_mm256_min_ps(t1, t2), unord), tNear);
+        tFar = _mm256_min_ps(_mm256_or_ps(_mm256_max_ps(t1, t2), unord), tFar);
+
+        t1 = _mm256_mul_ps(sub(aabb.min.z, packet.startZ), _mm256_load_ps(packet.invDirZ));
+        t2 = _mm256_mul_ps(sub(aabb.max.z, packet.startZ), _mm256_load_ps(packet.invDirZ));
+        unord = _mm256_cmp_ps(t1, t2, _CMP_UNORD_Q);
+        tNear = _mm256_max_ps(_mm256_or_ps(_mm256_min_ps(t1, t2), unord), tNear);
+        tFar = _mm256_min_ps(_mm256_or_ps(_mm256_max_ps(t1, t2), unord), tFar);
+
+        auto hit = _mm256_cmp_ps(tNear, tFar, _CMP_LE_OQ);
+        _mm256_storeu_ps(outT, _mm256_blendv_ps(_mm256_set1_ps(Math::infinity), tNear, hit));
+        mask = static_cast<unsigned>(_mm256_movemask_ps(hit));
+    }
+#elif defined(MATH_SSE)
+    for (int i = 0; i < RayPacket::SIZE; i += 4) {
+        auto sub = [&](float value, const float* start) {
+            return (packet.commonOrigin) ?
+                _mm_set1_ps(value - start[0]) :
+                _mm_sub_ps(_mm_set1_ps(value), _mm_load_ps(&start[i]));
+        };
+
+        auto t1 = _mm_mul_ps(sub(aabb.min.x, packet.startX), _mm_load_ps(&packet.invDirX[i]));
+        auto t2 = _mm_mul_ps(sub(aabb.max.x, packet.startX), _mm_load_ps(&packet.invDirX[i]));
+        auto unord = _mm_cmpunord_ps(t1, t2);
+        auto tNear = _mm_max_ps(_mm_or_ps(_mm_min_ps(t1, t2), unord), _mm_setzero_ps());
+        auto tFar = _mm_min_ps(_mm_or_ps(_mm_max_ps(t1, t2), unord), _mm_loadu_ps(&maxT[i]));
+
+        t1 = _mm_mul_ps(sub(aabb.min.y, packet.startY), _mm_load_ps(&packet.invDirY[i]));
+        t2 = _mm_mul_ps(sub(aabb.max.y, packet.startY), _mm_load_ps(&packet.invDirY[i]));
+        unord = _mm_cmpunord_ps(t1, t2);
+        tNear = _mm_max_ps(_mm_or_ps(_mm_min_ps(t1, t2), unord), tNear);
+        tFar = _mm_min_ps(_mm_or_ps(_mm_max_ps(t1, t2), unord), tFar);
+
+        t1 = _mm_mul_ps(sub(aabb.min.z, packet.startZ), _mm_load_ps(&packet.invDirZ[i]));
+        t2 = _mm_mul_ps(sub(aabb.max.z, packet.startZ), _mm_load_ps(&packet.invDirZ[i]));
+        unord = _mm_cmpunord_ps(t1, t2);
+        tNear = _mm_max_ps(_mm_or_ps(_mm_min_ps(t1, t2), unord), tNear);
+        tFar = _mm_min_ps(_mm_or_ps(_mm_max_ps(t1, t2), unord), tFar);
+
+        auto hit = _mm_cmple_ps(tNear, tFar);
+        _mm_storeu_ps(&outT[i], _mm_or_ps(_mm_and_ps(hit, tNear), _mm_andnot_ps(hit, _mm_set1_ps(Math::infinity))));
+        mask |= static_cast<unsigned>(_mm_movemask_ps(hit)) << i;
+    }
+#else
+    for (int i = 0; i < RayPacket::SIZE; ++i) {
+        auto start = Vector3(packet.startX[i], packet.startY[i], packet.startZ[i]);
+        auto invDir = Vector3(packet.invDirX[i], packet.invDirY[i], packet.invDirZ[i]);
+        if (intersectRayAABB(start, invDir, aabb, maxT[i], outT[i])) {
+            mask |= 1u << i;
+        } else {
+            outT[i] = Math::infinity;
         }
     }
+#endif
 
-    //衝突していない
-    return false;
+    //未使用のレイの結果は捨てる
+    for (int i = packet.count; i < RayPacket::SIZE; ++i) {
+        outT[i] = Math::infinity;
+    }
+    return mask & packet.activeMask();
 }
 
-bool Intersect::intersectRayMesh(const Ray& ray, const IMesh& mesh, const Transform3D& transform) {
+unsigned Intersect::intersectRayPacketSphere(const RayPacket& packet, const Sphere& sphere, float* outT) {
+    unsigned mask = 0;
+    auto radiusSq = sphere.radius * sphere.radius;
+
+#if defined(MATH_SSE)
+    //始点が共通ならX, cは全レイで同じ
+    auto commonX = Vector3(packet.startX[0], packet.startY[0], packet.startZ[0]) - sphere.center;
+    auto commonC = Vector3::dot(commonX, commonX) - radiusSq;
+
+    const auto zero = _mm_setzero_ps();
+    const auto one = _mm_set1_ps(1.f);
+    for (int i = 0; i < RayPacket::SIZE; i += 4) {
+        __m128 xx, xy, xz, c;
+        if (packet.commonOrigin) {
+            xx = _mm_set1_ps(commonX.x);
+            xy = _mm_set1_ps(commonX.y);
+            xz = _mm_set1_ps(commonX.z);
+            c = _mm_set1_ps(commonC);
+        } else {
+            xx = _mm_sub_ps(_mm_load_ps(&packet.startX[i]), _mm_set1_ps(sphere.center.x));
+            xy = _mm_sub_ps(_mm_load_ps(&packet.startY[i]), _mm_set1_ps(sphere.center.y));
+            xz = _mm_sub_ps(_mm_load_ps(&packet.startZ[i]), _mm_set1_ps(sphere.center.z));
+            c = _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(xx, xx), _mm_mul_ps(xy, xy)), _mm_mul_ps(xz, xz)), _mm_set1_ps(radiusSq));
+        }
+        auto yx = _mm_load_ps(&packet.dirX[i]);
+        auto yy = _mm_load_ps(&packet.dirY[i]);
+        auto yz = _mm_load_ps(&packet.dirZ[i]);
+
+        auto a = _mm_add_ps(_mm_add_ps(_mm_mul_ps(yx, yx), _mm_mul_ps(yy, yy)), _mm_mul_ps(yz, yz));
+        auto b = _mm_add_ps(_mm_add_ps(_mm_mul_ps(xx, yx), _mm_mul_ps(xy, yy)), _mm_mul_ps(xz, yz));
+        b = _mm_add_ps(b, b);
+
+        //判別式
+        auto disc = _mm_sub_ps(_mm_mul_ps(b, b), _mm_mul_ps(_mm_set1_ps(4.f), _mm_mul_ps(a, c)));
+        auto valid = _mm_cmpge_ps(disc, zero);
+        disc = _mm_sqrt_ps(_mm_max_ps(disc, zero));
+
+        auto inv2a = _mm_div_ps(_mm_set1_ps(0.5f), a);
+        auto negB = _mm_sub_ps(zero, b);
+        auto tMin = _mm_mul_ps(_mm_sub_ps(negB, disc), inv2a);
+        auto tMax = _mm_mul_ps(_mm_add_ps(negB, disc), inv2a);
+
+        //tMinが線分上になければtMaxを使う
+        auto inMin = _mm_and_ps(_mm_cmpge_ps(tMin, zero), _mm_cmple_ps(tMin, one));
+        auto inMax = _mm_and_ps(_mm_cmpge_ps(tMax, zero), _mm_cmple_ps(tMax, one));
+        auto t = _mm_or_ps(_mm_and_ps(inMin, tMin), _mm_andnot_ps(inMin, tMax));
+        auto hit = _mm_and_ps(valid, _mm_or_ps(inMin, inMax));
+
+        _mm_storeu_ps(&outT[i], _mm_or_ps(_mm_and_ps(hit, t), _mm_andnot_ps(hit, _mm_set1_ps(Math::infinity))));
+        mask |= static_cast<unsigned>(_mm_movemask_ps(hit)) << i;
+    }
+#else
+    for (int i = 0; i < packet.count; ++i) {
+        auto ray = packet.get(i);
+        Vector3 point;
+        if (intersectRaySphere(ray, sphere, point)) {
+            auto dir = ray.end - ray.start;
+            outT[i] = Vector3::dot(point - ray.start, dir) / Vector3::dot(dir, dir);
+            mask |= 1u << i;
+        } else {
+            outT[i] = Math::infinity;
+        }
+    }
+#endif
+
+    for (int i = packet.count; i < RayPacket::SIZE; ++i) {
+        outT[i] = Math::infinity;
+    }
+    return mask & packet.activeMask();
+}
+
+unsigned Intersect::intersectRayPacketPolygon(const RayPacket& packet, const Vector3& p1, const Vector3& p2, const Vector3& p3, float* outT, float* outU, float* outV) {
+    float maxT[RayPacket::SIZE];
+    for (auto&& t : maxT) {
+        t = 1.f;
+    }
+    return intersectRayPacketPolygon(packet, p1, p2, p3, maxT, outT, outU, outV);
+}
+
+unsigned Intersect::intersectRayPacketPolygon(const RayPacket& packet, const Vector3& p1, const Vector3& p2, const Vector3& p3, const float* maxT, float* outT, float* outU, float* outV) {
+    unsigned mask = 0;
+    auto e1 = p2 - p1;
+    auto e2 = p3 - p1;
+
+#if defined(MATH_SSE)
+    //始点が共通ならtvec, qvecは全レイで同じ
+    auto commonT = Vector3(packet.startX[0], packet.startY[0], packet.startZ[0]) - p1;
+    auto commonQ = Vector3::cross(commonT, e1);
+
+    const auto zero = _mm_setzero_ps();
+    const auto one = _mm_set1_ps(1.f);
+    const auto e1x = _mm_set1_ps(e1.x), e1y = _mm_set1_ps(e1.y), e1z = _mm_set1_ps(e1.z);
+    const auto e2x = _mm_set1_ps(e2.x), e2y = _mm_set1_ps(e2.y), e2z = _mm_set1_ps(e2.z);
+    for (int i = 0; i < RayPacket::SIZE; i += 4) {
+        auto dx = _mm_load_ps(&packet.dirX[i]);
+        auto dy = _mm_load_ps(&packet.dirY[i]);
+        auto dz = _mm_load_ps(&packet.dirZ[i]);
+
+        //pvec = cross(dir, e2)
+        auto px = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y));
+        auto py = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z));
+        auto pz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+        auto det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)), _mm_mul_ps(e1z, pz));
+        //線分とポリゴンが平行なら衝突しない
+        auto absDet = _mm_andnot_ps(_mm_set1_ps(-0.f), det);
+        auto valid = _mm_cmpgt_ps(absDet, _mm_set1_ps(Math::epsilon));
+        auto invDet = _mm_div_ps(one, det);
+
+        __m128 tx, ty, tz, qx, qy, qz;
+        if (packet.commonOrigin) {
+            tx = _mm_set1_ps(commonT.x);
+            ty = _mm_set1_ps(commonT.y);
+            tz = _mm_set1_ps(commonT.z);
+            qx = _mm_set1_ps(commonQ.x);
+            qy = _mm_set1_ps(commonQ.y);
+            qz = _mm_set1_ps(commonQ.z);
+        } else {
+            tx = _mm_sub_ps(_mm_load_ps(&packet.startX[i]), _mm_set1_ps(p1.x));
+            ty = _mm_sub_ps(_mm_load_ps(&packet.startY[i]), _mm_set1_ps(p1.y));
+            tz = _mm_sub_ps(_mm_load_ps(&packet.startZ[i]), _mm_set1_ps(p1.z));
+            //qvec = cross(tvec, e1)
+            qx = _mm_sub_ps(_mm_mul_ps(ty, e1z), _mm_mul_ps(tz, e1y));
+            qy = _mm_sub_ps(_mm_mul_ps(tz, e1x), _mm_mul_ps(tx, e1z));
+            qz = _mm_sub_ps(_mm_mul_ps(tx, e1y), _mm_mul_ps(ty, e1x));
+        }
+
+        auto u = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(tx, px), _mm_mul_ps(ty, py)), _mm_mul_ps(tz, pz)), invDet);
+        auto v = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, qx), _mm_mul_ps(dy, qy)), _mm_mul_ps(dz, qz)), invDet);
+        auto t = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)), invDet);
+
+        auto hit = _mm_and_ps(valid, _mm_cmpge_ps(u, zero));
+        hit = _mm_and_ps(hit, _mm_cmpge_ps(v, zero));
+        hit = _mm_and_ps(hit, _mm_cmple_ps(_mm_add_ps(u, v), one));
+        hit = _mm_and_ps(hit, _mm_cmpge_ps(t, zero));
+        hit = _mm_and_ps(hit, _mm_cmple_ps(t, _mm_loadu_ps(&maxT[i])));
+
+        _mm_storeu_ps(&outT[i], _mm_or_ps(_mm_and_ps(hit, t), _mm_andnot_ps(hit, _mm_set1_ps(Math::infinity))));
+        _mm_storeu_ps(&outU[i], u);
+        _mm_storeu_ps(&outV[i], v);
+        mask |= static_cast<unsigned>(_mm_movemask_ps(hit)) << i;
+    }
+#else
+    for (int i = 0; i < packet.count; ++i) {
+        outT[i] = Math::infinity;
+
+        auto dir = Vector3(packet.dirX[i], packet.dirY[i], packet.dirZ[i]);
+        auto pvec = Vector3::cross(dir, e2);
+        auto det = Vector3::dot(e1, pvec);
+        if (Math::nearZero(det)) {
+            continue;
+        }
+
+        auto invDet = 1.f / det;
+        auto tvec = Vector3(packet.startX[i], packet.startY[i], packet.startZ[i]) - p1;
+        auto u = Vector3::dot(tvec, pvec) * invDet;
+        auto qvec = Vector3::cross(tvec, e1);
+        auto v = Vector3::dot(dir, qvec) * invDet;
+        auto t = Vector3::dot(e2, qvec) * invDet;
+        if (u < 0.f || v < 0.f || u + v > 1.f || t < 0.f || t > maxT[i]) {
+            continue;
+        }
+
+        outT[i] = t;
+        outU[i] = u;
+        outV[i] = v;
+        mask |= 1u << i;
+    }
+#endif
+
+    for (int i = packet.count; i < RayPacket::SIZE; ++i) {
+        outT[i] = Math::infinity;
+    }
+    return mask & packet.activeMask();
+}
+
+unsigned Intersect::intersectRayPacketMesh(const RayPacket& packet, const IMesh& mesh, const Matrix4& world, RaycastHit* hits) {
+    //レイをまとめてオブジェクト空間に変換する
+    auto invWorld = Matrix4::inverseAffine(world);
+    auto localPacket = RayPacket::transform(packet, invWorld);
+
+    auto mask = mesh.getTriangleBVH().raycast(localPacket, hits);
+
+    const auto& m = invWorld.m;
+    for (int i = 0; i < packet.count; ++i) {
+        if (!(mask & (1u << i))) {
+            continue;
+        }
+
+        auto& hit = hits[i];
+        hit.point = packet.get(i).pointOnSegment(hit.t);
+
+        const auto& n = hit.normal;
+        hit.normal = Vector3::normalize(Vector3(
+            n.x * m[0][0] + n.y * m[0][1] + n.z * m[0][2],
+            n.x * m[1][0] + n.y * m[1][1] + n.z * m[1][2],
+            n.x * m[2][0] + n.y * m[2][1] + n.z * m[2][2]
+        ));
+    }
+
+    return mask;
+}
+
+bool Intersect::intersectRayMesh(const Ray& ray, const IMesh& mesh, const Matrix4& world) {
     Vector3 temp;
-    return intersectRayMesh(ray, mesh, transform, temp);
-}
-
-bool Intersect::intersectRayMesh(const Ray& ray, const IMesh& mesh, const Transform3D& transform, Vector3& intersectPoint) {
-    //ワールド行列を先に取得しておく
-    const auto& world = transform.getWorldTransform();
-
-    //すべてのメッシュとレイによる判定を行う
-    for (size_t i = 0; i < mesh.getMeshCount(); ++i) {
-        const auto& meshVertices = mesh.getMeshVertices(i);
-        const auto polygonCount = meshVertices.size() / 3;
-        for (size_t j = 0; j < polygonCount; ++j) {
-            //それぞれの頂点にワールド行列を掛ける
-            auto p1 = Vector3::transform(meshVertices[j * 3].pos, world);
-            auto p2 = Vector3::transform(meshVertices[j * 3 + 1].pos, world);
-            auto p3 = Vector3::transform(meshVertices[j * 3 + 2].pos, world);
-
-            //同じ頂点が入っていることが有るから強制的に
-            if (p1.equal(p2) || p2.equal(p3) || p3.equal(p1)) {
-                continue;
+    return intersectRayMesh(ray, mesh, world, temp);
+}
+
+bool Intersect::intersectRayMesh(const Ray& ray, const IMesh& mesh, const Matrix4& world, Vector3& intersectPoint) {
+    RaycastHit hit;
+    if (!intersectRayMesh(ray, mesh, world, hit)) {
+        return false;
+    }
+
+    intersectPoint = hit.point;
+    return true;
+}
+
+bool Intersect::intersectRayMesh(const Ray& ray, const IMesh& mesh, const Matrix4& world, RaycastHit& hit) {
+    //逆行列を求める前に、メッシュを囲む球で大まかに判定する
+    auto sphere = mesh.getSphere().transform(world);
+    if (ray.minDistanceSquare(sphere.center) > sphere.radius * sphere.radius) {
+        return false;
+    }
+
+    //頂点にワールド行列を掛ける代わりに、レイをオブジェクト空間に変換する
+    auto invWorld = Matrix4::inverseAffine(world);
+    auto start = Vector3::transform(ray.start, invWorld);
+    auto end = Vector3::transform(ray.end, invWorld);
+
+    if (!mesh.getTriangleBVH().raycast(start, end, hit)) {
+        return false;
+    }
+
+    //アフィン変換なので線分上の位置はワールド空間でも変わらない
+    hit.point = ray.pointOnSegment(hit.t);
+
+    //法線は逆行列の転置で変換する
+    const auto& n = hit.normal;
+    const auto& m = invWorld.m;
+    hit.normal = Vector3::normalize(Vector3(
+        n.x * m[0][0] + n.y * m[0][1] + n.z * m[0][2],
+        n.x * m[1][0] + n.y * m[1][1] + n.z * m[1][2],
+        n.x * m[2][0] + n.y * m[2][1] + n.z * m[2][2]
+    ));
+
+    return true;
+}
+
+bool Intersect::intersectRayCapsule(const Ray& ray, const Vector3& a, const Vector3& b, float radius, float& outT) {
+    auto d = b - a;
+    auto m = ray.start - a;
+    auto n = ray.end - ray.start;
+    auto dd = Vector3::dot(d, d);
+    auto md = Vector3::dot(m, d);
+    auto rr = radius * radius;
+
+    //始点がカプセルの内側
+    auto s = (dd > 0.f) ? Math::clamp<float>(md / dd, 0.f, 1.f) : 0.f;
+    if ((m - d * s).lengthSq() <= rr) {
+        outT = 0.f;
+        return true;
+    }
+
+    auto tMin = Math::infinity;
+
+    //円柱の側面 軸方向の位置が線分の範囲に収まる解だけを使う
+    if (dd > 0.f) {
+        auto nd = Vector3::dot(n, d);
+        auto nn = Vector3::dot(n, n);
+        auto qa = dd * nn - nd * nd;
+        //軸と平行なら側面には当たらない
+        if (qa > 1e-6f * dd * nn) {
+            auto qb = dd * Vector3::dot(m, n) - nd * md;
+            auto qc = dd * (Vector3::dot(m, m) - rr) - md * md;
+            auto disc = qb * qb - qa * qc;
+            if (disc >= 0.f) {
+                auto t = (-qb - Math::sqrt(disc)) / qa;
+                auto axis = md + t * nd;
+                if (t >= 0.f && t <= 1.f && axis >= 0.f && axis <= dd) {
+                    tMin = t;
+                }
+            }
+        }
+    }
+
+    //両端の半球
+    float t = 0.f;
+    if (sweepSphereSphere(Sphere(ray.start, 0.f), n, Sphere(a, radius), t)) {
+        tMin = Math::Min(tMin, t);
+    }
+    if (sweepSphereSphere(Sphere(ray.start, 0.f), n, Sphere(b, radius), t)) {
+        tMin = Math::Min(tMin, t);
+    }
+
+    if (tMin == Math::infinity) {
+        return false;
+    }
+    outT = tMin;
+    return true;
+}
+
+bool Intersect::sweepSphereSphere(const Sphere& sphere, const Vector3& move, const Sphere& target, float& outT) {
+    //半径の和の球と、中心の移動線分の判定に置き換える
+    auto r = sphere.radius + target.radius;
+    auto m = sphere.center - target.center;
+    auto c = Vector3::dot(m, m) - r * r;
+    if (c <= 0.f) {
+        outT = 0.f;
+        return true;
+    }
+
+    //動いていないか、離れていく
+    auto b = Vector3::dot(m, move);
+    if (b >= 0.f) {
+        return false;
+    }
+
+    auto a = Vector3::dot(move, move);
+    auto disc = b * b - a * c;
+    if (disc < 0.f) {
+        return false;
+    }
+
+    auto t = (-b - Math::sqrt(disc)) / a;
+    if (t > 1.f) {
+        return false;
+    }
+    outT = t;
+    return true;
+}
+
+bool Intersect::sweepSphereAABB(const Sphere& sphere, const Vector3& move, const AABB& target, float& outT) {
+    //半径だけ広げたAABBと中心の移動線分で判定する
+    auto expanded = target;
+    expanded.expand(sphere.radius);
+    Ray ray;
+    ray.start = sphere.center;
+    ray.end = sphere.center + move;
+    float t = 0.f;
+    if (!intersectRayAABB(ray.start, ray.inverseDirection(), expanded, 1.f, t)) {
+        return false;
+    }
+
+    //交点が元のAABBのどの領域の外側にあるか 軸ごとに最小側をu、最大側をvのビットで表す
+    auto p = ray.pointOnSegment(t);
+    int u = 0;
+    int v = 0;
+    for (int i = 0; i < 3; ++i) {
+        if (p[i] < target.min[i]) {
+            u |= (1 << i);
+        }
+        if (p[i] > target.max[i]) {
+            v |= (1 << i);
+        }
+    }
+    auto mask = u | v;
+
+    //面の領域なら広げたAABBとの交点がそのまま接触位置
+    if ((mask & (mask - 1)) == 0) {
+        outT = t;
+        return true;
+    }
+
+    //角を丸めた部分は辺ごとのカプセルで判定する
+    auto corner = [&](int bits) {
+        return Vector3(
+            (bits & 1) ? target.max.x : target.min.x,
+            (bits & 2) ? target.max.y : target.min.y,
+            (bits & 4) ? target.max.z : target.min.z
+        );
+    };
+
+    //辺の領域 その辺のカプセルだけを調べる
+    if (mask != 7) {
+        return intersectRayCapsule(ray, corner(u ^ 7), corner(v), sphere.radius, outT);
+    }
+
+    //頂点の領域 頂点で交わる3辺のカプセルのうち最も手前の交点
+    auto tMin = Math::infinity;
+    for (int i = 0; i < 3; ++i) {
+        if (intersectRayCapsule(ray, corner(v), corner(v ^ (1 << i)), sphere.radius, t)) {
+            tMin = Math::Min(tMin, t);
+        }
+    }
+    if (tMin == Math::infinity) {
+        return false;
+    }
+    outT = tMin;
+    return true;
+}
+
+bool Intersect::sweepSphereOBB(const Sphere& sphere, const Vector3& move, const OBB& target, float& outT) {
+    //OBBの中心を原点、軸を座標軸とする空間に移してAABBと判定する
+    auto start = sphere.center - target.center;
+    Vector3 localCenter;
+    Vector3 localMove;
+    for (int i = 0; i < 3; ++i) {
+        localCenter[i] = Vector3::dot(start, target.axes[i]);
+        localMove[i] = Vector3::dot(move, target.axes[i]);
+    }
+    return sweepSphereAABB(Sphere(localCenter, sphere.radius), localMove, AABB(-1.f * target.extents, target.extents), outT);
+}
+
+bool Intersect::sweepSpherePolygon(const Sphere& sphere, const Vector3& move, const Vector3& p1, const Vector3& p2, const Vector3& p3, float& outT) {
+    auto tMin = Math::infinity;
+    auto r = sphere.radius;
+
+    //面の表裏どちらかに半径だけ離れた平面に接する位置を求め、そのときの中心がポリゴンの内側か調べる
+    auto normal = Vector3::cross(p2 - p1, p3 - p1);
+    if (!Math::nearZero(normal.lengthSq())) {
+        normal.normalize();
+        auto dist = Vector3::dot(normal, sphere.center - p1);
+        auto speed = Vector3::dot(normal, move);
+        auto t = -1.f;
+        if (Math::abs(dist) <= r) {
+            t = 0.f;
+        } else if (dist > r && speed < 0.f) {
+            t = (r - dist) / speed;
+        } else if (dist < -r && speed > 0.f) {
+            t = (-r - dist) / speed;
+        }
+
+        if (t >= 0.f && t <= 1.f) {
+            auto c = sphere.center + move * t;
+            auto q = c - normal * Vector3::dot(normal, c - p1);
+            auto inside = (
+                Vector3::dot(Vector3::cross(p2 - p1, q - p1), normal) >= 0.f &&
+                Vector3::dot(Vector3::cross(p3 - p2, q - p2), normal) >= 0.f &&
+                Vector3::dot(Vector3::cross(p1 - p3, q - p3), normal) >= 0.f
+            );
+            if (inside) {
+                tMin = t;
             }
+        }
+    }
+
+    //辺と頂点は辺ごとのカプセルで判定する
+    Ray ray;
+    ray.start = sphere.center;
+    ray.end = sphere.center + move;
+    const Vector3* points[3] = { &p1, &p2, &p3 };
+    float t = 0.f;
+    for (int i = 0; i < 3; ++i) {
+        if (intersectRayCapsule(ray, *points[i], *points[(i + 1) % 3], r, t)) {
+            tMin = Math::Min(tMin, t);
+        }
+    }
+
+    if (tMin == Math::infinity) {
+        return false;
+    }
+    outT = tMin;
+    return true;
+}
+
+bool Intersect::sweepSphereMesh(const Sphere& sphere, const Vector3& move, const IMesh& mesh, const Matrix4& world, float& outT) {
+    //移動範囲を囲むAABBでメッシュ全体を大まかに判定する
+    auto extents = Vector3::one * sphere.radius;
+    AABB swept(sphere.center - extents, sphere.center + extents);
+    swept = AABB::combine(swept, AABB(swept.min + move, swept.max + move));
+    if (!intersectAABB(swept, mesh.getAABB().transform(world))) {
+        return false;
+    }
+
+    //移動範囲をオブジェクト空間に移し、三角形BVHで調べるポリゴンを絞る
+    auto tMin = Math::infinity;
+    mesh.getTriangleBVH().query(swept.transform(Matrix4::inverseAffine(world)), [&](const Vector3& p1, const Vector3& p2, const Vector3& p3) {
+        float t = 0.f;
+        if (sweepSpherePolygon(sphere, move, Vector3::transform(p1, world), Vector3::transform(p2, world), Vector3::transform(p3, world), t)) {
+            tMin = Math::Min(tMin, t);
+        }
+    });
+
+    if (tMin == Math::infinity) {
+        return false;
+    }
+    outT = tMin;
+    return true;
+}
+
+bool Intersect::sweepAABBAABB(const AABB& aabb, const Vector3& move, const AABB& target, float& outT) {
+    //相手を自身の大きさだけ広げ、中心の移動線分で判定する
+    auto center = (aabb.min + aabb.max) * 0.5f;
+    auto extents = (aabb.max - aabb.min) * 0.5f;
+    AABB expanded(target.min - extents, target.max + extents);
+    Ray ray;
+    ray.start = center;
+    ray.end = center + move;
+    return intersectRayAABB(ray.start, ray.inverseDirection(), expanded, 1.f, outT);
+}
+
+bool Intersect::sweepAABBSphere(const AABB& aabb, const Vector3& move, const Sphere& target, float& outT) {
+    //相手から見れば球が逆向きに動くのと同じ
+    return sweepSphereAABB(target, -1.f * move, aabb, outT);
+}
+
+bool Intersect::sweepAABBOBB(const AABB& aabb, const Vector3& move, const OBB& target, float& outT) {
+    std::array<Vector3, 8> points;
+    std::array<Vector3, 8> targetPoints;
+    OBB(aabb).computePoints(points);
+    target.computePoints(targetPoints);
+
+    //各形状の面の法線と、辺同士の外積の15軸
+    std::array<Vector3, 15> axes;
+    size_t axisCount = 0;
+    const Vector3 worldAxes[3] = { Vector3::right, Vector3::up, Vector3::forward };
+    for (int i = 0; i < 3; ++i) {
+        axes[axisCount++] = worldAxes[i];
+        axes[axisCount++] = target.axes[i];
+        for (int j = 0; j < 3; ++j) {
+            axes[axisCount++] = Vector3::cross(worldAxes[i], target.axes[j]);
+        }
+    }
 
-            //ポリゴンとレイの衝突判定
-            if (Intersect::intersectRayPolygon(ray, p1, p2, p3, intersectPoint)) {
-                return true;
+    return sweepConvex(points.data(), points.size(), move, targetPoints.data(), targetPoints.size(), axes.data(), axisCount, outT);
+}
+
+bool Intersect::sweepAABBPolygon(const AABB& aabb, const Vector3& move, const Vector3& p1, const Vector3& p2, const Vector3& p3, float& outT) {
+    std::array<Vector3, 8> points;
+    OBB(aabb).computePoints(points);
+    const Vector3 targetPoints[3] = { p1, p2, p3 };
+
+    //AABBの3軸、ポリゴンの法線、AABBの軸とポリゴンの辺の外積の13軸
+    const Vector3 edges[3] = { p2 - p1, p3 - p2, p1 - p3 };
+    const Vector3 worldAxes[3] = { Vector3::right, Vector3::up, Vector3::forward };
+    std::array<Vector3, 13> axes;
+    size_t axisCount = 0;
+    axes[axisCount++] = Vector3::cross(edges[0], edges[1]);
+    for (int i = 0; i < 3; ++i) {
+        axes[axisCount++] = worldAxes[i];
+        for (int j = 0; j < 3; ++j) {
+            axes[axisCount++] = Vector3::cross(worldAxes[i], edges[j]);
+        }
+    }
+
+    return sweepConvex(points.data(), points.size(), move, targetPoints, 3, axes.data(), axisCount, outT);
+}
+
+bool Intersect::sweepAABBMesh(const AABB& aabb, const Vector3& move, const IMesh& mesh, const Matrix4& world, float& outT) {
+    //移動範囲を囲むAABBでメッシュ全体を大まかに判定する
+    auto swept = AABB::combine(aabb, AABB(aabb.min + move, aabb.max + move));
+    if (!intersectAABB(swept, mesh.getAABB().transform(world))) {
+        return false;
+    }
+
+    //移動範囲をオブジェクト空間に移し、三角形BVHで調べるポリゴンを絞る
+    auto tMin = Math::infinity;
+    mesh.getTriangleBVH().query(swept.transform(Matrix4::inverseAffine(world)), [&](const Vector3& p1, const Vector3& p2, const Vector3& p3) {
+        float t = 0.f;
+        if (sweepAABBPolygon(aabb, move, Vector3::transform(p1, world), Vector3::transform(p2, world), Vector3::transform(p3, world), t)) {
+            tMin = Math::Min(tMin, t);
+        }
+    });
+
+    if (tMin == Math::infinity) {
+        return false;
+    }
+    outT = tMin;
+    return true;
+}
+
+bool Intersect::sweepConvex(const Vector3* points, size_t count, const Vector3& move, const Vector3* targetPoints, size_t targetCount, const Vector3* axes, size_t axisCount, float& outT) {
+    //全軸で投影が重なっている区間の始まりが最初の接触
+    auto tFirst = 0.f;
+    auto tLast = 1.f;
+    for (size_t i = 0; i < axisCount; ++i) {
+        const auto& axis = axes[i];
+        //平行な辺の外積は軸にならない
+        if (Math::nearZero(axis.lengthSq())) {
+            continue;
+        }
+
+        auto min = Math::infinity;
+        auto max = Math::negInfinity;
+        for (size_t j = 0; j < count; ++j) {
+            auto d = Vector3::dot(points[j], axis);
+            min = Math::Min(min, d);
+            max = Math::Max(max, d);
+        }
+        auto targetMin = Math::infinity;
+        auto targetMax = Math::negInfinity;
+        for (size_t j = 0; j < targetCount; ++j) {
+            auto d = Vector3::dot(targetPoints[j], axis);
+            targetMin = Math::Min(targetMin, d);
+            targetMax = Math::Max(targetMax, d);
+        }
+
+        //軸上で重なり始める位置と離れる位置
+        auto speed = Vector3::dot(move, axis);
+        auto enter = 0.f;
+        auto exit = Math::infinity;
+        if (max < targetMin) {
+            if (speed <= 0.f) {
+                return false;
+            }
+            enter = (targetMin - max) / speed;
+            exit = (targetMax - min) / speed;
+        } else if (targetMax < min) {
+            if (speed >= 0.f) {
+                return false;
             }
+            enter = (targetMax - min) / speed;
+            exit = (targetMin - max) / speed;
+        } else if (speed > 0.f) {
+            exit = (targetMax - min) / speed;
+        } else if (speed < 0.f) {
+            exit = (targetMin - max) / speed;
+        }
+
+        tFirst = Math::Max(tFirst, enter);
+        tLast = Math::Min(tLast, exit);
+        if (tFirst > tLast) {
+            return false;
         }
     }
 
-    //衝突していない
-    return false;
+    outT = tFirst;
+    return true;
 }
@@ -1,13 +1,18 @@
 ﻿#pragma once
 
 #include "AABB.h"
+#include "AABBArray.h"
 #include "Circle.h"
+#include "Frustum.h"
+#include "OBB.h"
+#include "RaycastHit.h"
 #include "Ray.h"
+#include "RayPacket.h"
 #include "Sphere.h"
+#include "SphereArray.h"
 #include "../Math/Math.h"
 #include "../Mesh/IMesh.h"
-
-class Transform3D;
+#include <vector>
 
 namespace Intersect {
 //円同士の衝突判定を行う
@@ -19,6 +24,32 @@ bool intersectSphere(const Sphere& a, const Sphere& b);
 //AABB同士の衝突判定を行う
 bool intersectAABB(const AABB& a, const AABB& b);
 
+//球とAABBの衝突判定を行う
+bool intersectSphereAABB(const Sphere& sphere, const AABB& aabb);
+
+//OBB同士の衝突判定を分離軸判定で行う
+bool intersectOBB(const OBB& a, const OBB& b);
+
+//OBBとAABBの衝突判定を行う
+bool intersectOBBAABB(const OBB& obb, const AABB& aabb);
+
+//球とOBBの衝突判定を行う
+bool intersectSphereOBB(const Sphere& sphere, const OBB& obb);
+
+//視錐台と球の判定を行う 一部でも内側にあればtrue
+bool intersectFrustumSphere(const Frustum& frustum, const Sphere& sphere);
+
+//視錐台とAABBの判定を行う 一部でも内側にあればtrue
+bool intersectFrustumAABB(const Frustum& frustum, const AABB& aabb);
+
+//視錐台と複数の球をまとめて判定する
+//視錐台と重なっている球の番号をoutIndicesに追加し、その数を返す
+size_t intersectFrustumSpheres(const Frustum& frustum, const SphereArray& spheres, std::vector<unsigned>& outIndices);
+
+//視錐台と複数のAABBをまとめて判定する
+//視錐台と重なっているAABBの番号をoutIndicesに追加し、その数を返す
+size_t intersectFrustumAABBs(const Frustum& frustum, const AABBArray& aabbs, std::vector<unsigned>& outIndices);
+
 //無限平面とレイの衝突判定を行う
 bool intersectRayPlane(const Ray& ray, const Plane& p, Vector3& intersectPoint);
 
@@ -32,11 +63,62 @@ bool intersectRaySphere(const Ray& ray, const Sphere& sphere, Vector3& intersect
 bool intersectRaySphere(const Ray& ray, const Sphere& sphere, int numDivision);
 
 //AABBとレイの衝突判定を行う
+//始点がAABBの内側にある場合も衝突とみなし、intersectPointには始点を返す
 bool intersectRayAABB(const Ray& ray, const AABB& aabb);
 bool intersectRayAABB(const Ray& ray, const AABB& aabb, Vector3& intersectPoint);
+//方向の逆数を事前に求めたレイとAABBの衝突判定を行う
+//outTには線分上の進入位置 [0, maxT] を返す
+bool intersectRayAABB(const Vector3& start, const Vector3& invDir, const AABB& aabb, float maxT, float& outT);
+//1本のレイと複数のAABBの衝突判定をまとめて行う
+//outTにはAABBごとの進入位置 [0, 1] を、衝突していなければ無限大を書き込む
+//衝突したAABBの数を返す
+size_t intersectRayAABBs(const Ray& ray, const AABBArray& aabbs, float* outT);
+
+//OBBとレイの衝突判定を行う
+//レイをOBBの軸の空間に移してAABBと同じスラブ法で判定する
+bool intersectRayOBB(const Ray& ray, const OBB& obb);
+bool intersectRayOBB(const Ray& ray, const OBB& obb, Vector3& intersectPoint);
+
+//レイパケットとAABBの衝突判定をまとめて行う
+//結果の配列はRayPacket::SIZEの大きさで渡す
+//outTにはレイごとの進入位置 [0, 1] を、衝突していなければ無限大を書き込む
+//衝突したレイをビットで返す
+unsigned intersectRayPacketAABB(const RayPacket& packet, const AABB& aabb, float* outT);
+//maxTでレイごとに判定する線分の範囲 [0, maxT] を指定する
+unsigned intersectRayPacketAABB(const RayPacket& packet, const AABB& aabb, const float* maxT, float* outT);
+//レイパケットと球の衝突判定をまとめて行う
+//outTにはintersectRaySphereと同じ交点のレイ上の位置を書き込む
+unsigned intersectRayPacketSphere(const RayPacket& packet, const Sphere& sphere, float* outT);
+//レイパケットとポリゴンの衝突判定をまとめて行う
+//outU, outVには交点の重心座標を書き込む
+unsigned intersectRayPacketPolygon(const RayPacket& packet, const Vector3& p1, const Vector3& p2, const Vector3& p3, float* outT, float* outU, float* outV);
+unsigned intersectRayPacketPolygon(const RayPacket& packet, const Vector3& p1, const Vector3& p2, const Vector3& p3, const float* maxT, float* outT, float* outU, float* outV);
+//レイパケットとワールド行列で配置したメッシュの衝突判定をまとめて行う
+//hitsにはレイごとの最も近い交点を書き込む
+unsigned intersectRayPacketMesh(const RayPacket& packet, const IMesh& mesh, const Matrix4& world, RaycastHit* hits);
+
+//ワールド行列で配置したメッシュとレイの衝突判定を行う
+//レイをオブジェクト空間に変換し、メッシュの三角形BVHで最も近い交点を求める
+bool intersectRayMesh(const Ray& ray, const IMesh& mesh, const Matrix4& world);
+bool intersectRayMesh(const Ray& ray, const IMesh& mesh, const Matrix4& world, Vector3& intersectPoint);
+bool intersectRayMesh(const Ray& ray, const IMesh& mesh, const Matrix4& world, RaycastHit& hit);
+
+//線分とカプセル(線分abから半径radius以内の領域)の衝突判定を行う
+//outTには線分上の進入位置 [0, 1] を返す 始点が内側にあれば0
+bool intersectRayCapsule(const Ray& ray, const Vector3& a, const Vector3& b, float radius, float& outT);
 
-//メッシュとレイの衝突判定を行う
-//めちゃめちゃ重い
-bool intersectRayMesh(const Ray& ray, const IMesh& mesh, const Transform3D& transform);
-bool intersectRayMesh(const Ray& ray, const IMesh& mesh, const Transform3D& transform, Vector3& intersectPoint);
+//移動する形状の衝突判定(スイープ)
+//moveだけ移動する間に最初に接触する位置 [0, 1] をoutTに返す 最初から重なっていれば0
+bool sweepSphereSphere(const Sphere& sphere, const Vector3& move, const Sphere& target, float& outT);
+bool sweepSphereAABB(const Sphere& sphere, const Vector3& move, const AABB& target, float& outT);
+bool sweepSphereOBB(const Sphere& sphere, const Vector3& move, const OBB& target, float& outT);
+bool sweepSpherePolygon(const Sphere& sphere, const Vector3& move, const Vector3& p1, const Vector3& p2, const Vector3& p3, float& outT);
+bool sweepSphereMesh(const Sphere& sphere, const Vector3& move, const IMesh& mesh, const Matrix4& world, float& outT);
+bool sweepAABBAABB(const AABB& aabb, const Vector3& move, const AABB& target, float& outT);
+bool sweepAABBSphere(const AABB& aabb, const Vector3& move, const Sphere& target, float& outT);
+bool sweepAABBOBB(const AABB& aabb, const Vector3& move, const OBB& target, float& outT);
+bool sweepAABBPolygon(const AABB& aabb, const Vector3& move, const Vector3& p1, const Vector3& p2, const Vector3& p3, float& outT);
+bool sweepAABBMesh(const AABB& aabb, const Vector3& move, const IMesh& mesh, const Matrix4& world, float& outT);
+//頂点で表した凸形状同士を、指定した分離軸ごとに移動区間を求めて判定する
+bool sweepConvex(const Vector3* points, size_t count, const Vector3& move, const Vector3* targetPoints, size_t targetCount, const Vector3* axes, size_t axisCount, float& outT);
 };
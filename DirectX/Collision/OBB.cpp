@@ -0,0 +1,181 @@
+﻿#include "OBB.h"
+
+OBB::OBB() :
+    center(Vector3::zero),
+    axes{ Vector3::right, Vector3::up, Vector3::forward },
+    extents(Vector3::zero) {
+}
+
+OBB::OBB(const Vector3& center, const Vector3& axisX, const Vector3& axisY, const Vector3& axisZ, const Vector3& extents) :
+    center(center),
+    axes{ axisX, axisY, axisZ },
+    extents(extents) {
+}
+
+OBB::OBB(const AABB& aabb) :
+    center((aabb.min + aabb.max) / 2.f),
+    axes{ Vector3::right, Vector3::up, Vector3::forward },
+    extents((aabb.max - aabb.min) / 2.f) {
+}
+
+AABB OBB::getBoundingAABB() const {
+    //各軸の半分の長さをワールドの軸に射影した和が広がりになる
+    Vector3 r;
+    for (int i = 0; i < 3; ++i) {
+        r[i] = Math::abs(axes[0][i]) * extents.x + Math::abs(axes[1][i]) * extents.y + Math::abs(axes[2][i]) * extents.z;
+    }
+    return AABB(center - r, center + r);
+}
+
+void OBB::computePoints(std::array<Vector3, 8>& outPoints) const {
+    auto x = axes[0] * extents.x;
+    auto y = axes[1] * extents.y;
+    auto z = axes[2] * extents.z;
+    outPoints[0] = center - x - y - z;
+    outPoints[1] = center + x - y - z;
+    outPoints[2] = center - x - y + z;
+    outPoints[3] = center + x - y + z;
+    outPoints[4] = center - x + y - z;
+    outPoints[5] = center + x + y - z;
+    outPoints[6] = center - x + y + z;
+    outPoints[7] = center + x + y + z;
+}
+
+bool OBB::contains(const Vector3& point) const {
+    auto d = point - center;
+    for (int i = 0; i < 3; ++i) {
+        if (Math::abs(Vector3::dot(d, axes[i])) > extents[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+Vector3 OBB::closestPoint(const Vector3& point) const {
+    //各軸に射影した距離を半分の長さに収める
+    auto d = point - center;
+    auto result = center;
+    for (int i = 0; i < 3; ++i) {
+        auto dist = Math::clamp<float>(Vector3::dot(d, axes[i]), -extents[i], extents[i]);
+        result += axes[i] * dist;
+    }
+    return result;
+}
+
+float OBB::minDistanceSquare(const Vector3& point) const {
+    return (closestPoint(point) - point).lengthSq();
+}
+
+OBB OBB::createFromPoints(const std::vector<Vector3>& points) {
+    if (points.empty()) {
+        return OBB();
+    }
+
+    //平均
+    auto mean = Vector3::zero;
+    for (const auto& p : points) {
+        mean += p;
+    }
+    mean = mean / static_cast<float>(points.size());
+
+    //共分散行列
+    float cov[3][3] = {};
+    for (const auto& p : points) {
+        auto d = p - mean;
+        for (int i = 0; i < 3; ++i) {
+            for (int j = i; j < 3; ++j) {
+                cov[i][j] += d[i] * d[j];
+            }
+        }
+    }
+    for (int i = 0; i < 3; ++i) {
+        for (int j = i; j < 3; ++j) {
+            cov[i][j] /= static_cast<float>(points.size());
+            cov[j][i] = cov[i][j];
+        }
+    }
+
+    //固有ベクトルが分布の広がる方向になる
+    OBB obb;
+    computeEigenVectors(cov, obb.axes);
+
+    //各軸に射影した範囲から中心と大きさを決める
+    auto minProj = Vector3::infinity;
+    auto maxProj = Vector3::negInfinity;
+    for (const auto& p : points) {
+        for (int i = 0; i < 3; ++i) {
+            auto proj = Vector3::dot(p, obb.axes[i]);
+            minProj[i] = Math::Min(minProj[i], proj);
+            maxProj[i] = Math::Max(maxProj[i], proj);
+        }
+    }
+
+    obb.center = Vector3::zero;
+    for (int i = 0; i < 3; ++i) {
+        obb.center += obb.axes[i] * ((minProj[i] + maxProj[i]) / 2.f);
+        obb.extents[i] = (maxProj[i] - minProj[i]) / 2.f;
+    }
+
+    return obb;
+}
+
+void OBB::computeEigenVectors(float mat[3][3], Vector3 outVectors[3]) {
+    //固有ベクトルを列に持つ行列 単位行列から始める
+    float v[3][3] = {
+        { 1.f, 0.f, 0.f },
+        { 0.f, 1.f, 0.f },
+        { 0.f, 0.f, 1.f }
+    };
+
+    //非対角成分の最大のものを回転で消していく
+    constexpr int MAX_ITERATION = 50;
+    for (int n = 0; n < MAX_ITERATION; ++n) {
+        int p = 0;
+        int q = 1;
+        for (int i = 0; i < 3; ++i) {
+            for (int j = i + 1; j < 3; ++j) {
+                if (Math::abs(mat[i][j]) > Math::abs(mat[p][q])) {
+                    p = i;
+                    q = j;
+                }
+            }
+        }
+        if (Math::abs(mat[p][q]) < 1e-9f) {
+            break;
+        }
+
+        //mat[p][q]を0にする回転角を求める
+        auto theta = (mat[q][q] - mat[p][p]) / (2.f * mat[p][q]);
+        auto t = 1.f / (Math::abs(theta) + Math::sqrt(theta * theta + 1.f));
+        if (theta < 0.f) {
+            t = -t;
+        }
+        auto c = 1.f / Math::sqrt(t * t + 1.f);
+        auto s = t * c;
+
+        for (int k = 0; k < 3; ++k) {
+            auto kp = c * mat[k][p] - s * mat[k][q];
+            auto kq = s * mat[k][p] + c * mat[k][q];
+            mat[k][p] = kp;
+            mat[k][q] = kq;
+        }
+        for (int k = 0; k < 3; ++k) {
+            auto pk = c * mat[p][k] - s * mat[q][k];
+            auto qk = s * mat[p][k] + c * mat[q][k];
+            mat[p][k] = pk;
+            mat[q][k] = qk;
+        }
+        for (int k = 0; k < 3; ++k) {
+            auto kp = c * v[k][p] - s * v[k][q];
+            auto kq = s * v[k][p] + c * v[k][q];
+            v[k][p] = kp;
+            v[k][q] = kq;
+        }
+    }
+
+    for (int i = 0; i < 3; ++i) {
+        outVectors[i] = Vector3::normalize(Vector3(v[0][i], v[1][i], v[2][i]));
+    }
+    //右手系に揃える
+    outVectors[2] = Vector3::cross(outVectors[0], outVectors[1]);
+}
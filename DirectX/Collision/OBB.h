@@ -0,0 +1,35 @@
+﻿#pragma once
+
+#include "AABB.h"
+#include "../Math/Math.h"
+#include <array>
+#include <vector>
+
+//有向境界ボックス
+struct OBB {
+    Vector3 center;
+    //互いに直交する単位ベクトルの軸
+    Vector3 axes[3];
+    //各軸方向の半分の長さ
+    Vector3 extents;
+
+    OBB();
+    OBB(const Vector3& center, const Vector3& axisX, const Vector3& axisY, const Vector3& axisZ, const Vector3& extents);
+    //AABBと同じ範囲のOBBを作る
+    OBB(const AABB& aabb);
+    //OBBを内包するAABBを返す
+    AABB getBoundingAABB() const;
+    //8つの角の点を求める 並びはAABBColliderの点と同じ
+    void computePoints(std::array<Vector3, 8>& outPoints) const;
+    bool contains(const Vector3& point) const;
+    //OBB上で点に最も近い点を返す
+    Vector3 closestPoint(const Vector3& point) const;
+    float minDistanceSquare(const Vector3& point) const;
+
+    //点群の主成分を軸にしたOBBを作る
+    static OBB createFromPoints(const std::vector<Vector3>& points);
+
+private:
+    //3x3の対称行列の固有ベクトルをヤコビ法で求める
+    static void computeEigenVectors(float mat[3][3], Vector3 outVectors[3]);
+};
@@ -14,6 +14,11 @@ Vector3 Ray::pointOnSegment(float t) const {
     return start + (end - start) * t;
 }
 
+Vector3 Ray::inverseDirection() const {
+    auto dir = end - start;
+    return Vector3(1.f / dir.x, 1.f / dir.y, 1.f / dir.z);
+}
+
 float Ray::minDistanceSquare(const Vector3& point) const {
     //ベクトルの準備
     Vector3 ab = end - start;
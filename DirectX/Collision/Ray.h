@@ -10,6 +10,9 @@ struct Ray {
     Ray(const Vector3& origin, const Vector3& direction, float maxDistance = FLT_MAX);
     //線分上の点を返す [0, t, 1]
     Vector3 pointOnSegment(float t) const;
+    //線分の方向の各成分の逆数
+    //同じレイで何度もスラブ判定する場合は事前に求めて使い回す
+    Vector3 inverseDirection() const;
     //最短距離の2乗
     float minDistanceSquare(const Vector3& point) const;
     //2本の線分から最短距離の2乗を取得
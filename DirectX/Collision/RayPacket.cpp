@@ -0,0 +1,71 @@
+﻿#include "RayPacket.h"
+
+RayPacket::RayPacket() {
+    clear();
+}
+
+bool RayPacket::add(const Ray& ray) {
+    if (count >= SIZE) {
+        return false;
+    }
+
+    auto dir = ray.end - ray.start;
+    auto invDir = ray.inverseDirection();
+    startX[count] = ray.start.x;
+    startY[count] = ray.start.y;
+    startZ[count] = ray.start.z;
+    dirX[count] = dir.x;
+    dirY[count] = dir.y;
+    dirZ[count] = dir.z;
+    invDirX[count] = invDir.x;
+    invDirY[count] = invDir.y;
+    invDirZ[count] = invDir.z;
+
+    //始点がひとつでも違えば共通始点の高速化は使えない
+    if (count > 0 && !Vector3::equal(ray.start, Vector3(startX[0], startY[0], startZ[0]))) {
+        commonOrigin = false;
+    }
+
+    ++count;
+
+    return true;
+}
+
+void RayPacket::clear() {
+    //未使用のレイは長さ0にしておき、判定結果はactiveMaskで取り除く
+    for (int i = 0; i < SIZE; ++i) {
+        startX[i] = startY[i] = startZ[i] = 0.f;
+        dirX[i] = dirY[i] = dirZ[i] = 0.f;
+        invDirX[i] = invDirY[i] = invDirZ[i] = Math::infinity;
+    }
+    count = 0;
+    commonOrigin = true;
+}
+
+Ray RayPacket::get(int index) const {
+    Ray ray;
+    ray.start = Vector3(startX[index], startY[index], startZ[index]);
+    ray.end = ray.start + Vector3(dirX[index], dirY[index], dirZ[index]);
+    return ray;
+}
+
+unsigned RayPacket::activeMask() const {
+    return (1u << count) - 1;
+}
+
+RayPacket RayPacket::transform(const RayPacket& packet, const Matrix4& mat) {
+    //始点は点として、方向は平行移動を無視してまとめて変換する
+    RayPacket result;
+    result.count = packet.count;
+    result.commonOrigin = packet.commonOrigin;
+    Vector3::transformArray(packet.startX, packet.startY, packet.startZ, result.startX, result.startY, result.startZ, packet.count, mat);
+    Vector3::transformNormalArray(packet.dirX, packet.dirY, packet.dirZ, result.dirX, result.dirY, result.dirZ, packet.count, mat);
+
+    for (int i = 0; i < result.count; ++i) {
+        result.invDirX[i] = 1.f / result.dirX[i];
+        result.invDirY[i] = 1.f / result.dirY[i];
+        result.invDirZ[i] = 1.f / result.dirZ[i];
+    }
+
+    return result;
+}
@@ -0,0 +1,39 @@
+﻿#pragma once
+
+#include "Ray.h"
+#include "../Math/Math.h"
+
+//複数のレイをまとめて判定するためのSoA配列
+//範囲選択や配置プレビューのように、同じフレームで大量に飛ばすレイをSIMDで一括処理する
+struct RayPacket {
+    //1パケットに詰められるレイの最大数
+    static constexpr int SIZE = 8;
+
+    alignas(32) float startX[SIZE];
+    alignas(32) float startY[SIZE];
+    alignas(32) float startZ[SIZE];
+    //線分の方向 (end - start)
+    alignas(32) float dirX[SIZE];
+    alignas(32) float dirY[SIZE];
+    alignas(32) float dirZ[SIZE];
+    //方向の各成分の逆数
+    alignas(32) float invDirX[SIZE];
+    alignas(32) float invDirY[SIZE];
+    alignas(32) float invDirZ[SIZE];
+    //詰めたレイの数
+    int count;
+    //全レイの始点が同じか カメラからのレイはこれになる
+    bool commonOrigin;
+
+    RayPacket();
+    //レイを追加する 満杯ならfalseを返す
+    bool add(const Ray& ray);
+    //全削除
+    void clear();
+    //指定位置のレイを取得する
+    Ray get(int index) const;
+    //使用中のレイをビットで返す
+    unsigned activeMask() const;
+    //全レイに行列を掛けたパケットを返す
+    static RayPacket transform(const RayPacket& packet, const Matrix4& mat);
+};
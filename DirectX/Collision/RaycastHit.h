@@ -0,0 +1,30 @@
+﻿#pragma once
+
+#include "../Math/Math.h"
+
+//レイとメッシュの衝突結果
+struct RaycastHit {
+    //衝突点
+    Vector3 point;
+    //衝突した面の法線
+    Vector3 normal;
+    //レイ上の位置 [0, t, 1]
+    float t;
+    //サブメッシュ番号
+    unsigned meshIndex;
+    //サブメッシュ内のポリゴン番号
+    unsigned polygonIndex;
+    //重心座標 p1 * (1 - u - v) + p2 * u + p3 * v
+    float u;
+    float v;
+
+    RaycastHit() :
+        point(Vector3::zero),
+        normal(Vector3::zero),
+        t(1.f),
+        meshIndex(0),
+        polygonIndex(0),
+        u(0.f),
+        v(0.f) {
+    }
+};
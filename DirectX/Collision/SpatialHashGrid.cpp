@@ -0,0 +1,238 @@
+﻿#include "SpatialHashGrid.h"
+#include "Intersect.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+SpatialHashGrid::SpatialHashGrid() :
+    mCellSize(1.f),
+    mInvCellSize(1.f) {
+}
+
+SpatialHashGrid::~SpatialHashGrid() = default;
+
+void SpatialHashGrid::setCellSize(float cellSize) {
+    assert(cellSize > 0.f);
+
+    for (int i = 0; i < static_cast<int>(mProxies.size()); ++i) {
+        if (mProxies[i].used) {
+            removeFromCells(i);
+        }
+    }
+
+    mCellSize = cellSize;
+    mInvCellSize = 1.f / cellSize;
+
+    for (int i = 0; i < static_cast<int>(mProxies.size()); ++i) {
+        auto& proxy = mProxies[i];
+        if (proxy.used) {
+            computeCellRange(proxy.aabb, proxy.minCell, proxy.maxCell);
+            insertToCells(i);
+        }
+    }
+}
+
+float SpatialHashGrid::getCellSize() const {
+    return mCellSize;
+}
+
+int SpatialHashGrid::createProxy(const AABB& aabb, unsigned userID) {
+    int proxyID = 0;
+    if (mFreeProxies.empty()) {
+        proxyID = static_cast<int>(mProxies.size());
+        mProxies.emplace_back();
+    } else {
+        proxyID = mFreeProxies.back();
+        mFreeProxies.pop_back();
+    }
+
+    auto& proxy = mProxies[proxyID];
+    proxy.aabb = aabb;
+    proxy.userID = userID;
+    proxy.used = true;
+    computeCellRange(aabb, proxy.minCell, proxy.maxCell);
+    insertToCells(proxyID);
+
+    return proxyID;
+}
+
+void SpatialHashGrid::destroyProxy(int proxyID) {
+    assert(0 <= proxyID && proxyID < static_cast<int>(mProxies.size()));
+    assert(mProxies[proxyID].used);
+
+    removeFromCells(proxyID);
+    mProxies[proxyID].used = false;
+    mFreeProxies.emplace_back(proxyID);
+}
+
+void SpatialHashGrid::moveProxy(int proxyID, const AABB& aabb) {
+    assert(0 <= proxyID && proxyID < static_cast<int>(mProxies.size()));
+    assert(mProxies[proxyID].used);
+
+    auto& proxy = mProxies[proxyID];
+    proxy.aabb = aabb;
+
+    int minCell[3], maxCell[3];
+    computeCellRange(aabb, minCell, maxCell);
+
+    //セルをまたがない移動がほとんどなので、その場合は登録し直さない
+    if (std::equal(minCell, minCell + 3, proxy.minCell) && std::equal(maxCell, maxCell + 3, proxy.maxCell) &&
+        isLarge(aabb, minCell, maxCell) == proxy.large) {
+        return;
+    }
+
+    removeFromCells(proxyID);
+    std::copy(minCell, minCell + 3, proxy.minCell);
+    std::copy(maxCell, maxCell + 3, proxy.maxCell);
+    insertToCells(proxyID);
+}
+
+void SpatialHashGrid::clear() {
+    mProxies.clear();
+    mFreeProxies.clear();
+    mCells.clear();
+    mLargeProxies.clear();
+}
+
+void SpatialHashGrid::computePairs(PairArray& out) const {
+    for (const auto& c : mCells) {
+        const auto& cell = c.second;
+        const auto& proxies = cell.proxies;
+        for (size_t i = 0; i < proxies.size(); ++i) {
+            const auto& a = mProxies[proxies[i]];
+            for (size_t j = i + 1; j < proxies.size(); ++j) {
+                const auto& b = mProxies[proxies[j]];
+
+                //複数のセルを共有するペアは、共有範囲の最小のセルでだけ数える
+                if (Math::Max(a.minCell[0], b.minCell[0]) != cell.x ||
+                    Math::Max(a.minCell[1], b.minCell[1]) != cell.y ||
+                    Math::Max(a.minCell[2], b.minCell[2]) != cell.z) {
+                    continue;
+                }
+
+                if (Intersect::intersectAABB(a.aabb, b.aabb)) {
+                    out.emplace_back(a.userID, b.userID);
+                }
+            }
+        }
+    }
+
+    //大きなプロキシは全プロキシと判定する
+    for (size_t i = 0; i < mLargeProxies.size(); ++i) {
+        const auto& large = mProxies[mLargeProxies[i]];
+        for (int j = 0; j < static_cast<int>(mProxies.size()); ++j) {
+            const auto& other = mProxies[j];
+            if (!other.used || j == mLargeProxies[i]) {
+                continue;
+            }
+            //大きなプロキシ同士は番号の小さい側で1度だけ数える
+            if (other.large && j < mLargeProxies[i]) {
+                continue;
+            }
+
+            if (Intersect::intersectAABB(large.aabb, other.aabb)) {
+                out.emplace_back(large.userID, other.userID);
+            }
+        }
+    }
+}
+
+void SpatialHashGrid::insertToCells(int proxyID) {
+    auto& proxy = mProxies[proxyID];
+
+    proxy.large = isLarge(proxy.aabb, proxy.minCell, proxy.maxCell);
+    if (proxy.large) {
+        mLargeProxies.emplace_back(proxyID);
+        return;
+    }
+
+    for (int x = proxy.minCell[0]; x <= proxy.maxCell[0]; ++x) {
+        for (int y = proxy.minCell[1]; y <= proxy.maxCell[1]; ++y) {
+            for (int z = proxy.minCell[2]; z <= proxy.maxCell[2]; ++z) {
+                auto& cell = mCells[makeCellKey(x, y, z)];
+                if (cell.proxies.empty()) {
+                    cell.x = x;
+                    cell.y = y;
+                    cell.z = z;
+                }
+                cell.proxies.emplace_back(proxyID);
+            }
+        }
+    }
+}
+
+void SpatialHashGrid::removeFromCells(int proxyID) {
+    const auto& proxy = mProxies[proxyID];
+
+    if (proxy.large) {
+        auto itr = std::find(mLargeProxies.begin(), mLargeProxies.end(), proxyID);
+        *itr = mLargeProxies.back();
+        mLargeProxies.pop_back();
+        return;
+    }
+
+    for (int x = proxy.minCell[0]; x <= proxy.maxCell[0]; ++x) {
+        for (int y = proxy.minCell[1]; y <= proxy.maxCell[1]; ++y) {
+            for (int z = proxy.minCell[2]; z <= proxy.maxCell[2]; ++z) {
+                auto cellItr = mCells.find(makeCellKey(x, y, z));
+                assert(cellItr != mCells.end());
+
+                //1セルに入るプロキシは少ないので線形探索で十分
+                auto& proxies = cellItr->second.proxies;
+                auto itr = std::find(proxies.begin(), proxies.end(), proxyID);
+                *itr = proxies.back();
+                proxies.pop_back();
+
+                if (proxies.empty()) {
+                    mCells.erase(cellItr);
+                }
+            }
+        }
+    }
+}
+
+void SpatialHashGrid::computeCellRange(const AABB& aabb, int* outMin, int* outMax) const {
+    for (int i = 0; i < 3; ++i) {
+        outMin[i] = toCell(aabb.min[i] * mInvCellSize);
+        outMax[i] = toCell(aabb.max[i] * mInvCellSize);
+    }
+}
+
+bool SpatialHashGrid::isLarge(const AABB& aabb, const int* minCell, const int* maxCell) {
+    for (int i = 0; i < 3; ++i) {
+        if (!std::isfinite(aabb.min[i]) || !std::isfinite(aabb.max[i])) {
+            return true;
+        }
+    }
+
+    //反転したAABBはどのセルにも掛からない
+    //軸ごとのセル数はキーの範囲に収めてあるので、途中で打ち切れば積はlong longに収まる
+    long long cellCount = 1;
+    for (int i = 0; i < 3; ++i) {
+        cellCount *= Math::Max(maxCell[i] - minCell[i] + 1, 0);
+        if (cellCount > LARGE_CELL_COUNT) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int SpatialHashGrid::toCell(float value) {
+    //範囲外やNaNをintに変換すると未定義なので、変換前に収める
+    auto cell = std::floor(value);
+    if (!(cell >= static_cast<float>(MIN_CELL))) {
+        return MIN_CELL;
+    }
+    if (cell > static_cast<float>(MAX_CELL)) {
+        return MAX_CELL;
+    }
+    return static_cast<int>(cell);
+}
+
+unsigned long long SpatialHashGrid::makeCellKey(int x, int y, int z) {
+    //各軸21ビットずつ詰める
+    constexpr unsigned long long MASK = (1ull << 21) - 1;
+    return ((static_cast<unsigned long long>(x) & MASK) << 42) |
+        ((static_cast<unsigned long long>(y) & MASK) << 21) |
+        (static_cast<unsigned long long>(z) & MASK);
+}
@@ -0,0 +1,87 @@
+﻿#pragma once
+
+#include "AABB.h"
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+//一様グリッドのセルをハッシュで管理するブロードフェーズ
+//大きさの揃ったオブジェクトが大量にある場面向け
+class SpatialHashGrid {
+    using PairArray = std::vector<std::pair<unsigned, unsigned>>;
+
+    //登録されたAABB
+    struct Proxy {
+        AABB aabb;
+        //AABBが掛かるセルの範囲
+        int minCell[3];
+        int maxCell[3];
+        //利用者側の番号
+        unsigned userID;
+        //大きすぎてセルに登録していないか
+        bool large;
+        //使用中か
+        bool used;
+    };
+
+    //セル
+    struct Cell {
+        int x;
+        int y;
+        int z;
+        std::vector<int> proxies;
+    };
+
+public:
+    SpatialHashGrid();
+    ~SpatialHashGrid();
+
+    //セルの大きさを設定する 登録済みのプロキシは登録し直す
+    void setCellSize(float cellSize);
+    float getCellSize() const;
+
+    //プロキシを追加してその番号を返す
+    int createProxy(const AABB& aabb, unsigned userID);
+    //プロキシを削除する
+    void destroyProxy(int proxyID);
+    //プロキシを移動する 掛かるセルが変わったときだけ登録し直す
+    void moveProxy(int proxyID, const AABB& aabb);
+    //全削除
+    void clear();
+
+    //AABBが重なっている利用者番号のペアをすべて取得する
+    void computePairs(PairArray& out) const;
+
+private:
+    SpatialHashGrid(const SpatialHashGrid&) = delete;
+    SpatialHashGrid& operator=(const SpatialHashGrid&) = delete;
+
+    //プロキシを掛かるセルに登録する・セルから取り除く
+    void insertToCells(int proxyID);
+    void removeFromCells(int proxyID);
+    //AABBが掛かるセルの範囲を求める セル座標はキーに詰められる範囲に収める
+    void computeCellRange(const AABB& aabb, int* outMin, int* outMax) const;
+    //セルに登録せず大きなプロキシとして扱うか 無限大やNaNを含むAABBも含める
+    static bool isLarge(const AABB& aabb, const int* minCell, const int* maxCell);
+    //セル単位の座標を整数に直す
+    static int toCell(float value);
+    //セル座標からハッシュのキーを作る
+    static unsigned long long makeCellKey(int x, int y, int z);
+
+private:
+    std::vector<Proxy> mProxies;
+    //空いているプロキシ番号
+    std::vector<int> mFreeProxies;
+    //使用中のセル 空になったセルは取り除く
+    std::unordered_map<unsigned long long, Cell> mCells;
+    //セルに登録せず全プロキシと判定する大きなプロキシ
+    std::vector<int> mLargeProxies;
+    float mCellSize;
+    float mInvCellSize;
+
+    //これより多くのセルに掛かるプロキシは大きなプロキシとして扱う
+    static constexpr int LARGE_CELL_COUNT = 64;
+    //キーに詰める各軸21ビットで表せるセル座標の範囲
+    static constexpr int MIN_CELL = -(1 << 20);
+    static constexpr int MAX_CELL = (1 << 20) - 1;
+};
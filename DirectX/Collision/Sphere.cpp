@@ -15,3 +15,12 @@ bool Sphere::contains(const Vector3& point) const {
     float distSq = (center - point).lengthSq();
     return distSq <= (radius * radius);
 }
+
+Sphere Sphere::transform(const Matrix4& mat) const {
+    const auto& m = mat.m;
+    auto scaleSq = Math::Max(
+        Vector3(m[0][0], m[0][1], m[0][2]).lengthSq(),
+        Math::Max(Vector3(m[1][0], m[1][1], m[1][2]).lengthSq(), Vector3(m[2][0], m[2][1], m[2][2]).lengthSq())
+    );
+    return Sphere(Vector3::transform(center, mat), radius * Math::sqrt(scaleSq));
+}
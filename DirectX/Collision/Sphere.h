@@ -9,4 +9,6 @@ struct Sphere {
     Sphere();
     Sphere(const Vector3& center, float radius);
     bool contains(const Vector3& point) const;
+    //行列で変換した球を返す 拡縮は最も大きい軸に合わせる
+    Sphere transform(const Matrix4& mat) const;
 };
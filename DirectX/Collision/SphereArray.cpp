@@ -0,0 +1,39 @@
+﻿#include "SphereArray.h"
+
+SphereArray::SphereArray() = default;
+
+void SphereArray::add(const Sphere& sphere) {
+    centerX.emplace_back(sphere.center.x);
+    centerY.emplace_back(sphere.center.y);
+    centerZ.emplace_back(sphere.center.z);
+    radius.emplace_back(sphere.radius);
+}
+
+void SphereArray::set(size_t index, const Sphere& sphere) {
+    centerX[index] = sphere.center.x;
+    centerY[index] = sphere.center.y;
+    centerZ[index] = sphere.center.z;
+    radius[index] = sphere.radius;
+}
+
+Sphere SphereArray::get(size_t index) const {
+    return Sphere(Vector3(centerX[index], centerY[index], centerZ[index]), radius[index]);
+}
+
+void SphereArray::resize(size_t size) {
+    centerX.resize(size);
+    centerY.resize(size);
+    centerZ.resize(size);
+    radius.resize(size);
+}
+
+void SphereArray::clear() {
+    centerX.clear();
+    centerY.clear();
+    centerZ.clear();
+    radius.clear();
+}
+
+size_t SphereArray::size() const {
+    return centerX.size();
+}
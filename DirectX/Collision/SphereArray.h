@@ -0,0 +1,26 @@
+﻿#pragma once
+
+#include "Sphere.h"
+#include <vector>
+
+//SIMDでまとめて判定するための球のSoA配列
+struct SphereArray {
+    std::vector<float> centerX;
+    std::vector<float> centerY;
+    std::vector<float> centerZ;
+    std::vector<float> radius;
+
+    SphereArray();
+    //球を末尾に追加する
+    void add(const Sphere& sphere);
+    //指定位置の球を設定する
+    void set(size_t index, const Sphere& sphere);
+    //指定位置の球を取得する
+    Sphere get(size_t index) const;
+    //要素数を変更する
+    void resize(size_t size);
+    //全削除
+    void clear();
+    //要素数
+    size_t size() const;
+};
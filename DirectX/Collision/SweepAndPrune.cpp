@@ -0,0 +1,262 @@
+﻿#include "SweepAndPrune.h"
+#include "Intersect.h"
+#include "../Math/Math.h"
+#include <algorithm>
+#include <cassert>
+
+SweepAndPrune::SweepAndPrune() :
+    mCreatedCount(0),
+    mHasValidityChanged(false) {
+}
+
+SweepAndPrune::~SweepAndPrune() = default;
+
+int SweepAndPrune::createProxy(const AABB& aabb, unsigned userID) {
+    int proxyID = 0;
+    if (mFreeProxies.empty()) {
+        proxyID = static_cast<int>(mProxies.size());
+        mProxies.emplace_back();
+    } else {
+        proxyID = mFreeProxies.back();
+        mFreeProxies.pop_back();
+    }
+
+    auto& proxy = mProxies[proxyID];
+    proxy.aabb = aabb;
+    proxy.userID = userID;
+    proxy.used = true;
+
+    //端点は末尾に追加する
+    //どのプロキシとも重なっていない状態から次のソートで正しい位置に移動する
+    auto id = static_cast<unsigned>(proxyID);
+    for (auto&& endpoints : mEndpoints) {
+        endpoints.emplace_back(Endpoint{ Math::infinity, id << 1 });
+        endpoints.emplace_back(Endpoint{ Math::infinity, (id << 1) | 1 });
+    }
+    ++mCreatedCount;
+
+    return proxyID;
+}
+
+void SweepAndPrune::destroyProxy(int proxyID) {
+    assert(0 <= proxyID && proxyID < static_cast<int>(mProxies.size()));
+    assert(mProxies[proxyID].used);
+
+    //1つ削除するたびに全端点と全ペアをなめないよう、印を付けるだけにしてupdateでまとめて詰める
+    mProxies[proxyID].used = false;
+    mDestroyedProxies.emplace_back(proxyID);
+}
+
+void SweepAndPrune::moveProxy(int proxyID, const AABB& aabb) {
+    assert(0 <= proxyID && proxyID < static_cast<int>(mProxies.size()));
+    auto& proxy = mProxies[proxyID];
+    //反転したAABBの端点は末尾にまとめて寄せるので、そこから出入りする際の追い越しではペアを正しく追えない
+    if (isValid(proxy.aabb) != isValid(aabb)) {
+        mHasValidityChanged = true;
+    }
+    proxy.aabb = aabb;
+}
+
+void SweepAndPrune::clear() {
+    mProxies.clear();
+    mFreeProxies.clear();
+    mDestroyedProxies.clear();
+    for (auto&& endpoints : mEndpoints) {
+        endpoints.clear();
+    }
+    mPairs.clear();
+    mCreatedCount = 0;
+    mHasValidityChanged = false;
+}
+
+void SweepAndPrune::update() {
+    removeDestroyedProxies();
+    updateEndpoints();
+
+    //末尾に追加された端点が多いと挿入ソートは全体の数の2乗に近づくので、まとめて作り直す
+    //反転したAABBとの入れ替わりも、挿入ソートでは追えないので作り直す
+    if (mCreatedCount > REBUILD_CREATED_COUNT || mHasValidityChanged) {
+        rebuild();
+    } else {
+        //前回からの移動はわずかなので、ほぼ整列済みの配列を並べ直すだけで済む
+        for (int axis = 0; axis < AXIS_COUNT; ++axis) {
+            sortAxis(axis);
+        }
+    }
+    mCreatedCount = 0;
+    mHasValidityChanged = false;
+}
+
+void SweepAndPrune::computePairs(PairArray& out) const {
+    for (const auto& key : mPairs) {
+        const auto& a = mProxies[static_cast<unsigned>(key >> 32)];
+        const auto& b = mProxies[static_cast<unsigned>(key & 0xffffffff)];
+        //削除後、まだupdateされていないペアは返さない
+        if (!a.used || !b.used) {
+            continue;
+        }
+        out.emplace_back(a.userID, b.userID);
+    }
+}
+
+size_t SweepAndPrune::getPairCount() const {
+    return mPairs.size();
+}
+
+void SweepAndPrune::removeDestroyedProxies() {
+    if (mDestroyedProxies.empty()) {
+        return;
+    }
+
+    //整列状態を崩さないように端点を取り除く
+    for (auto&& endpoints : mEndpoints) {
+        endpoints.erase(std::remove_if(endpoints.begin(), endpoints.end(), [&](const Endpoint& e) {
+            return !mProxies[getProxyID(e.data)].used;
+        }), endpoints.end());
+    }
+
+    //関係するペアを取り除く
+    for (auto pairItr = mPairs.begin(); pairItr != mPairs.end();) {
+        if (!mProxies[static_cast<unsigned>(*pairItr >> 32)].used || !mProxies[static_cast<unsigned>(*pairItr & 0xffffffff)].used) {
+            pairItr = mPairs.erase(pairItr);
+        } else {
+            ++pairItr;
+        }
+    }
+
+    mFreeProxies.insert(mFreeProxies.end(), mDestroyedProxies.begin(), mDestroyedProxies.end());
+    mDestroyedProxies.clear();
+}
+
+void SweepAndPrune::updateEndpoints() {
+    for (int axis = 0; axis < AXIS_COUNT; ++axis) {
+        for (auto&& e : mEndpoints[axis]) {
+            const auto& aabb = mProxies[getProxyID(e.data)].aabb;
+            //反転したAABBは最小点と最大点の順序が逆になるので、両端点を末尾に寄せてどれとも重ならないようにする
+            if (!isValid(aabb)) {
+                e.value = Math::infinity;
+                continue;
+            }
+            e.value = (isMax(e.data) ? aabb.max : aabb.min)[axis];
+        }
+    }
+}
+
+void SweepAndPrune::sortAxis(int axis) {
+    auto& endpoints = mEndpoints[axis];
+
+    //同じ座標なら最小点を先に並べて、接しているものも重なりとみなす
+    auto less = [](const Endpoint& a, const Endpoint& b) {
+        if (a.value == b.value) {
+            return !isMax(a.data) && isMax(b.data);
+        }
+        return a.value < b.value;
+    };
+
+    for (size_t i = 1; i < endpoints.size(); ++i) {
+        auto key = endpoints[i];
+        auto keyID = getProxyID(key.data);
+        auto j = i;
+        while (j > 0 && less(key, endpoints[j - 1])) {
+            const auto& prev = endpoints[j - 1];
+            auto prevID = getProxyID(prev.data);
+            if (keyID != prevID) {
+                if (!isMax(key.data) && isMax(prev.data)) {
+                    //最小点が相手の最大点を追い越した 重なり始めた可能性がある
+                    //末尾に寄せた反転したAABBとも追い越し合うので、有効なものだけ調べる
+                    const auto& keyAABB = mProxies[keyID].aabb;
+                    const auto& prevAABB = mProxies[prevID].aabb;
+                    if (isValid(keyAABB) && isValid(prevAABB) && Intersect::intersectAABB(keyAABB, prevAABB)) {
+                        addPair(keyID, prevID);
+                    }
+                } else if (isMax(key.data) && !isMax(prev.data)) {
+                    //最大点が相手の最小点を追い越した この軸で離れた
+                    removePair(keyID, prevID);
+                }
+            }
+            endpoints[j] = prev;
+            --j;
+        }
+        endpoints[j] = key;
+    }
+}
+
+void SweepAndPrune::rebuild() {
+    //同じ座標なら最小点を先に並べて、接しているものも重なりとみなす
+    auto less = [](const Endpoint& a, const Endpoint& b) {
+        if (a.value == b.value) {
+            return !isMax(a.data) && isMax(b.data);
+        }
+        return a.value < b.value;
+    };
+    for (auto&& endpoints : mEndpoints) {
+        std::sort(endpoints.begin(), endpoints.end(), less);
+    }
+
+    //x軸上で区間が開いているプロキシとだけ、y, z軸の重なりを調べる
+    //開いているプロキシのAABBは連続した配列に写しておく
+    //区間を閉じるときに探さずに済むよう、プロキシごとに開いている位置を覚えておく
+    mPairs.clear();
+    std::vector<unsigned> openIDs;
+    std::vector<AABB> openAABBs;
+    std::vector<unsigned> openIndices(mProxies.size(), NOT_OPEN);
+    for (const auto& e : mEndpoints[0]) {
+        auto id = getProxyID(e.data);
+        const auto& aabb = mProxies[id].aabb;
+        if (isMax(e.data)) {
+            auto index = openIndices[id];
+            if (index == NOT_OPEN) {
+                continue;
+            }
+            openIndices[openIDs.back()] = index;
+            openIDs[index] = openIDs.back();
+            openIDs.pop_back();
+            openAABBs[index] = openAABBs.back();
+            openAABBs.pop_back();
+            openIndices[id] = NOT_OPEN;
+            continue;
+        }
+        //反転したAABBはどれとも重ならない
+        if (!isValid(aabb)) {
+            continue;
+        }
+
+        for (size_t i = 0; i < openIDs.size(); ++i) {
+            const auto& other = openAABBs[i];
+            if (aabb.min.y <= other.max.y && other.min.y <= aabb.max.y &&
+                aabb.min.z <= other.max.z && other.min.z <= aabb.max.z) {
+                addPair(id, openIDs[i]);
+            }
+        }
+        openIndices[id] = static_cast<unsigned>(openIDs.size());
+        openIDs.emplace_back(id);
+        openAABBs.emplace_back(aabb);
+    }
+}
+
+void SweepAndPrune::addPair(unsigned a, unsigned b) {
+    mPairs.emplace(makePairKey(a, b));
+}
+
+void SweepAndPrune::removePair(unsigned a, unsigned b) {
+    mPairs.erase(makePairKey(a, b));
+}
+
+unsigned SweepAndPrune::getProxyID(unsigned data) {
+    return data >> 1;
+}
+
+bool SweepAndPrune::isMax(unsigned data) {
+    return (data & 1) != 0;
+}
+
+unsigned long long SweepAndPrune::makePairKey(unsigned a, unsigned b) {
+    if (a > b) {
+        std::swap(a, b);
+    }
+    return (static_cast<unsigned long long>(a) << 32) | b;
+}
+
+bool SweepAndPrune::isValid(const AABB& aabb) {
+    return aabb.min.x <= aabb.max.x && aabb.min.y <= aabb.max.y && aabb.min.z <= aabb.max.z;
+}
@@ -0,0 +1,96 @@
+﻿#pragma once
+
+#include "AABB.h"
+#include <array>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+//各軸上にAABBの端点を並べて、全軸で重なっているペアを管理するブロードフェーズ
+//大きさや配置がばらばらな場面向け
+class SweepAndPrune {
+    using PairArray = std::vector<std::pair<unsigned, unsigned>>;
+
+    //登録されたAABB
+    struct Proxy {
+        AABB aabb;
+        //利用者側の番号
+        unsigned userID;
+        //使用中か 削除されたプロキシは次のupdateで端点を詰めるまで番号を再利用しない
+        bool used;
+    };
+
+    //各軸上に並べるAABBの端点
+    struct Endpoint {
+        //軸上の座標
+        float value;
+        //上位ビットがプロキシ番号、最下位ビットが最大点か
+        unsigned data;
+    };
+
+    //x, y, zの3軸
+    static constexpr int AXIS_COUNT = 3;
+    //前回のupdateからこれより多く追加されたら、挿入ソートをやめて作り直す
+    static constexpr size_t REBUILD_CREATED_COUNT = 64;
+    //x軸の走査で区間が開いていないプロキシ
+    static constexpr unsigned NOT_OPEN = ~0u;
+
+public:
+    SweepAndPrune();
+    ~SweepAndPrune();
+
+    //プロキシを追加してその番号を返す
+    int createProxy(const AABB& aabb, unsigned userID);
+    //プロキシを削除する 端点とペアはupdateでまとめて取り除く
+    void destroyProxy(int proxyID);
+    //プロキシを移動する 端点はupdateでまとめて並べ直す
+    void moveProxy(int proxyID, const AABB& aabb);
+    //全削除
+    void clear();
+
+    //端点を移動後の座標に合わせて並べ直し、重なりの変化をペアに反映する
+    void update();
+    //updateの時点で重なっている利用者番号のペアをすべて取得する
+    void computePairs(PairArray& out) const;
+    //重なっているペアの数
+    size_t getPairCount() const;
+
+private:
+    SweepAndPrune(const SweepAndPrune&) = delete;
+    SweepAndPrune& operator=(const SweepAndPrune&) = delete;
+
+    //削除されたプロキシの端点とペアをまとめて取り除き、番号を空ける
+    void removeDestroyedProxies();
+    //端点の座標を各プロキシのAABBに合わせる
+    void updateEndpoints();
+    //ほぼ整列済みの端点配列を挿入ソートで並べ直す
+    void sortAxis(int axis);
+    //全軸の端点配列を整列し直し、x軸を走査してペアを求め直す
+    void rebuild();
+    //ペアの追加・削除
+    void addPair(unsigned a, unsigned b);
+    void removePair(unsigned a, unsigned b);
+    //端点からプロキシ番号を取り出す
+    static unsigned getProxyID(unsigned data);
+    //端点が最大点か
+    static bool isMax(unsigned data);
+    //2つのプロキシ番号から順序によらないキーを作る
+    static unsigned long long makePairKey(unsigned a, unsigned b);
+    //最小点が最大点以下の有効なAABBか 反転したAABBやNaNを含むAABBは偽
+    static bool isValid(const AABB& aabb);
+
+private:
+    std::vector<Proxy> mProxies;
+    //空いているプロキシ番号
+    std::vector<int> mFreeProxies;
+    //削除されて、端点とペアがまだ残っているプロキシ番号
+    std::vector<int> mDestroyedProxies;
+    //軸ごとの端点配列 フレームをまたいで整列状態を保つ
+    std::array<std::vector<Endpoint>, AXIS_COUNT> mEndpoints;
+    //全軸で重なっているプロキシ番号のペア
+    std::unordered_set<unsigned long long> mPairs;
+    //前回のupdateから追加されたプロキシの数
+    size_t mCreatedCount;
+    //反転したAABBと有効なAABBが入れ替わったプロキシがあるか
+    bool mHasValidityChanged;
+};
@@ -0,0 +1,595 @@
+﻿#include "TriangleBVH.h"
+#include "Intersect.h"
+#include "../Math/SIMD.h"
+#include <algorithm>
+#include <utility>
+
+TriangleBVH::TriangleBVH() = default;
+
+TriangleBVH::~TriangleBVH() = default;
+
+void TriangleBVH::build(const std::vector<MeshVertices>& meshesVertices) {
+    mTriangles.clear();
+    mNodes.clear();
+
+    //全サブメッシュのポリゴンを集める
+    for (size_t i = 0; i < meshesVertices.size(); ++i) {
+        const auto& meshVertices = meshesVertices[i];
+        const auto polygonCount = meshVertices.size() / 3;
+        for (size_t j = 0; j < polygonCount; ++j) {
+            Triangle tri;
+            tri.p1 = meshVertices[j * 3].pos;
+            tri.p2 = meshVertices[j * 3 + 1].pos;
+            tri.p3 = meshVertices[j * 3 + 2].pos;
+            tri.meshIndex = static_cast<unsigned>(i);
+            tri.polygonIndex = static_cast<unsigned>(j);
+
+            //同じ頂点が入っていることが有るから強制的に
+            if (tri.p1.equal(tri.p2) || tri.p2.equal(tri.p3) || tri.p3.equal(tri.p1)) {
+                continue;
+            }
+
+            mTriangles.emplace_back(tri);
+        }
+    }
+
+    if (mTriangles.empty()) {
+        return;
+    }
+
+    mCentroids.resize(mTriangles.size());
+    for (size_t i = 0; i < mTriangles.size(); ++i) {
+        const auto& tri = mTriangles[i];
+        mCentroids[i] = (tri.p1 + tri.p2 + tri.p3) / 3.f;
+    }
+
+    //ノード数は最大でポリゴン数 * 2 - 1
+    mNodes.reserve(mTriangles.size() * 2);
+    mNodes.emplace_back();
+    mNodes[0].leftOrFirst = 0;
+    mNodes[0].count = static_cast<unsigned>(mTriangles.size());
+    updateNodeBounds(0);
+    subdivide(0, 0);
+
+    //重心は構築時にしか使わない
+    mCentroids.clear();
+    mCentroids.shrink_to_fit();
+}
+
+bool TriangleBVH::raycast(const Vector3& start, const Vector3& end, RaycastHit& hit) const {
+    if (mNodes.empty()) {
+        return false;
+    }
+
+    auto dir = end - start;
+    auto invDir = Vector3(1.f / dir.x, 1.f / dir.y, 1.f / dir.z);
+
+    //線分の終点より手前の交差だけを探す
+    auto bestT = 1.f;
+    const Triangle* bestTri = nullptr;
+    float bestU = 0.f;
+    float bestV = 0.f;
+
+    float entryT = 0.f;
+    if (!Intersect::intersectRayAABB(start, invDir, mNodes[0].aabb, bestT, entryT)) {
+        return false;
+    }
+
+    //ノードは進入位置と一緒に積み、取り出したときはAABBを判定し直さずに位置だけ比べる
+    StackEntry stack[MAX_DEPTH * 2];
+    int stackCount = 0;
+    stack[stackCount++] = StackEntry{ 0, entryT };
+
+    while (stackCount > 0) {
+        auto entry = stack[--stackCount];
+
+        //積んだ後に近い交点が見つかっていれば調べる必要はない
+        if (entry.entryT > bestT) {
+            continue;
+        }
+
+        const auto& node = mNodes[entry.node];
+        if (node.isLeaf()) {
+            for (unsigned i = node.leftOrFirst; i < node.leftOrFirst + node.count; ++i) {
+                const auto& tri = mTriangles[i];
+                auto e1 = tri.p2 - tri.p1;
+                auto e2 = tri.p3 - tri.p1;
+                auto pvec = Vector3::cross(dir, e2);
+                auto det = Vector3::dot(e1, pvec);
+                //線分とポリゴンが平行
+                if (Math::nearZero(det)) {
+                    continue;
+                }
+
+                auto invDet = 1.f / det;
+                auto tvec = start - tri.p1;
+                auto u = Vector3::dot(tvec, pvec) * invDet;
+                if (u < 0.f || u > 1.f) {
+                    continue;
+                }
+
+                auto qvec = Vector3::cross(tvec, e1);
+                auto v = Vector3::dot(dir, qvec) * invDet;
+                if (v < 0.f || u + v > 1.f) {
+                    continue;
+                }
+
+                auto t = Vector3::dot(e2, qvec) * invDet;
+                if (t < 0.f || t > bestT) {
+                    continue;
+                }
+
+                bestT = t;
+                bestTri = &tri;
+                bestU = u;
+                bestV = v;
+            }
+            continue;
+        }
+
+        //近い子から調べるため遠い子を先に積む
+        auto left = node.leftOrFirst;
+        auto right = left + 1;
+        float leftT = 0.f, rightT = 0.f;
+        auto hitLeft = Intersect::intersectRayAABB(start, invDir, mNodes[left].aabb, bestT, leftT);
+        auto hitRight = Intersect::intersectRayAABB(start, invDir, mNodes[right].aabb, bestT, rightT);
+        if (hitLeft && hitRight) {
+            if (leftT < rightT) {
+                stack[stackCount++] = StackEntry{ right, rightT };
+                stack[stackCount++] = StackEntry{ left, leftT };
+            } else {
+                stack[stackCount++] = StackEntry{ left, leftT };
+                stack[stackCount++] = StackEntry{ right, rightT };
+            }
+        } else if (hitLeft) {
+            stack[stackCount++] = StackEntry{ left, leftT };
+        } else if (hitRight) {
+            stack[stackCount++] = StackEntry{ right, rightT };
+        }
+    }
+
+    if (!bestTri) {
+        return false;
+    }
+
+    hit.point = start + dir * bestT;
+    hit.normal = Vector3::normalize(Vector3::cross(bestTri->p2 - bestTri->p1, bestTri->p3 - bestTri->p1));
+    hit.t = bestT;
+    hit.meshIndex = bestTri->meshIndex;
+    hit.polygonIndex = bestTri->polygonIndex;
+    hit.u = bestU;
+    hit.v = bestV;
+
+    return true;
+}
+
+unsigned TriangleBVH::raycast(const RayPacket& packet, RaycastHit* hits) const {
+    if (mNodes.empty()) {
+        return 0;
+    }
+
+    //向きがばらばらなレイは同じノードを辿らないので、まとめずに1本ずつ調べる
+    if (!isCoherent(packet)) {
+        unsigned hitMask = 0;
+        for (int i = 0; i < packet.count; ++i) {
+            auto ray = packet.get(i);
+            if (raycast(ray.start, ray.end, hits[i])) {
+                hitMask |= 1u << i;
+            }
+        }
+        return hitMask;
+    }
+
+    //レイごとの最も近い交点
+    alignas(32) float bestT[RayPacket::SIZE];
+    const Triangle* bestTri[RayPacket::SIZE] = {};
+    float bestU[RayPacket::SIZE];
+    float bestV[RayPacket::SIZE];
+    for (auto&& t : bestT) {
+        t = 1.f;
+    }
+    const auto activeMask = packet.activeMask();
+
+    //ノードのAABBとパケットを判定し、当たったレイのビットと進入位置を返す
+    //当たらなかったレイの進入位置は無限大にする
+    //始点と方向の逆数、最も近い交点の位置はレジスタに置いたまま使い回す
+#if defined(MATH_AVX)
+    const auto startX = _mm256_load_ps(packet.startX);
+    const auto startY = _mm256_load_ps(packet.startY);
+    const auto startZ = _mm256_load_ps(packet.startZ);
+    const auto invDirX = _mm256_load_ps(packet.invDirX);
+    const auto invDirY = _mm256_load_ps(packet.invDirY);
+    const auto invDirZ = _mm256_load_ps(packet.invDirZ);
+    const auto inf = _mm256_set1_ps(Math::infinity);
+    auto best = _mm256_load_ps(bestT);
+
+    auto intersectNode = [&](const AABB& aabb, float* outEntryT) {
+        //方向が0の軸で始点が平面上にあるとNaNになるので、その軸では区間を狭めない
+        auto t1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(aabb.min.x), startX), invDirX);
+        auto t2 = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(aabb.max.x), startX), invDirX);
+        auto unord = _mm256_cmp_ps(t1, t2, _CMP_UNORD_Q);
+        auto tNear = _mm256_max_ps(_mm256_or_ps(_mm256_min_ps(t1, t2), unord), _mm256_setzero_ps());
+        auto tFar = _mm256_min_ps(_mm256_or_ps(_mm256_max_ps(t1, t2), unord), best);
+
+        t1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(aabb.min.y), startY), invDirY);
+        t2 = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(aabb.max.y), startY), invDirY);
+        unord = _mm256_cmp_ps(t1, t2, _CMP_UNORD_Q);
+        tNear = _mm256_max_ps(_mm256_or_ps(_mm256_min_ps(t1, t2), unord), tNear);
+        tFar = _mm256_min_ps(_mm256_or_ps(_mm256_max_ps(t1, t2), unord), tFar);
+
+        t1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(aabb.min.z), startZ), invDirZ);
+        t2 = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(aabb.max.z), startZ), invDirZ);
+        unord = _mm256_cmp_ps(t1, t2, _CMP_UNORD_Q);
+        tNear = _mm256_max_ps(_mm256_or_ps(_mm256_min_ps(t1, t2), unord), tNear);
+        tFar = _mm256_min_ps(_mm256_or_ps(_mm256_max_ps(t1, t2), unord), tFar);
+
+        auto hit = _mm256_cmp_ps(tNear, tFar, _CMP_LE_OQ);
+        _mm256_storeu_ps(outEntryT, _mm256_blendv_ps(inf, tNear, hit));
+        return static_cast<unsigned>(_mm256_movemask_ps(hit));
+    };
+    //進入位置が最も近い交点より手前のレイのビットを返す
+    auto closerThanBest = [&](const float* entryT) {
+        return static_cast<unsigned>(_mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(entryT), best, _CMP_LE_OQ)));
+    };
+    auto reloadBest = [&]() {
+        best = _mm256_load_ps(bestT);
+    };
+#elif defined(MATH_SSE)
+    //8本を4本ずつ2つに分けて扱う
+    const __m128 startX[2] = { _mm_load_ps(&packet.startX[0]), _mm_load_ps(&packet.startX[4]) };
+    const __m128 startY[2] = { _mm_load_ps(&packet.startY[0]), _mm_load_ps(&packet.startY[4]) };
+    const __m128 startZ[2] = { _mm_load_ps(&packet.startZ[0]), _mm_load_ps(&packet.startZ[4]) };
+    const __m128 invDirX[2] = { _mm_load_ps(&packet.invDirX[0]), _mm_load_ps(&packet.invDirX[4]) };
+    const __m128 invDirY[2] = { _mm_load_ps(&packet.invDirY[0]), _mm_load_ps(&packet.invDirY[4]) };
+    const __m128 invDirZ[2] = { _mm_load_ps(&packet.invDirZ[0]), _mm_load_ps(&packet.invDirZ[4]) };
+    const auto inf = _mm_set1_ps(Math::infinity);
+    __m128 best[2] = { _mm_load_ps(&bestT[0]), _mm_load_ps(&bestT[4]) };
+
+    auto intersectNode = [&](const AABB& aabb, float* outEntryT) {
+        const auto minX = _mm_set1_ps(aabb.min.x), maxX = _mm_set1_ps(aabb.max.x);
+        const auto minY = _mm_set1_ps(aabb.min.y), maxY = _mm_set1_ps(aabb.max.y);
+        const auto minZ = _mm_set1_ps(aabb.min.z), maxZ = _mm_set1_ps(aabb.max.z);
+        unsigned mask = 0;
+        for (int h = 0; h < 2; ++h) {
+            //方向が0の軸で始点が平面上にあるとNaNになるので、その軸では区間を狭めない
+            auto t1 = _mm_mul_ps(_mm_sub_ps(minX, startX[h]), invDirX[h]);
+            auto t2 = _mm_mul_ps(_mm_sub_ps(maxX, startX[h]), invDirX[h]);
+            auto unord = _mm_cmpunord_ps(t1, t2);
+            auto tNear = _mm_max_ps(_mm_or_ps(_mm_min_ps(t1, t2), unord), _mm_setzero_ps());
+            auto tFar = _mm_min_ps(_mm_or_ps(_mm_max_ps(t1, t2), unord), best[h]);
+
+            t1 = _mm_mul_ps(_mm_sub_ps(minY, startY[h]), invDirY[h]);
+            t2 = _mm_mul_ps(_mm_sub_ps(maxY, startY[h]), invDirY[h]);
+            unord = _mm_cmpunord_ps(t1, t2);
+            tNear = _mm_max_ps(_mm_or_ps(_mm_min_ps(t1, t2), unord), tNear);
+            tFar = _mm_min_ps(_mm_or_ps(_mm_max_ps(t1, t2), unord), tFar);
+
+            t1 = _mm_mul_ps(_mm_sub_ps(minZ, startZ[h]), invDirZ[h]);
+            t2 = _mm_mul_ps(_mm_sub_ps(maxZ, startZ[h]), invDirZ[h]);
+            unord = _mm_cmpunord_ps(t1, t2);
+            tNear = _mm_max_ps(_mm_or_ps(_mm_min_ps(t1, t2), unord), tNear);
+            tFar = _mm_min_ps(_mm_or_ps(_mm_max_ps(t1, t2), unord), tFar);
+
+            auto hit = _mm_cmple_ps(tNear, tFar);
+            _mm_storeu_ps(&outEntryT[h * 4], _mm_or_ps(_mm_and_ps(hit, tNear), _mm_andnot_ps(hit, inf)));
+            mask |= static_cast<unsigned>(_mm_movemask_ps(hit)) << (h * 4);
+        }
+        return mask;
+    };
+    auto closerThanBest = [&](const float* entryT) {
+        auto lo = static_cast<unsigned>(_mm_movemask_ps(_mm_cmple_ps(_mm_loadu_ps(&entryT[0]), best[0])));
+        auto hi = static_cast<unsigned>(_mm_movemask_ps(_mm_cmple_ps(_mm_loadu_ps(&entryT[4]), best[1])));
+        return lo | (hi << 4);
+    };
+    auto reloadBest = [&]() {
+        best[0] = _mm_load_ps(&bestT[0]);
+        best[1] = _mm_load_ps(&bestT[4]);
+    };
+#else
+    auto intersectNode = [&](const AABB& aabb, float* outEntryT) {
+        unsigned mask = 0;
+        for (int i = 0; i < RayPacket::SIZE; ++i) {
+            auto start = Vector3(packet.startX[i], packet.startY[i], packet.startZ[i]);
+            auto invDir = Vector3(packet.invDirX[i], packet.invDirY[i], packet.invDirZ[i]);
+            if (Intersect::intersectRayAABB(start, invDir, aabb, bestT[i], outEntryT[i])) {
+                mask |= 1u << i;
+            } else {
+                outEntryT[i] = Math::infinity;
+            }
+        }
+        return mask;
+    };
+    auto closerThanBest = [&](const float* entryT) {
+        unsigned mask = 0;
+        for (int i = 0; i < RayPacket::SIZE; ++i) {
+            if (entryT[i] <= bestT[i]) {
+                mask |= 1u << i;
+            }
+        }
+        return mask;
+    };
+    auto reloadBest = []() {};
+#endif
+
+    //当たったレイの中で最も手前の進入位置
+    auto nearestEntry = [](const float* entryT) {
+        auto t = Math::infinity;
+        for (int i = 0; i < RayPacket::SIZE; ++i) {
+            t = Math::Min(t, entryT[i]);
+        }
+        return t;
+    };
+
+    //ノードには、そのノードに当たっているレイのビットと進入位置を一緒に積む
+    //取り出したときは進入位置と最も近い交点を比べるだけで、AABBを判定し直さない
+    PacketStackEntry stack[MAX_DEPTH * 2];
+    int stackCount = 0;
+
+    float entryT[RayPacket::SIZE];
+    float t[RayPacket::SIZE], u[RayPacket::SIZE], v[RayPacket::SIZE];
+    unsigned nodeIndex = 0;
+    unsigned mask = intersectNode(mNodes[0].aabb, entryT) & activeMask;
+
+    while (mask) {
+        const auto& node = mNodes[nodeIndex];
+
+        if (node.isLeaf()) {
+            for (unsigned i = node.leftOrFirst; i < node.leftOrFirst + node.count; ++i) {
+                const auto& tri = mTriangles[i];
+                auto hitMask = Intersect::intersectRayPacketPolygon(packet, tri.p1, tri.p2, tri.p3, bestT, t, u, v);
+                for (int j = 0; hitMask; ++j, hitMask >>= 1) {
+                    if (hitMask & 1) {
+                        bestT[j] = t[j];
+                        bestTri[j] = &tri;
+                        bestU[j] = u[j];
+                        bestV[j] = v[j];
+                    }
+                }
+            }
+            reloadBest();
+            mask = 0;
+        } else {
+            //このノードに当たっているレイだけで子を判定する
+            auto left = node.leftOrFirst;
+            auto right = left + 1;
+            auto& leftEntry = stack[stackCount];
+            float rightEntryT[RayPacket::SIZE];
+            auto leftMask = intersectNode(mNodes[left].aabb, leftEntry.entryT) & mask;
+            auto rightMask = intersectNode(mNodes[right].aabb, rightEntryT) & mask;
+
+            if (leftMask && rightMask) {
+                //手前の子をそのまま辿り、奥の子を積む
+                if (nearestEntry(leftEntry.entryT) <= nearestEntry(rightEntryT)) {
+                    leftEntry.node = right;
+                    leftEntry.mask = rightMask;
+                    std::copy(rightEntryT, rightEntryT + RayPacket::SIZE, leftEntry.entryT);
+                    nodeIndex = left;
+                    mask = leftMask;
+                } else {
+                    leftEntry.node = left;
+                    leftEntry.mask = leftMask;
+                    nodeIndex = right;
+                    mask = rightMask;
+                }
+                ++stackCount;
+                continue;
+            }
+            if (leftMask) {
+                nodeIndex = left;
+                mask = leftMask;
+                continue;
+            }
+            nodeIndex = right;
+            mask = rightMask;
+        }
+
+        //積んだ後に近い交点が見つかったレイは除く
+        while (!mask && stackCount > 0) {
+            auto entry = stack[--stackCount];
+            nodeIndex = entry.node;
+            mask = entry.mask & closerThanBest(entry.entryT);
+        }
+    }
+
+    unsigned hitMask = 0;
+    for (int i = 0; i < packet.count; ++i) {
+        const auto tri = bestTri[i];
+        if (!tri) {
+            continue;
+        }
+
+        auto& hit = hits[i];
+        hit.point = packet.get(i).pointOnSegment(bestT[i]);
+        hit.normal = Vector3::normalize(Vector3::cross(tri->p2 - tri->p1, tri->p3 - tri->p1));
+        hit.t = bestT[i];
+        hit.meshIndex = tri->meshIndex;
+        hit.polygonIndex = tri->polygonIndex;
+        hit.u = bestU[i];
+        hit.v = bestV[i];
+        hitMask |= 1u << i;
+    }
+
+    return hitMask;
+}
+
+void TriangleBVH::query(const AABB& aabb, const std::function<void(const Vector3&, const Vector3&, const Vector3&)>& callback) const {
+    if (mNodes.empty()) {
+        return;
+    }
+
+    unsigned stack[MAX_DEPTH * 2];
+    int stackCount = 0;
+    stack[stackCount++] = 0;
+
+    while (stackCount > 0) {
+        const auto& node = mNodes[stack[--stackCount]];
+        if (!Intersect::intersectAABB(node.aabb, aabb)) {
+            continue;
+        }
+
+        if (node.isLeaf()) {
+            for (unsigned i = node.leftOrFirst; i < node.leftOrFirst + node.count; ++i) {
+                const auto& tri = mTriangles[i];
+                callback(tri.p1, tri.p2, tri.p3);
+            }
+            continue;
+        }
+
+        stack[stackCount++] = node.leftOrFirst;
+        stack[stackCount++] = node.leftOrFirst + 1;
+    }
+}
+
+const AABB& TriangleBVH::getBounds() const {
+    static const AABB empty;
+    return (mNodes.empty()) ? empty : mNodes[0].aabb;
+}
+
+size_t TriangleBVH::getTriangleCount() const {
+    return mTriangles.size();
+}
+
+void TriangleBVH::updateNodeBounds(unsigned nodeIndex) {
+    auto& node = mNodes[nodeIndex];
+    node.aabb = AABB();
+    for (unsigned i = node.leftOrFirst; i < node.leftOrFirst + node.count; ++i) {
+        const auto& tri = mTriangles[i];
+        node.aabb.updateMinMax(tri.p1);
+        node.aabb.updateMinMax(tri.p2);
+        node.aabb.updateMinMax(tri.p3);
+    }
+}
+
+void TriangleBVH::subdivide(unsigned nodeIndex, int depth) {
+    //ノード追加で配列が伸びても参照が壊れないようにコピーで扱う
+    auto node = mNodes[nodeIndex];
+    if (node.count <= LEAF_TRIANGLE_COUNT || depth >= MAX_DEPTH - 1) {
+        return;
+    }
+
+    int axis = 0;
+    float splitPos = 0.f;
+    auto splitCost = findBestSplit(node, axis, splitPos);
+    //分割しないほうが安いなら葉にする
+    auto leafCost = node.count * node.aabb.surfaceArea();
+    if (splitCost >= leafCost) {
+        return;
+    }
+
+    //重心が分割位置より小さいポリゴンを前に集める
+    auto i = node.leftOrFirst;
+    auto j = i + node.count - 1;
+    while (i <= j) {
+        if (mCentroids[i][axis] < splitPos) {
+            ++i;
+        } else {
+            std::swap(mTriangles[i], mTriangles[j]);
+            std::swap(mCentroids[i], mCentroids[j]);
+            if (j == 0) {
+                break;
+            }
+            --j;
+        }
+    }
+
+    auto leftCount = i - node.leftOrFirst;
+    if (leftCount == 0 || leftCount == node.count) {
+        return;
+    }
+
+    auto left = static_cast<unsigned>(mNodes.size());
+    mNodes.emplace_back();
+    mNodes.emplace_back();
+    mNodes[left].leftOrFirst = node.leftOrFirst;
+    mNodes[left].count = leftCount;
+    mNodes[left + 1].leftOrFirst = i;
+    mNodes[left + 1].count = node.count - leftCount;
+    mNodes[nodeIndex].leftOrFirst = left;
+    mNodes[nodeIndex].count = 0;
+
+    updateNodeBounds(left);
+    updateNodeBounds(left + 1);
+
+    subdivide(left, depth + 1);
+    subdivide(left + 1, depth + 1);
+}
+
+float TriangleBVH::findBestSplit(const Node& node, int& outAxis, float& outPos) const {
+    auto bestCost = Math::infinity;
+
+    for (int axis = 0; axis < 3; ++axis) {
+        //重心の範囲で分割候補を等間隔に並べる
+        auto minC = Math::infinity;
+        auto maxC = Math::negInfinity;
+        for (unsigned i = node.leftOrFirst; i < node.leftOrFirst + node.count; ++i) {
+            minC = Math::Min(minC, mCentroids[i][axis]);
+            maxC = Math::Max(maxC, mCentroids[i][axis]);
+        }
+        if (minC == maxC) {
+            continue;
+        }
+
+        AABB binBounds[BIN_COUNT];
+        unsigned binCounts[BIN_COUNT] = {};
+        auto scale = BIN_COUNT / (maxC - minC);
+        for (unsigned i = node.leftOrFirst; i < node.leftOrFirst + node.count; ++i) {
+            auto bin = Math::Min(BIN_COUNT - 1, static_cast<int>((mCentroids[i][axis] - minC) * scale));
+            const auto& tri = mTriangles[i];
+            binBounds[bin].updateMinMax(tri.p1);
+            binBounds[bin].updateMinMax(tri.p2);
+            binBounds[bin].updateMinMax(tri.p3);
+            ++binCounts[bin];
+        }
+
+        //各分割位置の左右の表面積とポリゴン数を求める
+        float leftArea[BIN_COUNT - 1];
+        float rightArea[BIN_COUNT - 1];
+        unsigned leftCount[BIN_COUNT - 1];
+        unsigned rightCount[BIN_COUNT - 1];
+        AABB leftBox, rightBox;
+        unsigned leftSum = 0, rightSum = 0;
+        for (int i = 0; i < BIN_COUNT - 1; ++i) {
+            if (binCounts[i] > 0) {
+                leftBox = (leftSum > 0) ? AABB::combine(leftBox, binBounds[i]) : binBounds[i];
+                leftSum += binCounts[i];
+            }
+            leftCount[i] = leftSum;
+            leftArea[i] = (leftSum > 0) ? leftBox.surfaceArea() : 0.f;
+
+            auto r = BIN_COUNT - 1 - i;
+            if (binCounts[r] > 0) {
+                rightBox = (rightSum > 0) ? AABB::combine(rightBox, binBounds[r]) : binBounds[r];
+                rightSum += binCounts[r];
+            }
+            rightCount[r - 1] = rightSum;
+            rightArea[r - 1] = (rightSum > 0) ? rightBox.surfaceArea() : 0.f;
+        }
+
+        auto binWidth = (maxC - minC) / BIN_COUNT;
+        for (int i = 0; i < BIN_COUNT - 1; ++i) {
+            auto cost = leftCount[i] * leftArea[i] + rightCount[i] * rightArea[i];
+            if (cost < bestCost) {
+                bestCost = cost;
+                outAxis = axis;
+                outPos = minC + binWidth * (i + 1);
+            }
+        }
+    }
+
+    return bestCost;
+}
+
+bool TriangleBVH::isCoherent(const RayPacket& packet) {
+    if (packet.count <= 1) {
+        return true;
+    }
+
+    auto first = Vector3::normalize(Vector3(packet.dirX[0], packet.dirY[0], packet.dirZ[0]));
+    for (int i = 1; i < packet.count; ++i) {
+        auto dir = Vector3::normalize(Vector3(packet.dirX[i], packet.dirY[i], packet.dirZ[i]));
+        if (Vector3::dot(first, dir) < COHERENT_COS) {
+            return false;
+        }
+    }
+    return true;
+}
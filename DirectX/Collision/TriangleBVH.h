@@ -0,0 +1,99 @@
+﻿#pragma once
+
+#include "AABB.h"
+#include "RaycastHit.h"
+#include "RayPacket.h"
+#include "../Math/Math.h"
+#include "../Mesh/IMeshLoader.h"
+#include <functional>
+#include <vector>
+
+//メッシュのオブジェクト空間で構築する静的な三角形BVH
+//メッシュ読み込み時に1度だけ構築し、レイ判定で全ポリゴンを調べずに済むようにする
+class TriangleBVH {
+    //ポリゴン
+    struct Triangle {
+        Vector3 p1;
+        Vector3 p2;
+        Vector3 p3;
+        unsigned meshIndex;
+        unsigned polygonIndex;
+    };
+
+    //ノード
+    struct Node {
+        AABB aabb;
+        //葉なら最初のポリゴン番号、枝なら左の子の番号(右の子はその次)
+        unsigned leftOrFirst;
+        //葉のポリゴン数 枝なら0
+        unsigned count;
+
+        bool isLeaf() const {
+            return count > 0;
+        }
+    };
+
+    //レイの探索スタックに積むノード
+    struct StackEntry {
+        unsigned node;
+        //ノードへの進入位置
+        float entryT;
+    };
+
+    //レイパケットの探索スタックに積むノード
+    struct PacketStackEntry {
+        unsigned node;
+        //ノードに当たっているレイのビット
+        unsigned mask;
+        //レイごとのノードへの進入位置 当たっていないレイは無限大
+        float entryT[RayPacket::SIZE];
+    };
+
+public:
+    TriangleBVH();
+    ~TriangleBVH();
+
+    //全サブメッシュの頂点からBVHを構築する
+    void build(const std::vector<MeshVertices>& meshesVertices);
+    //オブジェクト空間の線分と最も近いポリゴンの交差を求める
+    //hitのpointとnormalもオブジェクト空間で返す
+    bool raycast(const Vector3& start, const Vector3& end, RaycastHit& hit) const;
+    //オブジェクト空間のレイパケットをまとめて判定する
+    //hitsにはレイごとの最も近い交点を書き込み、衝突したレイをビットで返す
+    //向きのそろっていないパケットは1本ずつ判定する
+    unsigned raycast(const RayPacket& packet, RaycastHit* hits) const;
+    //オブジェクト空間のAABBと重なる葉のポリゴンをすべてcallbackに渡す
+    void query(const AABB& aabb, const std::function<void(const Vector3&, const Vector3&, const Vector3&)>& callback) const;
+    //全体を囲むAABB
+    const AABB& getBounds() const;
+    //ポリゴン数
+    size_t getTriangleCount() const;
+
+private:
+    TriangleBVH(const TriangleBVH&) = delete;
+    TriangleBVH& operator=(const TriangleBVH&) = delete;
+
+    //ノードのAABBを含まれるポリゴンから求める
+    void updateNodeBounds(unsigned nodeIndex);
+    //ノードを分割する
+    void subdivide(unsigned nodeIndex, int depth);
+    //SAHが最小となる分割軸と位置を探す
+    float findBestSplit(const Node& node, int& outAxis, float& outPos) const;
+    //パケット内の全レイの向きが先頭のレイに近いか
+    static bool isCoherent(const RayPacket& packet);
+
+private:
+    std::vector<Triangle> mTriangles;
+    //分割用の各ポリゴンの重心
+    std::vector<Vector3> mCentroids;
+    std::vector<Node> mNodes;
+
+    //葉に入れるポリゴンの最大数の目安
+    static constexpr unsigned LEAF_TRIANGLE_COUNT = 4;
+    //SAHの分割候補数
+    static constexpr int BIN_COUNT = 12;
+    //木の深さの上限 探索用スタックの大きさも兼ねる
+    static constexpr int MAX_DEPTH = 64;
+    //先頭のレイとの向きの差がこの角度のcos以上ならパケットでまとめて辿る
+    static constexpr float COHERENT_COS = 0.9f;
+};
@@ -11,7 +11,8 @@ Camera::Camera(GameObject& gameObject) :
     mNearClip(0.1f),
     mFarClip(100.f),
     mView(Matrix4::identity),
-    mProjection(Matrix4::identity) {
+    mProjection(Matrix4::identity),
+    mFrustum() {
 }
 
 Camera::~Camera() = default;
@@ -19,10 +20,13 @@ Camera::~Camera() = default;
 void Camera::awake() {
     calcLookAt();
     calcPerspectiveFOV(Window::width(), Window::height());
+    mFrustum.extract(getViewProjection());
 }
 
 void Camera::lateUpdate() {
     calcLookAt();
+    //カリングで何度も使うので平面はフレームに1度だけ求める
+    mFrustum.extract(getViewProjection());
 }
 
 void Camera::loadProperties(const rapidjson::Value & inObj) {
@@ -68,22 +72,8 @@ void Camera::lookAt(const Vector3 & position) {
 }
 
 Vector3 Camera::screenToWorldPoint(const Vector2 & position, float z) {
-    //ビューポート、射影、ビュー、それぞれの逆行列を求める
-    auto invView = Matrix4::inverse(mView);
-    auto invProj = Matrix4::inverse(mProjection);
-
-    auto invViewport = Matrix4::identity;
-    invViewport.m[0][0] = Window::width() / 2.f;
-    invViewport.m[1][1] = -Window::height() / 2.f;
-    invViewport.m[3][0] = Window::width() / 2.f;
-    invViewport.m[3][1] = Window::height() / 2.f;
-    invViewport.inverse();
-
-    //ビューポート、射影、ビュー、それぞれの逆行列を掛ける
-    auto m = invViewport * invProj * invView;
-
     //スクリーン座標をワールド座標に変換
-    return Vector3::transformWithPerspDiv(Vector3(position, z), m);
+    return Vector3::transformWithPerspDiv(Vector3(position, z), calcScreenToWorld());
 }
 
 Ray Camera::screenToRay(const Vector2& position, float z) {
@@ -94,79 +84,30 @@ Ray Camera::screenToRay(const Vector2& position, float z) {
     return ray;
 }
 
-bool Camera::viewFrustumCulling(const Vector3& pos, float radius) const {
-    //ワールド空間からビュー空間に変換
-    auto viewPos = Vector3::transform(pos, mView);
-    //事前計算
-    auto aspect = static_cast<float>(Window::width()) / static_cast<float>(Window::height());
-    auto calcX = mFarClip * Math::tan(mFOV / 2.f) * aspect;
-    auto calcY = mFarClip * Math::tan(mFOV / 2.f);
-
-    Vector3 p1, p2, p3;
-    //左
-    p1 = Vector3::zero;
-    p2.x = -calcX;
-    p2.y = -calcY;
-    p2.z = mFarClip;
-    p3 = p2;
-    p3.y = -p2.y;
-    auto left = Plane(p1, p2, p3);
-    //右
-    p1 = Vector3::zero;
-    p2.x = calcX;
-    p2.y = calcY;
-    p2.z = mFarClip;
-    p3 = p2;
-    p3.y = -p2.y;
-    auto right = Plane(p1, p2, p3);
-    //上
-    p1 = Vector3::zero;
-    p2.x = -calcX;
-    p2.y = calcY;
-    p2.z = mFarClip;
-    p3 = p2;
-    p3.x = -p2.x;
-    auto top = Plane(p1, p2, p3);
-    //下
-    p1 = Vector3::zero;
-    p2.x = calcX;
-    p2.y = -calcY;
-    p2.z = mFarClip;
-    p3 = p2;
-    p3.x = -p2.x;
-    auto bottom = Plane(p1, p2, p3);
-
-    //6面と境界球判定
-    //手前
-    if (viewPos.z + radius < mNearClip) {
-        return false;
-    }
-    //奥
-    if (viewPos.z - radius > mFarClip) {
-        return false;
-    }
-    //左
-    auto dis = (viewPos.x * left.a) + (viewPos.z * left.c);
-    if (dis > radius) {
-        return false;
-    }
-    //右
-    dis = (viewPos.x * right.a) + (viewPos.z * right.c);
-    if (dis > radius) {
-        return false;
-    }
-    //上
-    dis = (viewPos.y * top.b) + (viewPos.z * top.c);
-    if (dis > radius) {
-        return false;
-    }
-    //下
-    dis = (viewPos.y * bottom.b) + (viewPos.z * bottom.c);
-    if (dis > radius) {
-        return false;
+RayPacket Camera::screenToRayPacket(const Vector2* positions, int count, float z) {
+    //変換行列は全レイで共通なので1度だけ求める
+    auto m = calcScreenToWorld();
+    auto start = getPosition();
+
+    RayPacket packet;
+    for (int i = 0; i < count; ++i) {
+        Ray ray;
+        ray.start = start;
+        ray.end = Vector3::transformWithPerspDiv(Vector3(positions[i], z), m);
+        if (!packet.add(ray)) {
+            break;
+        }
     }
 
-    return true;
+    return packet;
+}
+
+bool Camera::viewFrustumCulling(const Vector3& pos, float radius) const {
+    return Intersect::intersectFrustumSphere(mFrustum, Sphere(pos, radius));
+}
+
+const Frustum& Camera::getFrustum() const {
+    return mFrustum;
 }
 
 void Camera::calcLookAt() {
@@ -199,3 +140,19 @@ void Camera::calcPerspectiveFOV(int width, int height) {
     };
     mProjection = Matrix4(temp);
 }
+
+Matrix4 Camera::calcScreenToWorld() const {
+    //ビューポート、射影、ビュー、それぞれの逆行列を求める
+    auto invView = Matrix4::inverseAffine(mView);
+    auto invProj = Matrix4::inverse(mProjection);
+
+    auto invViewport = Matrix4::identity;
+    invViewport.m[0][0] = Window::width() / 2.f;
+    invViewport.m[1][1] = -Window::height() / 2.f;
+    invViewport.m[3][0] = Window::width() / 2.f;
+    invViewport.m[3][1] = Window::height() / 2.f;
+    invViewport.inverseAffine();
+
+    //ビューポート、射影、ビュー、それぞれの逆行列を掛ける
+    return invViewport * invProj * invView;
+}
@@ -29,14 +29,21 @@ public:
     //カメラ位置からスクリーン座標からワールド座標に変換した点へのレイを取得する
     //zが0のときカメラから最も近い点、1のとき最も遠い点を計算する z[0, 1]
     Ray screenToRay(const Vector2& position, float z = 1.f);
+    //複数のスクリーン座標へのレイをまとめて取得する
+    //RayPacket::SIZEを超えた分は詰めない
+    RayPacket screenToRayPacket(const Vector2* positions, int count, float z = 1.f);
     //視錐台カリング
     //true : 視錐台の内側
     //false : 視錐台の外側
     bool viewFrustumCulling(const Vector3& pos, float radius) const;
+    //lateUpdateで求めたワールド空間の視錐台を取得する
+    const Frustum& getFrustum() const;
 
 private:
     void calcLookAt();
     void calcPerspectiveFOV(int width, int height);
+    //スクリーン座標からワールド座標への変換行列を求める
+    Matrix4 calcScreenToWorld() const;
 
 private:
     Vector3 mLookAt;
@@ -47,5 +54,7 @@ private:
 
     Matrix4 mView;
     Matrix4 mProjection;
+    //ビュー射影行列から毎フレーム抽出する視錐台
+    Frustum mFrustum;
 };
 
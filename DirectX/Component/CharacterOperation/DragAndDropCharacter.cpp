@@ -6,6 +6,7 @@
 #include "../../GameObject/GameObjectManager.h"
 #include "../../Imgui/imgui.h"
 #include "../../Input/Input.h"
+#include "../../Mesh/MeshPicker.h"
 #include "../../Transform/Transform3D.h"
 #include "../../System/Window.h"
 
@@ -13,6 +14,7 @@ DragAndDropCharacter::DragAndDropCharacter(GameObject& gameObject) :
     Component(gameObject),
     mCamera(nullptr),
     mAABB(nullptr),
+    mPicker(std::make_unique<MeshPicker>()),
     mIntersectPoint(Vector3::zero),
     mIsIntersectRayGround(false),
     mSelectedMesh(true) {
@@ -86,16 +88,17 @@ Ray DragAndDropCharacter::getRayCamraToMousePos(const Vector2& mousePos) const {
 }
 
 bool DragAndDropCharacter::intersectRayGroundMeshes(const Ray& ray) {
-    //すべての地形メッシュとレイの衝突判定
-    for (const auto& gm : mGroundMeshes) {
-        if (Intersect::intersectRayMesh(ray, gm->getMesh(), gm->transform(), mIntersectPoint)) {
-            mIsIntersectRayGround = true;
-            return true;
-        }
+    //カメラから最も近い地形メッシュとの衝突点を求める
+    std::shared_ptr<MeshComponent> mesh;
+    RaycastHit hit;
+    if (!mPicker->pick(ray, mGroundMeshes, mesh, hit)) {
+        //どれとも衝突しなかった
+        return false;
     }
 
-    //どれとも衝突しなかった
-    return false;
+    mIntersectPoint = hit.point;
+    mIsIntersectRayGround = true;
+    return true;
 }
 
 void DragAndDropCharacter::selectMesh(const Ray& ray) {
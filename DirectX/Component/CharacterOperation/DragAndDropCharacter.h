@@ -9,6 +9,7 @@
 class Camera;
 class MeshComponent;
 class AABBCollider;
+class MeshPicker;
 
 //キャラクターをマウスで操作するクラス
 class DragAndDropCharacter : public Component {
@@ -35,6 +36,7 @@ private:
 private:
     std::shared_ptr<Camera> mCamera;
     std::shared_ptr<AABBCollider> mAABB;
+    std::unique_ptr<MeshPicker> mPicker;
     //キャラクターを立たせたい地形メッシュ配列
     std::vector<std::shared_ptr<MeshComponent>> mGroundMeshes;
     //レイと地形との衝突点
@@ -59,14 +59,28 @@ bool AABBSelector::selectAABB() {
     //カメラからマウスの位置へ向かうレイを取得
     const auto& rayCameraToMousePos = mCamera->screenToRay(Input::mouse().getMousePosition());
 
-    //すべてのコライダーとレイの衝突判定
-    for (size_t i = 0; i < mColliders.size(); ++i) {
-        if (Intersect::intersectRayAABB(rayCameraToMousePos, mColliders[i]->getAABB())) {
-            mAABBMouseScaler->setAABB(mColliders[i]);
-            return true;
+    //コライダーは編集で大きさが変わるので毎回詰め直す
+    const auto size = mColliders.size();
+    mAABBs.resize(size);
+    for (size_t i = 0; i < size; ++i) {
+        mAABBs.set(i, mColliders[i]->getAABB());
+    }
+    mHitTimes.resize(size);
+
+    //すべてのコライダーとレイの衝突判定をまとめて行う
+    if (Intersect::intersectRayAABBs(rayCameraToMousePos, mAABBs, mHitTimes.data()) == 0) {
+        //どのコライダーとも衝突しなかった
+        return false;
+    }
+
+    //カメラに最も近いコライダーを選択する
+    size_t nearest = 0;
+    for (size_t i = 1; i < size; ++i) {
+        if (mHitTimes[i] < mHitTimes[nearest]) {
+            nearest = i;
         }
     }
+    mAABBMouseScaler->setAABB(mColliders[nearest]);
 
-    //どのコライダーとも衝突しなかった
-    return false;
+    return true;
 }
@@ -1,6 +1,7 @@
 ﻿#pragma once
 
 #include "../Component.h"
+#include "../../Collision/AABBArray.h"
 #include <memory>
 #include <vector>
 
@@ -34,6 +35,10 @@ private:
     std::shared_ptr<Camera> mCamera;
     std::shared_ptr<AABBMouseScaler> mAABBMouseScaler;
     AABBColliderPtrArray mColliders;
+    //レイ判定用にコライダーのAABBを並べ直したもの
+    AABBArray mAABBs;
+    //各AABBとレイの交差位置
+    std::vector<float> mHitTimes;
     //このクラスにアクセスしてもいい状態か
     bool mCanAccess;
 };
@@ -11,6 +11,7 @@
 #include "../../GameObject/GameObject.h"
 #include "../../GameObject/GameObjectManager.h"
 #include "../../Input/Input.h"
+#include "../../Mesh/MeshPicker.h"
 
 CollideMouseOperator::CollideMouseOperator(GameObject& gameObject)
     : Component(gameObject)
@@ -18,6 +19,7 @@ CollideMouseOperator::CollideMouseOperator(GameObject& gameObject)
     , mAABBSelector(nullptr)
     , mCollideAdder(nullptr)
     , mMeshAdder(nullptr)
+    , mPicker(std::make_unique<MeshPicker>())
     , mSaveLoader(nullptr)
     , mSelecteMesh(nullptr)
 {
@@ -89,23 +91,16 @@ bool CollideMouseOperator::intersectRayGroundMeshes() {
     //カメラからマウスの位置へ向かうレイを取得
     auto rayCameraToMousePos = mCamera->screenToRay(Input::mouse().getMousePosition());
 
-    //すべての地形メッシュとレイの衝突判定
-    Vector3 intersectPoint;
-    for (const auto& gm : mGroundMeshes) {
-        //今選択しているメッシュなら飛ばす
-        if (gm == mSelecteMesh) {
-            continue;
-        }
-
-        //メッシュとレイの衝突判定
-        if (Intersect::intersectRayMesh(rayCameraToMousePos, gm->getMesh(), gm->transform(), intersectPoint)) {
-            changeSelectMesh(gm);
-            return true;
-        }
+    //今選択しているメッシュを除いて、カメラから最も近い地形メッシュを探す
+    std::shared_ptr<MeshComponent> mesh;
+    RaycastHit hit;
+    if (!mPicker->pick(rayCameraToMousePos, mGroundMeshes, mesh, hit, mSelecteMesh.get())) {
+        //どれとも衝突しなかった
+        return false;
     }
 
-    //どれとも衝突しなかった
-    return false;
+    changeSelectMesh(mesh);
+    return true;
 }
 
 void CollideMouseOperator::changeSelectMesh(const std::shared_ptr<MeshComponent>& mesh) {
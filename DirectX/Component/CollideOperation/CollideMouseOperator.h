@@ -10,6 +10,7 @@ class AABBSelector;
 class MeshAdder;
 class CollideAdder;
 class GameObjectSaveAndLoader;
+class MeshPicker;
 
 class CollideMouseOperator : public Component {
 public:
@@ -43,6 +44,7 @@ private:
     std::shared_ptr<AABBSelector> mAABBSelector;
     std::shared_ptr<MeshAdder> mMeshAdder;
     std::shared_ptr<CollideAdder> mCollideAdder;
+    std::unique_ptr<MeshPicker> mPicker;
 
     //外部から受け取る
     std::shared_ptr<GameObjectSaveAndLoader> mSaveLoader;
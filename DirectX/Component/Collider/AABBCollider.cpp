@@ -31,19 +31,27 @@ void AABBCollider::start() {
     }
 
     //早速transformが変わっているかもしれないから更新する
+    //生成直後はワールド行列がまだ求められていないので、先に自身の分だけ求める
+    transform().computeWorldTransform();
     updateAABB();
     //最新のAABBの点を計算する
     updatePoints();
+    //ブロードフェーズに登録する
+    updateProxy();
 }
 
 void AABBCollider::lateUpdate() {
-    //当たり判定が自動化設定されているなら
+    //当たり判定が自動化設定されているなら、ワールド行列の更新後に物理がまとめて変換する
+    //可視化もapplyWorldAABBで最新のAABBが反映されてから行う
     if (mIsAutoUpdate) {
-        updateAABB();
+        markBoundsDirty();
+        return;
     }
 
     //AABBの点を更新する
     updatePoints();
+    //ブロードフェーズに反映する
+    updateProxy();
 
     //当たり判定を可視化する
     if (mIsRenderCollision) {
@@ -56,6 +64,8 @@ void AABBCollider::onEnable(bool value) {
 }
 
 void AABBCollider::loadProperties(const rapidjson::Value& inObj) {
+    Collider::loadProperties(inObj);
+
     if (JsonHelper::getVector3(inObj, "min", &mDefaultMin)) {
         mAABB.min = mDefaultMin;
         mLoadedProperties = true;
@@ -68,6 +78,8 @@ void AABBCollider::loadProperties(const rapidjson::Value& inObj) {
 }
 
 void AABBCollider::saveProperties(rapidjson::Document::AllocatorType& alloc, rapidjson::Value* inObj) const {
+    Collider::saveProperties(alloc, inObj);
+
     JsonHelper::setVector3(alloc, inObj, "min", mDefaultMin);
     JsonHelper::setVector3(alloc, inObj, "max", mDefaultMax);
     JsonHelper::setBool(alloc, inObj, "isRenderCollision", mIsRenderCollision);
@@ -81,6 +93,14 @@ void AABBCollider::drawInspector() {
     ImGui::Checkbox("IsRenderCollision", &mIsRenderCollision);
 }
 
+ColliderType AABBCollider::getType() const {
+    return ColliderType::AABB;
+}
+
+AABB AABBCollider::getBoundingAABB() const {
+    return mAABB;
+}
+
 void AABBCollider::set(const Vector3& min, const Vector3& max) {
     mAABB.min = min;
     mAABB.max = max;
@@ -117,65 +137,30 @@ void AABBCollider::setRenderCollision(bool value) {
     mIsRenderCollision = value;
 }
 
-void AABBCollider::createAABB(const IMesh& mesh) {
-    //すべてのメッシュからAABBを作成する
-    for (size_t i = 0; i < mesh.getMeshCount(); i++) {
-        Vector3 min, max;
-        computeMinMax(min, max, mesh.getMeshVertices(i));
-
-        //当たり判定更新
-        mAABB.updateMinMax(min);
-        mAABB.updateMinMax(max);
-    }
-    mDefaultMin = mAABB.min;
-    mDefaultMax = mAABB.max;
+AABB AABBCollider::getLocalAABB() const {
+    return AABB(mDefaultMin, mDefaultMax);
 }
 
-void AABBCollider::computeMinMax(Vector3& outMin, Vector3& outMax, const MeshVertices& meshVertices) {
-    auto min = Vector3::one * Math::infinity;
-    auto max = Vector3::one * Math::negInfinity;
+void AABBCollider::applyWorldAABB(const AABB& aabb) {
+    mAABB = aabb;
+    updatePoints();
 
-    //メッシュ情報から最小、最大点を割り出す
-    for (size_t i = 0; i < meshVertices.size(); ++i) {
-        const auto& vertices = meshVertices[i];
-        const auto& p = vertices.pos;
-        if (p.x < min.x) {
-            min.x = p.x;
-        }
-        if (p.x > max.x) {
-            max.x = p.x;
-        }
-        if (p.y < min.y) {
-            min.y = p.y;
-        }
-        if (p.y > max.y) {
-            max.y = p.y;
-        }
-        if (p.z < min.z) {
-            min.z = p.z;
-        }
-        if (p.z > max.z) {
-            max.z = p.z;
-        }
+    //当たり判定を可視化する
+    if (mIsRenderCollision) {
+        renderCollision();
     }
+}
 
-    outMin = min;
-    outMax = max;
+void AABBCollider::createAABB(const IMesh& mesh) {
+    //読み込み時に求めてあるメッシュ全体のAABBを使う
+    mAABB = mesh.getAABB();
+    mDefaultMin = mAABB.min;
+    mDefaultMax = mAABB.max;
 }
 
 void AABBCollider::updateAABB() {
-    const auto& t = transform();
-    const auto& pos = t.getPosition();
-    const auto& scale = t.getScale();
-    //回転を適用するために一時的なAABBを作成する
-    AABB aabb(mDefaultMin - t.getPivot(), mDefaultMax - t.getPivot());
-    aabb.min = aabb.min * scale;
-    aabb.max = aabb.max * scale;
-    //回転を適用する
-    aabb.rotate(t.getRotation());
-    //既存のAABBを更新する
-    mAABB.min = aabb.min + pos;
-    mAABB.max = aabb.max + pos;
+    //ワールド行列はピボット、スケール、回転、位置の順に掛けたもの
+    mAABB = getLocalAABB().transform(transform().getWorldTransform());
 }
 
 void AABBCollider::updatePoints() {
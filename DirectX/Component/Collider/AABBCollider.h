@@ -4,7 +4,6 @@
 #include "../../Collision/Collision.h"
 #include "../../Math/Math.h"
 #include "../../Mesh/IMesh.h"
-#include "../../Mesh/IMeshLoader.h"
 #include <array>
 #include <utility>
 
@@ -18,6 +17,8 @@ public:
     virtual void loadProperties(const rapidjson::Value& inObj) override;
     virtual void saveProperties(rapidjson::Document::AllocatorType& alloc, rapidjson::Value* inObj) const override;
     virtual void drawInspector() override;
+    virtual ColliderType getType() const override;
+    virtual AABB getBoundingAABB() const override;
 
     //AABBの最小と最大点を直接設定する
     void set(const Vector3& min, const Vector3& max);
@@ -29,12 +30,15 @@ public:
     std::array<std::pair<Vector3, Vector3>, 6> getBoxSurfacesCenterAndNormal() const;
     //当たり判定を可視化するか
     void setRenderCollision(bool value);
+    //transformの影響を考慮しないAABBを取得する
+    AABB getLocalAABB() const;
+    //物理がまとめて変換したワールド空間のAABBを反映し、可視化する
+    //自動更新時はPhysics::sweepAndPruneの中で呼ばれ、それまでは前フレームのAABBを返す
+    void applyWorldAABB(const AABB& aabb);
 
 private:
     //AABBを作成する
     void createAABB(const IMesh& mesh);
-    //メッシュから最小、最大点を割り出す
-    void computeMinMax(Vector3& outMin, Vector3& outMax, const MeshVertices& meshVertices);
     //AABBを更新する
     void updateAABB();
     //AABBの点を更新する
@@ -37,12 +37,25 @@ void CircleCollider::drawInspector() {
     ImGui::SliderFloat("Radius", &mCircle.radius, FLT_MIN, FLT_MAX);
 }
 
+ColliderType CircleCollider::getType() const {
+    return ColliderType::CIRCLE;
+}
+
+AABB CircleCollider::getBoundingAABB() const {
+    //2Dなのでz軸は0で潰す
+    const auto& c = mCircle.center;
+    const auto r = mCircle.radius;
+    return AABB(Vector3(c.x - r, c.y - r, 0.f), Vector3(c.x + r, c.y + r, 0.f));
+}
+
 void CircleCollider::set(const Vector2& center, float radius) {
     mCircle.center = center;
     mCircle.radius = radius;
     if (mIsAutoUpdate) {
         mIsAutoUpdate = false;
     }
+
+    updateProxy();
 }
 
 const Circle& CircleCollider::getCircle() const {
@@ -63,4 +76,6 @@ void CircleCollider::circleUpdate() {
 
     mCircle.center = t.getPosition();
     mCircle.radius = radius;
+
+    updateProxy();
 }
@@ -14,6 +14,8 @@ public:
     virtual void start() override;
     virtual void update() override;
     virtual void drawInspector() override;
+    virtual ColliderType getType() const override;
+    virtual AABB getBoundingAABB() const override;
 
     void set(const Vector2& center, float radius);
     const Circle& getCircle() const;
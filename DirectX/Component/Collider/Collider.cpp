@@ -1,41 +1,59 @@
 ﻿#include "Collider.h"
 #include "../../Device/Physics.h"
 #include "../../Imgui/imgui.h"
-#include <algorithm>
+#include "../../Utility/LevelLoader.h"
 
 Collider::Collider(GameObject& gameObject) :
     Component(gameObject),
     mIsAutoUpdate(true),
-    mEnable(false) {
+    mEnable(false),
+    mProxyID(NULL_PROXY),
+    mLayer(0),
+    mCollisionMask(CollisionLayer::ALL) {
 }
 
 Collider::~Collider() = default;
 
 void Collider::start() {
     if (mPhysics) {
-        mPhysics->add(shared_from_this());
+        mProxyID = mPhysics->add(shared_from_this());
         mEnable = true;
     }
 }
 
-void Collider::lateUpdate() {
-    mPreviousCollider.resize(mCurrentCollider.size());
-    std::copy(mCurrentCollider.begin(), mCurrentCollider.end(), mPreviousCollider.begin());
-    mCurrentCollider.clear();
-}
-
 void Collider::finalize() {
-    mPreviousCollider.clear();
-    mCurrentCollider.clear();
+    if (mPhysics && mProxyID != NULL_PROXY) {
+        mPhysics->remove(mProxyID);
+        mProxyID = NULL_PROXY;
+    }
+}
 
-    if (mPhysics) {
-        mPhysics->remove(shared_from_this());
+void Collider::loadProperties(const rapidjson::Value& inObj) {
+    int layer = 0;
+    if (JsonHelper::getInt(inObj, "layer", &layer)) {
+        mLayer = Math::clamp<int>(layer, 0, CollisionLayer::COUNT - 1);
+    }
+    //JSONには符号付きで書かれるのでビット列として読み直す
+    int mask = 0;
+    if (JsonHelper::getInt(inObj, "collisionMask", &mask)) {
+        mCollisionMask = static_cast<unsigned>(mask);
     }
 }
 
+void Collider::saveProperties(rapidjson::Document::AllocatorType& alloc, rapidjson::Value* inObj) const {
+    JsonHelper::setInt(alloc, inObj, "layer", mLayer);
+    JsonHelper::setInt(alloc, inObj, "collisionMask", static_cast<int>(mCollisionMask));
+}
+
 void Collider::drawInspector() {
     ImGui::Checkbox("IsAutoUpdate", &mIsAutoUpdate);
     ImGui::Checkbox("Enable", &mEnable);
+    if (ImGui::SliderInt("Layer", &mLayer, 0, CollisionLayer::COUNT - 1)) {
+        updateFilter();
+    }
+    if (ImGui::InputScalar("CollisionMask", ImGuiDataType_U32, &mCollisionMask, nullptr, nullptr, "%08X", ImGuiInputTextFlags_CharsHexadecimal)) {
+        updateFilter();
+    }
 }
 
 void Collider::onEnable(bool value) {
@@ -60,46 +78,61 @@ void Collider::automation() {
     }
 }
 
-void Collider::addHitCollider(const CollPtr& hit) {
-    mCurrentCollider.emplace_back(hit);
+void Collider::setLayer(int layer) {
+    mLayer = Math::clamp<int>(layer, 0, CollisionLayer::COUNT - 1);
+    updateFilter();
 }
 
-std::list<std::shared_ptr<Collider>> Collider::onCollisionEnter() const {
-    std::list<std::shared_ptr<Collider>> temp;
-    for (const auto& c : mCurrentCollider) {
-        auto itr = std::find(mPreviousCollider.begin(), mPreviousCollider.end(), c);
-        if (itr == mPreviousCollider.end()) {
-            temp.emplace_back(c);
-        }
-    }
+int Collider::getLayer() const {
+    return mLayer;
+}
 
-    return temp;
+void Collider::setCollisionMask(unsigned mask) {
+    mCollisionMask = mask;
+    updateFilter();
 }
 
-std::list<std::shared_ptr<Collider>> Collider::onCollisionStay() const {
-    std::list<std::shared_ptr<Collider>> temp;
-    for (const auto& c : mCurrentCollider) {
-        auto itr = std::find(mPreviousCollider.begin(), mPreviousCollider.end(), c);
-        if (itr != mPreviousCollider.end()) {
-            temp.emplace_back(c);
-        }
-    }
+unsigned Collider::getCollisionMask() const {
+    return mCollisionMask;
+}
 
-    return temp;
+Collider::CollSpan Collider::onCollisionEnter() const {
+    return getContacts(CollisionEvent::ENTER);
 }
 
-std::list<std::shared_ptr<Collider>> Collider::onCollisionExit() const {
-    std::list<std::shared_ptr<Collider>> temp;
-    for (const auto& c : mPreviousCollider) {
-        auto itr = std::find(mCurrentCollider.begin(), mCurrentCollider.end(), c);
-        if (itr == mCurrentCollider.end()) {
-            temp.emplace_back(c);
-        }
-    }
+Collider::CollSpan Collider::onCollisionStay() const {
+    return getContacts(CollisionEvent::STAY);
+}
 
-    return temp;
+Collider::CollSpan Collider::onCollisionExit() const {
+    return getContacts(CollisionEvent::EXIT);
 }
 
 void Collider::setPhysics(Physics* physics) {
     mPhysics = physics;
 }
+
+Collider::CollSpan Collider::getContacts(CollisionEvent event) const {
+    if (!mPhysics || mProxyID == NULL_PROXY) {
+        return CollSpan();
+    }
+    return mPhysics->getContacts(mProxyID, event);
+}
+
+void Collider::updateFilter() {
+    if (mPhysics && mProxyID != NULL_PROXY) {
+        mPhysics->setFilter(mProxyID, CollisionLayer::toBit(mLayer), mCollisionMask);
+    }
+}
+
+void Collider::updateProxy() {
+    if (mPhysics && mProxyID != NULL_PROXY) {
+        mPhysics->move(mProxyID, getBoundingAABB());
+    }
+}
+
+void Collider::markBoundsDirty() {
+    if (mPhysics && mProxyID != NULL_PROXY) {
+        mPhysics->markBoundsDirty(mProxyID);
+    }
+}
@@ -1,15 +1,25 @@
 ﻿#pragma once
 
 #include "../Component.h"
-#include <list>
+#include "../../Collision/AABB.h"
+#include "../../Collision/CollisionLayer.h"
+#include "../../Utility/Span.h"
 #include <memory>
 #include <string>
 
 class Physics;
+enum class CollisionEvent;
+
+//コライダーの種類
+enum class ColliderType {
+    AABB,
+    SPHERE,
+    CIRCLE,
+    OBB
+};
 
 class Collider : public Component, public std::enable_shared_from_this<Collider> {
-    using CollPtr = std::shared_ptr<Collider>;
-    using CollPtrList = std::list<CollPtr>;
+    using CollSpan = Span<Collider* const>;
 
 protected:
     Collider(GameObject& gameObject);
@@ -17,10 +27,15 @@ protected:
 
 public:
     virtual void start() override;
-    virtual void lateUpdate() override;
     virtual void finalize() override;
+    virtual void loadProperties(const rapidjson::Value& inObj) override;
+    virtual void saveProperties(rapidjson::Document::AllocatorType& alloc, rapidjson::Value* inObj) const override;
     virtual void drawInspector() override;
     virtual void onEnable(bool value) override;
+    //コライダーの種類を取得する
+    virtual ColliderType getType() const = 0;
+    //ブロードフェーズ用の境界ボックスを取得する
+    virtual AABB getBoundingAABB() const = 0;
     //当たり判定を有効化
     void enabled();
     //当たり判定を無効化
@@ -29,24 +44,47 @@ public:
     bool getEnable() const;
     //衝突判定の自動化
     void automation();
-    //コライダーを追加
-    void addHitCollider(const CollPtr& hit);
-    //衝突した瞬間のオブジェクトリストを取得
-    CollPtrList onCollisionEnter() const;
-    //衝突し続けているオブジェクトリストを取得
-    CollPtrList onCollisionStay() const;
-    //衝突しなくなった瞬間のオブジェクトリストを取得
-    CollPtrList onCollisionExit() const;
+    //所属するレイヤー [0, CollisionLayer::COUNT)
+    void setLayer(int layer);
+    int getLayer() const;
+    //判定するレイヤーのビットマスク
+    void setCollisionMask(unsigned mask);
+    unsigned getCollisionMask() const;
+    //衝突した瞬間のコライダーを取得
+    //次の物理更新までの間だけ有効
+    CollSpan onCollisionEnter() const;
+    //衝突し続けているコライダーを取得
+    CollSpan onCollisionStay() const;
+    //衝突しなくなった瞬間のコライダーを取得
+    CollSpan onCollisionExit() const;
 
     static void setPhysics(Physics* physics);
 
+protected:
+    //境界ボックスが変わったことを物理に知らせる
+    void updateProxy();
+    //ワールド行列が確定した後で境界ボックスを更新するよう物理に頼む
+    void markBoundsDirty();
+
+private:
+    //物理から接触しているコライダーを取得する
+    CollSpan getContacts(CollisionEvent event) const;
+    //レイヤーとマスクの変更を物理に知らせる
+    void updateFilter();
+
 protected:
     bool mIsAutoUpdate;
     bool mEnable;
 
 private:
-    CollPtrList mPreviousCollider;
-    CollPtrList mCurrentCollider;
+    //物理で管理されている番号
+    unsigned mProxyID;
+    //所属するレイヤー
+    int mLayer;
+    //判定するレイヤーのビットマスク
+    unsigned mCollisionMask;
+
+    static constexpr unsigned NULL_PROXY = 0xffffffff;
 
     static inline Physics* mPhysics = nullptr;
 };
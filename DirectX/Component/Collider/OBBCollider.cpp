@@ -0,0 +1,169 @@
+﻿#include "OBBCollider.h"
+#include "../Mesh/MeshComponent.h"
+#include "../../DebugLayer/Debug.h"
+#include "../../DebugLayer/ImGuiWrapper.h"
+#include "../../Imgui/imgui.h"
+#include "../../Transform/Transform3D.h"
+#include "../../Utility/LevelLoader.h"
+
+OBBCollider::OBBCollider(GameObject& gameObject) :
+    Collider(gameObject),
+    mOBB(),
+    mDefaultOBB(),
+    mIsRenderCollision(true),
+    mLoadedProperties(false) {
+}
+
+OBBCollider::~OBBCollider() = default;
+
+void OBBCollider::start() {
+    Collider::start();
+
+    //ファイルから値を読み込んでいないなら頂点から形成する
+    if (!mLoadedProperties) {
+        auto meshComponent = getComponent<MeshComponent>();
+        if (meshComponent) {
+            createOBB(meshComponent->getMesh());
+        }
+    }
+
+    //早速transformが変わっているかもしれないから更新する
+    updateOBB();
+    //ブロードフェーズに登録する
+    updateProxy();
+}
+
+void OBBCollider::lateUpdate() {
+    //当たり判定が自動化設定されているなら
+    if (mIsAutoUpdate) {
+        updateOBB();
+    }
+
+    //ブロードフェーズに反映する
+    updateProxy();
+
+    //当たり判定を可視化する
+    if (mIsRenderCollision) {
+        renderCollision();
+    }
+}
+
+void OBBCollider::onEnable(bool value) {
+    setRenderCollision(value);
+}
+
+void OBBCollider::loadProperties(const rapidjson::Value& inObj) {
+    Collider::loadProperties(inObj);
+
+    auto& obb = mDefaultOBB;
+    if (JsonHelper::getVector3(inObj, "center", &obb.center)) {
+        mLoadedProperties = true;
+    }
+    if (JsonHelper::getVector3(inObj, "extents", &obb.extents)) {
+        mLoadedProperties = true;
+    }
+    JsonHelper::getVector3(inObj, "axisX", &obb.axes[0]);
+    JsonHelper::getVector3(inObj, "axisY", &obb.axes[1]);
+    JsonHelper::getVector3(inObj, "axisZ", &obb.axes[2]);
+    JsonHelper::getBool(inObj, "isRenderCollision", &mIsRenderCollision);
+}
+
+void OBBCollider::saveProperties(rapidjson::Document::AllocatorType& alloc, rapidjson::Value* inObj) const {
+    Collider::saveProperties(alloc, inObj);
+
+    JsonHelper::setVector3(alloc, inObj, "center", mDefaultOBB.center);
+    JsonHelper::setVector3(alloc, inObj, "extents", mDefaultOBB.extents);
+    JsonHelper::setVector3(alloc, inObj, "axisX", mDefaultOBB.axes[0]);
+    JsonHelper::setVector3(alloc, inObj, "axisY", mDefaultOBB.axes[1]);
+    JsonHelper::setVector3(alloc, inObj, "axisZ", mDefaultOBB.axes[2]);
+    JsonHelper::setBool(alloc, inObj, "isRenderCollision", mIsRenderCollision);
+}
+
+void OBBCollider::drawInspector() {
+    Collider::drawInspector();
+
+    ImGuiWrapper::dragVector3("DefaultCenter", mDefaultOBB.center, 0.01f);
+    ImGuiWrapper::dragVector3("DefaultExtents", mDefaultOBB.extents, 0.01f);
+    ImGui::Checkbox("IsRenderCollision", &mIsRenderCollision);
+}
+
+ColliderType OBBCollider::getType() const {
+    return ColliderType::OBB;
+}
+
+AABB OBBCollider::getBoundingAABB() const {
+    return mOBB.getBoundingAABB();
+}
+
+void OBBCollider::set(const OBB& obb) {
+    mDefaultOBB = obb;
+    updateOBB();
+}
+
+const OBB& OBBCollider::getOBB() const {
+    return mOBB;
+}
+
+const std::array<Vector3, 8>& OBBCollider::getBoxPoints() const {
+    return mPoints;
+}
+
+void OBBCollider::setRenderCollision(bool value) {
+    mIsRenderCollision = value;
+}
+
+void OBBCollider::createOBB(const IMesh& mesh) {
+    //外側の形は凸包の頂点だけで決まるので、全頂点ではなく凸包の頂点に合わせる
+    mDefaultOBB = OBB::createFromPoints(mesh.getConvexHull().getVertices());
+}
+
+void OBBCollider::updateOBB() {
+    auto& t = transform();
+    //ワールド行列はピボット、スケール、回転、位置の順に掛けたもの 変更がなければ何もしない
+    t.computeWorldTransform();
+    const auto& world = t.getWorldTransform();
+    const auto rot = t.getRotation();
+
+    mOBB.center = Vector3::transform(mDefaultOBB.center, world);
+
+    //各軸の半分の長さのベクトルをワールド行列で変形する
+    //非一様な拡縮と回転が重なると、変形後の箱は直交しない平行六面体になる
+    Vector3 halfAxes[3];
+    for (int i = 0; i < 3; ++i) {
+        halfAxes[i] = Vector3::transform(mDefaultOBB.axes[i] * mDefaultOBB.extents[i], world, 0.f);
+    }
+
+    //軸は回転だけを掛けて直交を保ち、長さは平行六面体をその軸に射影した半径にする
+    //歪みがなければ変形後の箱そのもの、歪んでいても必ず内包するので分離軸判定で重なりを見逃さない
+    for (int i = 0; i < 3; ++i) {
+        auto& axis = mOBB.axes[i];
+        axis = Vector3::transform(mDefaultOBB.axes[i], rot);
+        mOBB.extents[i] =
+            Math::abs(Vector3::dot(halfAxes[0], axis)) +
+            Math::abs(Vector3::dot(halfAxes[1], axis)) +
+            Math::abs(Vector3::dot(halfAxes[2], axis));
+    }
+
+    //OBBの点を更新する
+    mOBB.computePoints(mPoints);
+}
+
+void OBBCollider::renderCollision() {
+#ifdef _DEBUG
+    //デバッグ時のみ当たり判定を表示
+    Debug::renderLine(mPoints[0], mPoints[1], ColorPalette::lightGreen);
+    Debug::renderLine(mPoints[0], mPoints[2], ColorPalette::lightGreen);
+    Debug::renderLine(mPoints[2], mPoints[3], ColorPalette::lightGreen);
+    Debug::renderLine(mPoints[1], mPoints[3], ColorPalette::lightGreen);
+
+    Debug::renderLine(mPoints[4], mPoints[5], ColorPalette::lightGreen);
+    Debug::renderLine(mPoints[4], mPoints[6], ColorPalette::lightGreen);
+    Debug::renderLine(mPoints[6], mPoints[7], ColorPalette::lightGreen);
+    Debug::renderLine(mPoints[5], mPoints[7], ColorPalette::lightGreen);
+
+    Debug::renderLine(mPoints[0], mPoints[4], ColorPalette::lightGreen);
+    Debug::renderLine(mPoints[1], mPoints[5], ColorPalette::lightGreen);
+    Debug::renderLine(mPoints[2], mPoints[6], ColorPalette::lightGreen);
+    Debug::renderLine(mPoints[3], mPoints[7], ColorPalette::lightGreen);
+#endif // _DEBUG
+}
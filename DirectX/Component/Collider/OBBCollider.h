@@ -0,0 +1,50 @@
+﻿#pragma once
+
+#include "Collider.h"
+#include "../../Collision/Collision.h"
+#include "../../Math/Math.h"
+#include "../../Mesh/IMesh.h"
+#include <array>
+
+class OBBCollider : public Collider {
+public:
+    OBBCollider(GameObject& gameObject);
+    ~OBBCollider();
+    virtual void start() override;
+    virtual void lateUpdate() override;
+    virtual void onEnable(bool value) override;
+    virtual void loadProperties(const rapidjson::Value& inObj) override;
+    virtual void saveProperties(rapidjson::Document::AllocatorType& alloc, rapidjson::Value* inObj) const override;
+    virtual void drawInspector() override;
+    virtual ColliderType getType() const override;
+    virtual AABB getBoundingAABB() const override;
+
+    //transformの影響を考慮しないOBBを直接設定する
+    void set(const OBB& obb);
+    //OBBを取得する
+    const OBB& getOBB() const;
+    //OBBのすべての点を取得する
+    const std::array<Vector3, 8>& getBoxPoints() const;
+    //当たり判定を可視化するか
+    void setRenderCollision(bool value);
+
+private:
+    //メッシュの全頂点からOBBを作成する
+    void createOBB(const IMesh& mesh);
+    //OBBを更新する
+    void updateOBB();
+    //当たり判定を可視化する
+    void renderCollision();
+
+private:
+    //当たり判定であるOBB
+    OBB mOBB;
+    //transformの影響を考慮しないOBB
+    OBB mDefaultOBB;
+    //OBBの各点
+    std::array<Vector3, 8> mPoints;
+    //当たり判定を表示するか
+    bool mIsRenderCollision;
+    //ファイルから値を読み込んだか
+    bool mLoadedProperties;
+};
@@ -21,11 +21,11 @@ void SphereCollider::start() {
         //メッシュ情報から球を作成する
         createSphere(mesh);
     }
+
+    updateProxy();
 }
 
 void SphereCollider::lateUpdate() {
-    Collider::lateUpdate();
-
     if (!mIsAutoUpdate) {
         return;
     }
@@ -37,6 +37,8 @@ void SphereCollider::lateUpdate() {
 
     mSphere.center = center;
     mSphere.radius = radius;
+
+    updateProxy();
 }
 
 void SphereCollider::drawInspector() {
@@ -48,12 +50,23 @@ void SphereCollider::drawInspector() {
     ImGui::SliderFloat("Radius", &mSphere.radius, FLT_MIN, FLT_MAX);
 }
 
+ColliderType SphereCollider::getType() const {
+    return ColliderType::SPHERE;
+}
+
+AABB SphereCollider::getBoundingAABB() const {
+    auto extents = Vector3::one * mSphere.radius;
+    return AABB(mSphere.center - extents, mSphere.center + extents);
+}
+
 void SphereCollider::set(const Vector3& center, float radius) {
     mSphere.center = center;
     mSphere.radius = radius;
     if (mIsAutoUpdate) {
         mIsAutoUpdate = false;
     }
+
+    updateProxy();
 }
 
 const Sphere& SphereCollider::getSphere() const {
@@ -61,47 +74,10 @@ const Sphere& SphereCollider::getSphere() const {
 }
 
 void SphereCollider::createSphere(const IMesh& mesh) {
-    //すべてのメッシュから球を作成する
-    auto min = Vector3::one * Math::infinity;
-    auto max = Vector3::one * Math::negInfinity;
-    for (size_t i = 0; i < mesh.getMeshCount(); i++) {
-        computeCenterRadius(min, max, mesh.getMeshVertices(i));
-    }
-    mDefaultCenter = (min + max) / 2.f;
-    mDefaultRadius = (max - min).length() / 2.f;
+    //読み込み時に求めてあるメッシュ全体の球を使う
+    const auto& sphere = mesh.getSphere();
+    mDefaultCenter = sphere.center;
+    mDefaultRadius = sphere.radius;
     mSphere.center = mDefaultCenter;
     mSphere.radius = mDefaultRadius;
 }
-
-void SphereCollider::computeCenterRadius(Vector3& outMin, Vector3& outMax, const MeshVertices& meshVertices) {
-    //中心位置計算のための最小、最大位置
-    auto min = outMin;
-    auto max = outMax;
-
-    //メッシュ情報から最小、最大点を割り出す
-    for (size_t i = 0; i < meshVertices.size(); ++i) {
-        const auto& vertices = meshVertices[i];
-        const auto& p = vertices.pos;
-        if (p.x < min.x) {
-            min.x = p.x;
-        }
-        if (p.x > max.x) {
-            max.x = p.x;
-        }
-        if (p.y < min.y) {
-            min.y = p.y;
-        }
-        if (p.y > max.y) {
-            max.y = p.y;
-        }
-        if (p.z < min.z) {
-            min.z = p.z;
-        }
-        if (p.z > max.z) {
-            max.z = p.z;
-        }
-    }
-
-    outMin = min;
-    outMax = max;
-}
@@ -4,7 +4,6 @@
 #include "../../Collision/Collision.h"
 #include "../../Math/Math.h"
 #include "../../Mesh/IMesh.h"
-#include "../../Mesh/IMeshLoader.h"
 
 class SphereCollider : public Collider {
 public:
@@ -13,6 +12,8 @@ public:
     virtual void start() override;
     virtual void lateUpdate() override;
     virtual void drawInspector() override;
+    virtual ColliderType getType() const override;
+    virtual AABB getBoundingAABB() const override;
 
     //中心位置と半径を直接設定する
     void set(const Vector3& center, float radius);
@@ -22,8 +23,6 @@ public:
 private:
     //メッシュから球を作る
     void createSphere(const IMesh& mesh);
-    //メッシュから最小、最大点を割り出す
-    void computeCenterRadius(Vector3& outMin, Vector3& outMax, const MeshVertices& meshVertices);
 
 private:
     Sphere mSphere;
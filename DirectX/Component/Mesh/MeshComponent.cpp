@@ -20,7 +20,8 @@ MeshComponent::MeshComponent(GameObject& gameObject) :
     mFileName(),
     mDirectoryPath(),
     mState(State::ACTIVE),
-    mAlpha(1.f) {
+    mAlpha(1.f),
+    mIsOccluder(false) {
 }
 
 MeshComponent::~MeshComponent() = default;
@@ -60,6 +61,7 @@ void MeshComponent::loadProperties(const rapidjson::Value& inObj) {
 
     //アルファ値を取得する
     JsonHelper::getFloat(inObj, "alpha", &mAlpha);
+    JsonHelper::getBool(inObj, "isOccluder", &mIsOccluder);
 }
 
 void MeshComponent::saveProperties(rapidjson::Document::AllocatorType& alloc, rapidjson::Value* inObj) const {
@@ -67,11 +69,13 @@ void MeshComponent::saveProperties(rapidjson::Document::AllocatorType& alloc, ra
     JsonHelper::setString(alloc, inObj, "directoryPath", mDirectoryPath);
     JsonHelper::setString(alloc, inObj, "shaderName", mShader->getShaderName());
     JsonHelper::setFloat(alloc, inObj, "alpha", mAlpha);
+    JsonHelper::setBool(alloc, inObj, "isOccluder", mIsOccluder);
 }
 
 void MeshComponent::drawInspector() {
     ImGui::Text("FileName: %s", (mDirectoryPath + mFileName).c_str());
     ImGui::SliderFloat("Alpha", &mAlpha, 0.f, 1.f);
+    ImGui::Checkbox("IsOccluder", &mIsOccluder);
 }
 
 void MeshComponent::draw(const Camera& camera, const DirectionalLight& dirLight) const {
@@ -159,6 +163,14 @@ float MeshComponent::getAlpha() const {
     return mAlpha;
 }
 
+void MeshComponent::setOccluder(bool value) {
+    mIsOccluder = value;
+}
+
+bool MeshComponent::isOccluder() const {
+    return mIsOccluder;
+}
+
 void MeshComponent::setMeshManager(MeshManager* manager) {
     mMeshManager = manager;
 }
@@ -50,6 +50,9 @@ public:
     void setAlpha(float alpha);
     //アルファ値を取得する
     float getAlpha() const;
+    //他のメッシュを隠すオクルーダーとして深度を描くか
+    void setOccluder(bool value);
+    bool isOccluder() const;
 
     //自身を管理するマネージャーを登録する
     static void setMeshManager(MeshManager* manager);
@@ -67,6 +70,7 @@ protected:
     std::string mDirectoryPath;
     State mState;
     float mAlpha;
+    bool mIsOccluder;
 
     static inline MeshManager* mMeshManager = nullptr;
 };
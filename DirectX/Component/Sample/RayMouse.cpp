@@ -48,7 +48,7 @@ void RayMouse::update() {
     //マウスの左ボタンが押されたら
     if (mouse.getMouseButtonDown(MouseCode::LeftButton)) {
         //メッシュとレイの衝突判定
-        //if (!Intersect::intersectRayMesh(ray, mMesh->getMesh(), transform(), mIntersectPoint)) {
+        //if (!Intersect::intersectRayMesh(ray, mMesh->getMesh(), transform().getWorldTransform(), mIntersectPoint)) {
         //    return;
         //}
         //無限平面とレイの衝突判定
@@ -1,11 +1,19 @@
 ﻿#include "Physics.h"
+#include "ThreadPool.h"
 #include "../Collision/Collision.h"
 #include "../Component/ComponentManager.h"
+#include "../Component/Collider/AABBCollider.h"
+#include "../Component/Collider/CircleCollider.h"
 #include "../Component/Collider/Collider.h"
+#include "../Component/Collider/OBBCollider.h"
 #include "../Component/Collider/SphereCollider.h"
+#include "../Transform/Transform3D.h"
+#include "../Utility/LevelLoader.h"
 #include <algorithm>
 
-Physics::Physics() {
+Physics::Physics(ThreadPool& threadPool) :
+    mBroadphase(BroadphaseType::SWEEP_AND_PRUNE),
+    mThreadPool(threadPool) {
     Collider::setPhysics(this);
 }
 
@@ -13,56 +21,502 @@ Physics::~Physics() {
     Collider::setPhysics(nullptr);
 }
 
-void Physics::add(const CollPtr& collider) {
-    mColliders.emplace_back(collider);
+void Physics::loadProperties(const rapidjson::Value& inObj) {
+    const auto& obj = inObj["physics"];
+    if (obj.IsObject()) {
+        std::string broadphase;
+        if (JsonHelper::getString(obj, "broadphase", &broadphase)) {
+            mBroadphase = (broadphase == "SpatialHashGrid") ? BroadphaseType::SPATIAL_HASH_GRID : BroadphaseType::SWEEP_AND_PRUNE;
+        }
+        float cellSize = 0.f;
+        if (JsonHelper::getFloat(obj, "gridCellSize", &cellSize) && cellSize > 0.f) {
+            mGrid.setCellSize(cellSize);
+        }
+    }
 }
 
-void Physics::remove(const CollPtr& collider) {
-    auto itr = std::find(mColliders.begin(), mColliders.end(), collider);
-    if (itr != mColliders.end()) {
-        std::iter_swap(itr, mColliders.end() - 1);
-        mColliders.pop_back();
+unsigned Physics::add(const CollPtr& collider) {
+    //空いている番号があれば再利用する
+    unsigned id = 0;
+    if (mFreeProxies.empty()) {
+        id = static_cast<unsigned>(mProxies.size());
+        mProxies.emplace_back();
+    } else {
+        id = mFreeProxies.back();
+        mFreeProxies.pop_back();
     }
+    mProxies[id].collider = collider;
+    mProxies[id].aabb = AABB();
+    //境界ボックスが決まるまでは木にもブロードフェーズにも登録しない
+    mProxies[id].treeProxy = NULL_TREE_PROXY;
+    mProxies[id].gridProxy = NULL_GRID_PROXY;
+    mProxies[id].sapProxy = NULL_SAP_PROXY;
+    mProxies[id].layerBit = CollisionLayer::toBit(collider->getLayer());
+    mProxies[id].collisionMask = collider->getCollisionMask();
+
+    return id;
+}
+
+void Physics::remove(unsigned proxyID) {
+    if (proxyID >= mProxies.size() || !mProxies[proxyID].collider) {
+        return;
+    }
+
+    auto id = proxyID;
+    auto& proxy = mProxies[id];
+
+    //削除されたコライダーを接触情報に残さない
+    auto hasID = [id](unsigned long long key) {
+        return static_cast<unsigned>(key >> 32) == id || static_cast<unsigned>(key & 0xffffffff) == id;
+    };
+    mContacts.erase(std::remove_if(mContacts.begin(), mContacts.end(), hasID), mContacts.end());
+    mPreviousContacts.erase(std::remove_if(mPreviousContacts.begin(), mPreviousContacts.end(), hasID), mPreviousContacts.end());
+    for (auto&& events : mContactEvents) {
+        size_t count = 0;
+        for (size_t i = 0; i < events.contacts.size(); ++i) {
+            const auto& c = events.contacts[i];
+            if (c.self != id && c.other != id) {
+                events.contacts[count] = c;
+                events.colliders[count] = events.colliders[i];
+                ++count;
+            }
+        }
+        events.contacts.resize(count);
+        events.colliders.resize(count);
+    }
+
+    if (proxy.treeProxy != NULL_TREE_PROXY) {
+        mTree.destroyProxy(proxy.treeProxy);
+        proxy.treeProxy = NULL_TREE_PROXY;
+    }
+    if (proxy.gridProxy != NULL_GRID_PROXY) {
+        mGrid.destroyProxy(proxy.gridProxy);
+        proxy.gridProxy = NULL_GRID_PROXY;
+    }
+    if (proxy.sapProxy != NULL_SAP_PROXY) {
+        mSweepAndPrune.destroyProxy(proxy.sapProxy);
+        proxy.sapProxy = NULL_SAP_PROXY;
+    }
+
+    proxy.collider.reset();
+    mFreeProxies.emplace_back(id);
+}
+
+void Physics::move(unsigned proxyID, const AABB& aabb) {
+    auto& proxy = mProxies[proxyID];
+    proxy.aabb = aabb;
+
+    //木は広げたAABBからはみ出したときだけ組み替わる
+    if (proxy.treeProxy == NULL_TREE_PROXY) {
+        proxy.treeProxy = mTree.createProxy(aabb, proxyID);
+    } else {
+        mTree.moveProxy(proxy.treeProxy, aabb);
+    }
+
+    if (mBroadphase == BroadphaseType::SWEEP_AND_PRUNE) {
+        if (proxy.sapProxy == NULL_SAP_PROXY) {
+            proxy.sapProxy = mSweepAndPrune.createProxy(aabb, proxyID);
+        } else {
+            mSweepAndPrune.moveProxy(proxy.sapProxy, aabb);
+        }
+    }
+    if (mBroadphase == BroadphaseType::SPATIAL_HASH_GRID) {
+        if (proxy.gridProxy == NULL_GRID_PROXY) {
+            proxy.gridProxy = mGrid.createProxy(aabb, proxyID);
+        } else {
+            mGrid.moveProxy(proxy.gridProxy, aabb);
+        }
+    }
+}
+
+void Physics::markBoundsDirty(unsigned proxyID) {
+    mDirtyProxies.emplace_back(proxyID);
+}
+
+void Physics::setFilter(unsigned proxyID, unsigned layerBit, unsigned collisionMask) {
+    auto& proxy = mProxies[proxyID];
+    proxy.layerBit = layerBit;
+    proxy.collisionMask = collisionMask;
 }
 
 void Physics::clear() {
-    mColliders.clear();
+    mProxies.clear();
+    mFreeProxies.clear();
+    mSweepAndPrune.clear();
+    mTree.clear();
+    mGrid.clear();
+    mContacts.clear();
+    mPreviousContacts.clear();
+    for (auto&& events : mContactEvents) {
+        events.contacts.clear();
+        events.colliders.clear();
+    }
+    mDirtyProxies.clear();
 }
 
 void Physics::sweepAndPrune() {
-    if (mColliders.empty()) {
+    updateDirtyBounds();
+
+    if (mProxies.empty()) {
+        return;
+    }
+
+    mCandidatePairs.clear();
+
+    if (mBroadphase == BroadphaseType::SPATIAL_HASH_GRID) {
+        //同じセルに入っているペアだけ詳細判定を行う
+        mGrid.computePairs(mCandidatePairs);
+    } else {
+        //全軸で重なっているペアだけ詳細判定を行う
+        mSweepAndPrune.update();
+        mSweepAndPrune.computePairs(mCandidatePairs);
+    }
+
+    //判定しないレイヤー同士のペアは形状を調べる前に除く
+    mCandidatePairs.erase(std::remove_if(mCandidatePairs.begin(), mCandidatePairs.end(), [&](const std::pair<unsigned, unsigned>& pair) {
+        return !shouldCollide(mProxies[pair.first], mProxies[pair.second]);
+    }), mCandidatePairs.end());
+
+    narrowphase();
+}
+
+BroadphaseType Physics::getBroadphaseType() const {
+    return mBroadphase;
+}
+
+Physics::CollSpan Physics::getContacts(unsigned proxyID, CollisionEvent event) const {
+    const auto& events = mContactEvents[static_cast<int>(event)];
+    auto range = std::equal_range(events.contacts.begin(), events.contacts.end(), Contact{ proxyID, 0 }, [](const Contact& a, const Contact& b) {
+        return a.self < b.self;
+    });
+
+    auto first = static_cast<size_t>(range.first - events.contacts.begin());
+    auto count = static_cast<size_t>(range.second - range.first);
+    return CollSpan(events.colliders.data() + first, count);
+}
+
+void Physics::overlap(const AABB& aabb, CollPtrArray& out, unsigned layerMask) const {
+    std::vector<unsigned> candidates;
+    mTree.query(aabb, candidates);
+
+    //木は広げたAABBを持っているので実際の境界ボックスで確かめる
+    for (const auto& id : candidates) {
+        const auto& proxy = mProxies[id];
+        if (!(proxy.layerBit & layerMask)) {
+            continue;
+        }
+        if (Intersect::intersectAABB(proxy.aabb, aabb)) {
+            out.emplace_back(proxy.collider);
+        }
+    }
+}
+
+bool Physics::raycast(const Ray& ray, CollPtr& outCollider, Vector3& outPoint, unsigned layerMask) const {
+    std::vector<unsigned> candidates;
+    mTree.raycast(ray, candidates);
+
+    auto nearestDistSq = Math::infinity;
+    Vector3 point;
+    for (const auto& id : candidates) {
+        if (!(mProxies[id].layerBit & layerMask)) {
+            continue;
+        }
+        const auto& collider = mProxies[id].collider;
+        if (!collider->getEnable()) {
+            continue;
+        }
+        if (!intersectRayCollider(ray, *collider, point)) {
+            continue;
+        }
+
+        auto distSq = (point - ray.start).lengthSq();
+        if (distSq < nearestDistSq) {
+            nearestDistSq = distSq;
+            outCollider = collider;
+            outPoint = point;
+        }
+    }
+
+    return (nearestDistSq < Math::infinity);
+}
+
+std::shared_ptr<Collider> Physics::nearest(const Vector3& point, unsigned layerMask) const {
+    unsigned id = 0;
+    auto found = mTree.queryNearest(point, [&](unsigned userID) {
+        //対象外のレイヤーは無限遠にあるものとして扱う
+        const auto& proxy = mProxies[userID];
+        if (!(proxy.layerBit & layerMask)) {
+            return Math::infinity;
+        }
+        return proxy.aabb.minDistanceSquare(point);
+    }, id);
+
+    return (found) ? mProxies[id].collider : nullptr;
+}
+
+bool Physics::sweep(const Sphere& sphere, const Vector3& move, CollPtr& outCollider, float& outT, unsigned layerMask) const {
+    auto extents = Vector3::one * sphere.radius;
+    AABB swept(sphere.center - extents, sphere.center + extents);
+    swept = AABB::combine(swept, AABB(swept.min + move, swept.max + move));
+    return sweepBroadphase(swept, layerMask, [&](const Collider& collider, float& t) {
+        return sweepSphereCollider(sphere, move, collider, t);
+    }, outCollider, outT);
+}
+
+bool Physics::sweep(const AABB& aabb, const Vector3& move, CollPtr& outCollider, float& outT, unsigned layerMask) const {
+    auto swept = AABB::combine(aabb, AABB(aabb.min + move, aabb.max + move));
+    return sweepBroadphase(swept, layerMask, [&](const Collider& collider, float& t) {
+        return sweepAABBCollider(aabb, move, collider, t);
+    }, outCollider, outT);
+}
+
+bool Physics::sweepBroadphase(const AABB& sweptAABB, unsigned layerMask, const std::function<bool(const Collider&, float&)>& sweepCollider, CollPtr& outCollider, float& outT) const {
+    //移動範囲全体を囲むAABBで木から候補を絞る
+    std::vector<unsigned> candidates;
+    mTree.query(sweptAABB, candidates);
+
+    auto nearestT = Math::infinity;
+    float t = 0.f;
+    for (const auto& id : candidates) {
+        if (!(mProxies[id].layerBit & layerMask)) {
+            continue;
+        }
+        const auto& collider = mProxies[id].collider;
+        if (!collider->getEnable()) {
+            continue;
+        }
+        if (!sweepCollider(*collider, t)) {
+            continue;
+        }
+
+        if (t < nearestT) {
+            nearestT = t;
+            outCollider = collider;
+        }
+    }
+
+    if (nearestT == Math::infinity) {
+        return false;
+    }
+    outT = nearestT;
+    return true;
+}
+
+void Physics::updateDirtyBounds() {
+    if (mDirtyProxies.empty()) {
         return;
     }
 
-    //center.x - mCenter.radiusが小さい順にソート
-    //std::sort(mColliders.begin(), mColliders.end(), [](CollPtr a, CollPtr b) {
-    //    auto circleA = std::dynamic_pointer_cast<SphereCollider>(a);
-    //    auto circleB = std::dynamic_pointer_cast<SphereCollider>(b);
-    //    return circleA->getSphere().center.x - circleA->getSphere().radius < circleB->getSphere().center.x - circleB->getSphere().radius;
-    //});
-
-    //for (size_t i = 0; i < mColliders.size(); i++) {
-    //    auto a = std::dynamic_pointer_cast<SphereCollider>(mColliders[i]);
-    //    if (!a->getEnable()) {
-    //        continue;
-    //    }
-    //    const auto& as = a->getSphere();
-    //    //mCircles[i]の中心+半径を取得
-    //    float max = as.center.x + as.radius;
-    //    for (size_t j = i + 1; j < mColliders.size(); j++) {
-    //        auto b = std::dynamic_pointer_cast<SphereCollider>(mColliders[j]);
-    //        if (!b->getEnable()) {
-    //            continue;
-    //        }
-    //        const auto& bs = b->getSphere();
-    //        //もしmCircles[j]の中心-半径が、mCircles[i]の中心+半径を超えていたら、
-    //        //mCircles[i]と交差する可能性があるボックスは存在しない
-    //        if (bs.center.x - bs.radius > max) {
-    //            break;
-    //        } else if (Intersect::intersectSphere(as, bs)) {
-    //            a->addHitCollider(b);
-    //            b->addHitCollider(a);
-    //        }
-    //    }
-    //}
+    //登録後に削除されたプロキシを除きながら、変換に必要な値を詰める
+    mLocalBounds.clear();
+    mWorldMatrices.clear();
+    size_t count = 0;
+    for (const auto& id : mDirtyProxies) {
+        const auto& collider = mProxies[id].collider;
+        if (!collider || collider->getType() != ColliderType::AABB) {
+            continue;
+        }
+        const auto& aabbCollider = static_cast<const AABBCollider&>(*collider);
+        mLocalBounds.add(aabbCollider.getLocalAABB());
+        mWorldMatrices.emplace_back(aabbCollider.transform().getWorldTransform());
+        mDirtyProxies[count++] = id;
+    }
+    mDirtyProxies.resize(count);
+
+    mLocalBounds.transform(mWorldMatrices, mWorldBounds);
+
+    //コライダー側のAABBと可視化もここで最新にする
+    for (size_t i = 0; i < count; ++i) {
+        auto id = mDirtyProxies[i];
+        auto aabb = mWorldBounds.get(i);
+        static_cast<AABBCollider&>(*mProxies[id].collider).applyWorldAABB(aabb);
+        move(id, aabb);
+    }
+    mDirtyProxies.clear();
+}
+
+unsigned long long Physics::makePairKey(unsigned a, unsigned b) {
+    if (a > b) {
+        std::swap(a, b);
+    }
+    return (static_cast<unsigned long long>(a) << 32) | b;
+}
+
+bool Physics::shouldCollide(const Proxy& a, const Proxy& b) {
+    return (a.layerBit & b.collisionMask) && (b.layerBit & a.collisionMask);
+}
+
+void Physics::narrowphase() {
+    mContactBuffers.resize(mThreadPool.getThreadCount());
+    for (auto&& buffer : mContactBuffers) {
+        buffer.clear();
+    }
+
+    //ペアごとの判定は互いに依存しないので、結果をスレッドごとのバッファに溜める
+    mThreadPool.parallelFor(mCandidatePairs.size(), MIN_PAIRS_PER_THREAD, [&](size_t begin, size_t end, unsigned threadIndex) {
+        auto& buffer = mContactBuffers[threadIndex];
+        for (auto i = begin; i < end; ++i) {
+            const auto& pair = mCandidatePairs[i];
+            const auto& a = *mProxies[pair.first].collider;
+            const auto& b = *mProxies[pair.second].collider;
+            if (!a.getEnable() || !b.getEnable()) {
+                continue;
+            }
+            if (intersectCollider(a, b)) {
+                buffer.emplace_back(pair);
+            }
+        }
+    });
+
+    //前フレームの接触と入れ替えて、スレッドごとの結果を繋げる
+    std::swap(mPreviousContacts, mContacts);
+    mContacts.clear();
+    for (const auto& buffer : mContactBuffers) {
+        for (const auto& pair : buffer) {
+            mContacts.emplace_back(makePairKey(pair.first, pair.second));
+        }
+    }
+    std::sort(mContacts.begin(), mContacts.end());
+
+    updateContactEvents();
+}
+
+void Physics::updateContactEvents() {
+    for (auto&& events : mContactEvents) {
+        events.contacts.clear();
+    }
+
+    //どちらも整列済みなので1回の走査で振り分けられる
+    size_t prev = 0;
+    size_t cur = 0;
+    while (prev < mPreviousContacts.size() || cur < mContacts.size()) {
+        if (cur == mContacts.size() || (prev < mPreviousContacts.size() && mPreviousContacts[prev] < mContacts[cur])) {
+            addContactEvent(CollisionEvent::EXIT, mPreviousContacts[prev]);
+            ++prev;
+        } else if (prev == mPreviousContacts.size() || mContacts[cur] < mPreviousContacts[prev]) {
+            addContactEvent(CollisionEvent::ENTER, mContacts[cur]);
+            ++cur;
+        } else {
+            addContactEvent(CollisionEvent::STAY, mContacts[cur]);
+            ++prev;
+            ++cur;
+        }
+    }
+
+    //プロキシごとに取り出せるように並べ、相手のコライダーを引いておく
+    for (auto&& events : mContactEvents) {
+        auto& contacts = events.contacts;
+        std::sort(contacts.begin(), contacts.end(), [](const Contact& a, const Contact& b) {
+            return (a.self == b.self) ? a.other < b.other : a.self < b.self;
+        });
+
+        events.colliders.resize(contacts.size());
+        for (size_t i = 0; i < contacts.size(); ++i) {
+            events.colliders[i] = mProxies[contacts[i].other].collider.get();
+        }
+    }
+}
+
+void Physics::addContactEvent(CollisionEvent event, unsigned long long key) {
+    auto a = static_cast<unsigned>(key >> 32);
+    auto b = static_cast<unsigned>(key & 0xffffffff);
+    auto& contacts = mContactEvents[static_cast<int>(event)].contacts;
+    contacts.emplace_back(Contact{ a, b });
+    contacts.emplace_back(Contact{ b, a });
+}
+
+bool Physics::intersectRayCollider(const Ray& ray, const Collider& collider, Vector3& outPoint) {
+    auto type = collider.getType();
+    if (type == ColliderType::AABB) {
+        return Intersect::intersectRayAABB(ray, static_cast<const AABBCollider&>(collider).getAABB(), outPoint);
+    }
+    if (type == ColliderType::SPHERE) {
+        return Intersect::intersectRaySphere(ray, static_cast<const SphereCollider&>(collider).getSphere(), outPoint);
+    }
+    if (type == ColliderType::OBB) {
+        return Intersect::intersectRayOBB(ray, static_cast<const OBBCollider&>(collider).getOBB(), outPoint);
+    }
+
+    //2Dのコライダーはレイの対象外
+    return false;
+}
+
+bool Physics::sweepSphereCollider(const Sphere& sphere, const Vector3& move, const Collider& collider, float& outT) {
+    auto type = collider.getType();
+    if (type == ColliderType::AABB) {
+        return Intersect::sweepSphereAABB(sphere, move, static_cast<const AABBCollider&>(collider).getAABB(), outT);
+    }
+    if (type == ColliderType::SPHERE) {
+        return Intersect::sweepSphereSphere(sphere, move, static_cast<const SphereCollider&>(collider).getSphere(), outT);
+    }
+    if (type == ColliderType::OBB) {
+        return Intersect::sweepSphereOBB(sphere, move, static_cast<const OBBCollider&>(collider).getOBB(), outT);
+    }
+
+    //2Dのコライダーはスイープの対象外
+    return false;
+}
+
+bool Physics::sweepAABBCollider(const AABB& aabb, const Vector3& move, const Collider& collider, float& outT) {
+    auto type = collider.getType();
+    if (type == ColliderType::AABB) {
+        return Intersect::sweepAABBAABB(aabb, move, static_cast<const AABBCollider&>(collider).getAABB(), outT);
+    }
+    if (type == ColliderType::SPHERE) {
+        return Intersect::sweepAABBSphere(aabb, move, static_cast<const SphereCollider&>(collider).getSphere(), outT);
+    }
+    if (type == ColliderType::OBB) {
+        return Intersect::sweepAABBOBB(aabb, move, static_cast<const OBBCollider&>(collider).getOBB(), outT);
+    }
+
+    //2Dのコライダーはスイープの対象外
+    return false;
+}
+
+bool Physics::intersectCollider(const Collider& a, const Collider& b) {
+    auto typeA = a.getType();
+    auto typeB = b.getType();
+
+    //組み合わせを減らすために種類の順に並べる
+    if (typeA > typeB) {
+        return intersectCollider(b, a);
+    }
+
+    if (typeA == ColliderType::AABB) {
+        const auto& aabb = static_cast<const AABBCollider&>(a).getAABB();
+        if (typeB == ColliderType::AABB) {
+            return Intersect::intersectAABB(aabb, static_cast<const AABBCollider&>(b).getAABB());
+        }
+        if (typeB == ColliderType::SPHERE) {
+            return Intersect::intersectSphereAABB(static_cast<const SphereCollider&>(b).getSphere(), aabb);
+        }
+        if (typeB == ColliderType::OBB) {
+            return Intersect::intersectOBBAABB(static_cast<const OBBCollider&>(b).getOBB(), aabb);
+        }
+    } else if (typeA == ColliderType::SPHERE) {
+        const auto& sphere = static_cast<const SphereCollider&>(a).getSphere();
+        if (typeB == ColliderType::SPHERE) {
+            return Intersect::intersectSphere(sphere, static_cast<const SphereCollider&>(b).getSphere());
+        }
+        if (typeB == ColliderType::OBB) {
+            return Intersect::intersectSphereOBB(sphere, static_cast<const OBBCollider&>(b).getOBB());
+        }
+    } else if (typeA == ColliderType::CIRCLE) {
+        if (typeB == ColliderType::CIRCLE) {
+            return Intersect::intersectCircle(
+                static_cast<const CircleCollider&>(a).getCircle(),
+                static_cast<const CircleCollider&>(b).getCircle()
+            );
+        }
+    } else if (typeA == ColliderType::OBB) {
+        if (typeB == ColliderType::OBB) {
+            return Intersect::intersectOBB(
+                static_cast<const OBBCollider&>(a).getOBB(),
+                static_cast<const OBBCollider&>(b).getOBB()
+            );
+        }
+    }
+
+    //2Dと3Dのコライダー同士は判定しない
+    return false;
 }
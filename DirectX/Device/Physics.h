@@ -1,25 +1,172 @@
 ﻿#pragma once
 
+#include "../Collision/AABB.h"
+#include "../Collision/AABBArray.h"
+#include "../Collision/CollisionLayer.h"
+#include "../Collision/DynamicAABBTree.h"
+#include "../Collision/Ray.h"
+#include "../Collision/Sphere.h"
+#include "../Collision/SpatialHashGrid.h"
+#include "../Collision/SweepAndPrune.h"
+#include "../Utility/Span.h"
+#include <rapidjson/document.h>
+#include <array>
+#include <functional>
 #include <memory>
+#include <utility>
 #include <vector>
 
 class Collider;
+class ThreadPool;
+
+//ペアを探すブロードフェーズの種類
+enum class BroadphaseType {
+    //軸ごとに端点を並べる 大きさや配置がばらばらな場面向け
+    SWEEP_AND_PRUNE,
+    //一様グリッド 大きさの揃ったオブジェクトが大量にある場面向け
+    SPATIAL_HASH_GRID
+};
+
+//接触の変化の種類
+enum class CollisionEvent {
+    //このフレームで接触し始めた
+    ENTER,
+    //前フレームから接触し続けている
+    STAY,
+    //このフレームで離れた
+    EXIT
+};
 
 class Physics {
     using CollPtr = std::shared_ptr<Collider>;
     using CollPtrArray = std::vector<CollPtr>;
+    using PairArray = std::vector<std::pair<unsigned, unsigned>>;
+    using CollSpan = Span<Collider* const>;
+
+    //ブロードフェーズで管理するコライダー情報
+    struct Proxy {
+        CollPtr collider;
+        AABB aabb;
+        //動的AABB木の葉番号
+        int treeProxy;
+        //グリッドのプロキシ番号
+        int gridProxy;
+        //Sweep and Pruneのプロキシ番号
+        int sapProxy;
+        //所属するレイヤーのビットと、判定するレイヤーのマスク
+        unsigned layerBit;
+        unsigned collisionMask;
+    };
+
+    //接触しているプロキシの組
+    struct Contact {
+        unsigned self;
+        unsigned other;
+    };
+
+    //接触の変化ごとの一覧
+    //selfの順に並べ、プロキシごとの範囲を二分探索で取り出す
+    struct ContactEvents {
+        std::vector<Contact> contacts;
+        //contactsのotherのコライダー 同じ順に並ぶ
+        std::vector<Collider*> colliders;
+    };
+
+    //動的AABB木・グリッド・Sweep and Pruneに未登録
+    static constexpr int NULL_TREE_PROXY = -1;
+    static constexpr int NULL_GRID_PROXY = -1;
+    static constexpr int NULL_SAP_PROXY = -1;
+    //詳細判定を分割するときの1スレッドあたりの最小ペア数
+    static constexpr size_t MIN_PAIRS_PER_THREAD = 64;
 
 public:
-    Physics();
+    //詳細判定はシーン全体で共有するスレッドプールで並列に行う
+    Physics(ThreadPool& threadPool);
     ~Physics();
-    //コライダーの追加・削除
-    void add(const CollPtr& collider);
-    void remove(const CollPtr& collider);
+    void loadProperties(const rapidjson::Value& inObj);
+    //コライダーを追加してプロキシ番号を返す
+    unsigned add(const CollPtr& collider);
+    //コライダーを削除する
+    void remove(unsigned proxyID);
+    //コライダーの境界ボックスを更新する
+    void move(unsigned proxyID, const AABB& aabb);
+    //次のsweepAndPruneの前に、AABBコライダーの境界ボックスをワールド行列からまとめて求める
+    void markBoundsDirty(unsigned proxyID);
+    //コライダーのレイヤーとマスクを更新する
+    void setFilter(unsigned proxyID, unsigned layerBit, unsigned collisionMask);
     //全削除
     void clear();
-    //総当たり判定
+    //ブロードフェーズで絞り込んだペアの総当たり判定
     void sweepAndPrune();
+    //使用中のブロードフェーズ
+    BroadphaseType getBroadphaseType() const;
+    //プロキシと接触しているコライダーを変化の種類ごとに取得する
+    //次のsweepAndPruneまでの間だけ有効
+    CollSpan getContacts(unsigned proxyID, CollisionEvent event) const;
+
+    //以下の検索はlayerMaskにビットが立っているレイヤーのコライダーだけを対象にする
+    //境界ボックスがAABBと重なるコライダーをすべて取得する
+    void overlap(const AABB& aabb, CollPtrArray& out, unsigned layerMask = CollisionLayer::ALL) const;
+    //レイと衝突するコライダーのうち、始点から最も近いものを取得する
+    bool raycast(const Ray& ray, CollPtr& outCollider, Vector3& outPoint, unsigned layerMask = CollisionLayer::ALL) const;
+    //点から境界ボックスが最も近いコライダーを取得する
+    CollPtr nearest(const Vector3& point, unsigned layerMask = CollisionLayer::ALL) const;
+    //球・AABBをmoveだけ動かしたときに最初に接触するコライダーと、その位置 [0, 1] を取得する
+    bool sweep(const Sphere& sphere, const Vector3& move, CollPtr& outCollider, float& outT, unsigned layerMask = CollisionLayer::ALL) const;
+    bool sweep(const AABB& aabb, const Vector3& move, CollPtr& outCollider, float& outT, unsigned layerMask = CollisionLayer::ALL) const;
+
+private:
+    //markBoundsDirtyで登録されたAABBコライダーをまとめてワールド空間に変換する
+    void updateDirtyBounds();
+    //候補ペアの詳細判定を並列に行い、このフレームの接触を求める
+    void narrowphase();
+    //前フレームとこのフレームの接触を突き合わせて、変化の種類ごとに振り分ける
+    void updateContactEvents();
+    //ペアを変化の一覧に両方向で追加する
+    void addContactEvent(CollisionEvent event, unsigned long long key);
+    //2つのプロキシ番号から順序によらないキーを作る
+    static unsigned long long makePairKey(unsigned a, unsigned b);
+    //互いのマスクに相手のレイヤーが含まれているか
+    static bool shouldCollide(const Proxy& a, const Proxy& b);
+    //コライダーの種類に応じたレイとの判定
+    static bool intersectRayCollider(const Ray& ray, const Collider& collider, Vector3& outPoint);
+    //コライダーの種類に応じた詳細判定
+    static bool intersectCollider(const Collider& a, const Collider& b);
+    //移動範囲と境界ボックスが重なるコライダーから、最初に接触するものを探す
+    //sweepColliderでコライダーの種類ごとの接触位置を求める
+    bool sweepBroadphase(const AABB& sweptAABB, unsigned layerMask, const std::function<bool(const Collider&, float&)>& sweepCollider, CollPtr& outCollider, float& outT) const;
+    //コライダーの種類に応じたスイープ判定
+    static bool sweepSphereCollider(const Sphere& sphere, const Vector3& move, const Collider& collider, float& outT);
+    static bool sweepAABBCollider(const AABB& aabb, const Vector3& move, const Collider& collider, float& outT);
 
 private:
-    CollPtrArray mColliders;
+    //プロキシ配列 削除された要素は再利用する
+    std::vector<Proxy> mProxies;
+    //空いているプロキシ番号
+    std::vector<unsigned> mFreeProxies;
+    //空間検索用の動的AABB木
+    DynamicAABBTree mTree;
+    //ブロードフェーズの種類 コライダーを追加する前に決める
+    BroadphaseType mBroadphase;
+    //Sweep and Pruneのブロードフェーズ
+    SweepAndPrune mSweepAndPrune;
+    //グリッドのブロードフェーズ
+    SpatialHashGrid mGrid;
+    //ブロードフェーズで見つかった候補ペア 毎フレーム作り直す
+    PairArray mCandidatePairs;
+    //スレッドごとの衝突したペア
+    std::vector<PairArray> mContactBuffers;
+    //詳細判定用のワーカー 所有はSceneManager
+    ThreadPool& mThreadPool;
+    //このフレームと前フレームで接触しているペア 整列済み
+    std::vector<unsigned long long> mContacts;
+    std::vector<unsigned long long> mPreviousContacts;
+    //変化の種類ごとの接触
+    std::array<ContactEvents, 3> mContactEvents;
+    //境界ボックスの更新待ちのプロキシ番号
+    std::vector<unsigned> mDirtyProxies;
+    //更新待ちのコライダーのローカルAABBとワールド行列、変換結果 mDirtyProxiesと同じ並び
+    AABBArray mLocalBounds;
+    std::vector<Matrix4> mWorldMatrices;
+    AABBArray mWorldBounds;
 };
@@ -0,0 +1,101 @@
+﻿#include "ThreadPool.h"
+#include <algorithm>
+
+ThreadPool::ThreadPool(unsigned workerCount) :
+    mTask(nullptr),
+    mCount(0),
+    mActiveThreadCount(0),
+    mPendingCount(0),
+    mGeneration(0),
+    mQuit(false) {
+    //呼び出し元のスレッドも処理に加わるので1つ少なく作る
+    if (workerCount == 0) {
+        auto hardwareCount = std::thread::hardware_concurrency();
+        workerCount = (hardwareCount > 1) ? hardwareCount - 1 : 0;
+    }
+
+    for (unsigned i = 0; i < workerCount; ++i) {
+        mWorkers.emplace_back(&ThreadPool::workerLoop, this, i + 1);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mQuit = true;
+    }
+    mStartCondition.notify_all();
+
+    for (auto&& worker : mWorkers) {
+        worker.join();
+    }
+}
+
+unsigned ThreadPool::getThreadCount() const {
+    return static_cast<unsigned>(mWorkers.size()) + 1;
+}
+
+void ThreadPool::parallelFor(size_t count, size_t minCountPerThread, const Task& task) {
+    if (count == 0) {
+        return;
+    }
+
+    auto threadCount = static_cast<unsigned>(std::min<size_t>(getThreadCount(), std::max<size_t>(count / std::max<size_t>(minCountPerThread, 1), 1)));
+    //分ける必要がなければ呼び出し元だけで処理する
+    if (threadCount == 1) {
+        task(0, count, 0);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mTask = &task;
+        mCount = count;
+        mActiveThreadCount = threadCount;
+        mPendingCount = threadCount - 1;
+        ++mGeneration;
+    }
+    mStartCondition.notify_all();
+
+    //呼び出し元のスレッドは0番として処理する
+    runRange(0);
+
+    std::unique_lock<std::mutex> lock(mMutex);
+    mFinishCondition.wait(lock, [&] { return mPendingCount == 0; });
+    mTask = nullptr;
+}
+
+void ThreadPool::workerLoop(unsigned threadIndex) {
+    unsigned generation = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mStartCondition.wait(lock, [&] { return mQuit || mGeneration != generation; });
+            if (mQuit) {
+                return;
+            }
+            generation = mGeneration;
+
+            //今回の処理に使われないスレッド
+            if (threadIndex >= mActiveThreadCount) {
+                continue;
+            }
+        }
+
+        runRange(threadIndex);
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            --mPendingCount;
+        }
+        mFinishCondition.notify_one();
+    }
+}
+
+void ThreadPool::runRange(unsigned threadIndex) {
+    auto begin = mCount * threadIndex / mActiveThreadCount;
+    auto end = mCount * (threadIndex + 1) / mActiveThreadCount;
+    if (begin < end) {
+        (*mTask)(begin, end, threadIndex);
+    }
+}
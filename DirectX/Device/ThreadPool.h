@@ -0,0 +1,48 @@
+﻿#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//常駐させたワーカースレッドで範囲を分割して処理する
+//範囲はスレッド番号順に連続して割り当てるので、スレッドごとの結果を番号順に繋げれば逐次処理と同じ順序になる
+class ThreadPool {
+    //[begin, end)の範囲をthreadIndex番のスレッドで処理する
+    using Task = std::function<void(size_t begin, size_t end, unsigned threadIndex)>;
+
+public:
+    //workerCountが0ならCPUのスレッド数から決める
+    ThreadPool(unsigned workerCount = 0);
+    ~ThreadPool();
+    //呼び出し元を含めた最大スレッド数
+    unsigned getThreadCount() const;
+    //[0, count)を分割して並列に処理し、全スレッドの終了を待つ
+    //1スレッドあたりminCountPerThread個未満にならないように使うスレッド数を減らす
+    void parallelFor(size_t count, size_t minCountPerThread, const Task& task);
+
+private:
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void workerLoop(unsigned threadIndex);
+    //threadIndex番のスレッドの担当範囲を処理する
+    void runRange(unsigned threadIndex);
+
+private:
+    std::vector<std::thread> mWorkers;
+    std::mutex mMutex;
+    std::condition_variable mStartCondition;
+    std::condition_variable mFinishCondition;
+    //実行中の処理
+    const Task* mTask;
+    size_t mCount;
+    //今回の処理に使うスレッド数
+    unsigned mActiveThreadCount;
+    //処理が終わっていないワーカー数
+    unsigned mPendingCount;
+    //処理を発行するたびに増やす
+    unsigned mGeneration;
+    bool mQuit;
+};
@@ -26,8 +26,6 @@ void GameObject::update() {
 void GameObject::lateUpdate() {
     if (getActive()) {
         mComponentManager->lateUpdate();
-
-        mTransform->computeWorldTransform();
     }
 }
 
@@ -13,6 +13,7 @@
 #include "../Component/CollideOperation/MeshAdder.h"
 #include "../Component/Collider/AABBCollider.h"
 #include "../Component/Collider/CircleCollider.h"
+#include "../Component/Collider/OBBCollider.h"
 #include "../Component/Collider/SphereCollider.h"
 #include "../Component/Light/DirectionalLight.h"
 #include "../Component/Light/PointLightComponent.h"
@@ -59,6 +60,7 @@ GameObjectFactory::GameObjectFactory() {
 
     ADD_COMPONENT(AABBCollider);
     ADD_COMPONENT(CircleCollider);
+    ADD_COMPONENT(OBBCollider);
     ADD_COMPONENT(SphereCollider);
 
     ADD_COMPONENT(DirectionalLight);
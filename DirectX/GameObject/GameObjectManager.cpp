@@ -2,6 +2,7 @@
 #include "GameObject.h"
 #include "../DebugLayer/DebugUtility.h"
 #include "../DebugLayer/Hierarchy.h"
+#include "../Transform/TransformPool.h"
 #include "../Utility/LevelLoader.h"
 #include "../Utility/StringUtil.h"
 #include <algorithm>
@@ -24,6 +25,8 @@ void GameObjectManager::update() {
     for (const auto& gameObject : mGameObjects) {
         gameObject->lateUpdate();
     }
+    //全トランスフォームのワールド行列を深さ順にまとめて更新する
+    TransformPool::instance().computeWorldTransforms();
     mUpdatingGameObjects = false;
 
     movePendingToMain();
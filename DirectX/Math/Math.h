@@ -10,14 +10,14 @@
 #include "Vector4.h"
 
 namespace ColorPalette {
-    static const Vector3 black(0.f, 0.f, 0.f);
-    static const Vector3 white(1.f, 1.f, 1.f);
-    static const Vector3 red(1.f, 0.f, 0.f);
-    static const Vector3 green(0.f, 1.f, 0.f);
-    static const Vector3 blue(0.f, 0.f, 1.f);
-    static const Vector3 yellow(1.f, 1.f, 0.f);
-    static const Vector3 lightYellow(1.f, 1.f, 0.88f);
-    static const Vector3 lightBlue(0.68f, 0.85f, 0.9f);
-    static const Vector3 lightPink(1.f, 0.71f, 0.76f);
-    static const Vector3 lightGreen(0.56f, 0.93f, 0.56f);
+    inline constexpr Vector3 black(0.f, 0.f, 0.f);
+    inline constexpr Vector3 white(1.f, 1.f, 1.f);
+    inline constexpr Vector3 red(1.f, 0.f, 0.f);
+    inline constexpr Vector3 green(0.f, 1.f, 0.f);
+    inline constexpr Vector3 blue(0.f, 0.f, 1.f);
+    inline constexpr Vector3 yellow(1.f, 1.f, 0.f);
+    inline constexpr Vector3 lightYellow(1.f, 1.f, 0.88f);
+    inline constexpr Vector3 lightBlue(0.68f, 0.85f, 0.9f);
+    inline constexpr Vector3 lightPink(1.f, 0.71f, 0.76f);
+    inline constexpr Vector3 lightGreen(0.56f, 0.93f, 0.56f);
 }
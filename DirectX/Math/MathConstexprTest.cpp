@@ -0,0 +1,122 @@
+﻿#include "Math.h"
+
+//数学ライブラリの定数式で使える部分をコンパイル時に検証する
+//このファイルはコードを生成しない 検証に失敗するとビルドが止まる
+
+namespace {
+    constexpr bool equal(const Vector2& a, const Vector2& b) {
+        return (a.x == b.x && a.y == b.y);
+    }
+
+    constexpr bool equal(const Vector3& a, const Vector3& b) {
+        return (a.x == b.x && a.y == b.y && a.z == b.z);
+    }
+
+    constexpr bool equal(const Vector4& a, const Vector4& b) {
+        return (a.x == b.x && a.y == b.y && a.z == b.z && a.w == b.w);
+    }
+
+    constexpr bool equal(const Quaternion& a, const Quaternion& b) {
+        return (a.x == b.x && a.y == b.y && a.z == b.z && a.w == b.w);
+    }
+
+    constexpr bool equal(const Matrix4& a, const Matrix4& b) {
+        for (int i = 0; i < 4; ++i) {
+            for (int j = 0; j < 4; ++j) {
+                if (a.m[i][j] != b.m[i][j]) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    //複合代入演算子を定数式の中で使う
+    constexpr Vector3 accumulate() {
+        Vector3 v(1.f, 2.f, 3.f);
+        v += Vector3::one;
+        v -= Vector3(0.f, 1.f, 2.f);
+        v *= 2.f;
+        v *= Vector3(1.f, 0.5f, 0.25f);
+        v[2] = 4.f;
+        return v;
+    }
+
+    constexpr Vector2 accumulate2() {
+        Vector2 v;
+        v.set(1.f, 2.f);
+        v += Vector2::one;
+        v -= Vector2(1.f, 0.f);
+        v *= 3.f;
+        return v;
+    }
+
+    constexpr Quaternion conjugated(const Quaternion& q) {
+        Quaternion retVal = q;
+        retVal.conjugate();
+        return retVal;
+    }
+}
+
+//Vector2
+static_assert(equal(Vector2(), Vector2::zero), "Vector2 default is zero");
+static_assert(equal(Vector2(1.f, 2.f) + Vector2(3.f, 4.f), Vector2(4.f, 6.f)), "Vector2 +");
+static_assert(equal(Vector2(1.f, 2.f) - Vector2(3.f, 5.f), Vector2(-2.f, -3.f)), "Vector2 -");
+static_assert(equal(-Vector2::right, Vector2::left), "Vector2 negate");
+static_assert(equal(Vector2(1.f, 2.f) * Vector2(3.f, 4.f), Vector2(3.f, 8.f)), "Vector2 component-wise *");
+static_assert(equal(2.f * Vector2(1.f, 2.f), Vector2(1.f, 2.f) * 2.f), "Vector2 scalar *");
+static_assert(equal(Vector2(2.f, 4.f) / 2.f, Vector2(1.f, 2.f)), "Vector2 /");
+static_assert(equal(Vector2(2.f, 4.f) / 0.f, Vector2(2.f, 4.f)), "Vector2 / 0 returns the input");
+static_assert(equal(accumulate2(), Vector2(3.f, 9.f)), "Vector2 compound assignment");
+static_assert(Vector2::dot(Vector2(1.f, 2.f), Vector2(3.f, 4.f)) == 11.f, "Vector2 dot");
+static_assert(Vector2::cross(Vector2::right, Vector2::down) == 1.f, "Vector2 cross");
+static_assert(Vector2(3.f, 4.f).lengthSq() == 25.f, "Vector2 lengthSq");
+static_assert(equal(Vector2::up + Vector2::down, Vector2::zero), "Vector2 up is -y");
+
+//Vector3
+static_assert(equal(Vector3(), Vector3::zero), "Vector3 default is zero");
+static_assert(equal(Vector3(Vector2(1.f, 2.f), 3.f), Vector3(1.f, 2.f, 3.f)), "Vector3 from Vector2");
+static_assert(equal(Vector3::right + Vector3::up + Vector3::forward, Vector3::one), "Vector3 +");
+static_assert(equal(Vector3::zero - Vector3::one, Vector3::negOne), "Vector3 -");
+static_assert(equal(-Vector3::forward, Vector3::back), "Vector3 negate");
+static_assert(equal(Vector3(1.f, 2.f, 3.f) * Vector3(4.f, 5.f, 6.f), Vector3(4.f, 10.f, 18.f)), "Vector3 component-wise *");
+static_assert(equal(2.f * Vector3(1.f, 2.f, 3.f), Vector3(2.f, 4.f, 6.f)), "Vector3 scalar *");
+static_assert(equal(Vector3(1.f, 2.f, 3.f) * 2.f, Vector3(2.f, 4.f, 6.f)), "Vector3 scalar *");
+static_assert(equal(Vector3(2.f, 4.f, 6.f) / 2.f, Vector3(1.f, 2.f, 3.f)), "Vector3 /");
+static_assert(equal(Vector3::one / 0.f, Vector3::one), "Vector3 / 0 returns the input");
+static_assert(equal(accumulate(), Vector3(4.f, 2.f, 4.f)), "Vector3 compound assignment");
+static_assert(Vector3(1.f, 2.f, 3.f)[0] == 1.f && Vector3(1.f, 2.f, 3.f)[1] == 2.f && Vector3(1.f, 2.f, 3.f)[2] == 3.f, "Vector3 []");
+static_assert(Vector3::dot(Vector3(1.f, 2.f, 3.f), Vector3(4.f, 5.f, 6.f)) == 32.f, "Vector3 dot");
+static_assert(equal(Vector3::cross(Vector3::right, Vector3::up), Vector3::forward), "Vector3 cross is left-handed x cross y = z");
+static_assert(equal(Vector3::cross(Vector3::up, Vector3::right), Vector3::back), "Vector3 cross is anti-commutative");
+static_assert(Vector3(1.f, 2.f, 2.f).lengthSq() == 9.f, "Vector3 lengthSq");
+static_assert(Vector3::infinity.x == Math::infinity && Vector3::negInfinity.z == Math::negInfinity, "Vector3 infinity");
+static_assert(equal(ColorPalette::red + ColorPalette::green, ColorPalette::yellow), "ColorPalette");
+
+//Vector4
+static_assert(equal(Vector4(), Vector4(0.f, 0.f, 0.f, 0.f)), "Vector4 default is zero");
+static_assert(equal(Vector4(Vector3(1.f, 2.f, 3.f), 1.f), Vector4(1.f, 2.f, 3.f, 1.f)), "Vector4 from Vector3");
+
+//Quaternion
+static_assert(equal(Quaternion(), Quaternion::identity), "Quaternion default is identity");
+static_assert(Quaternion::identity.lengthSq() == 1.f, "Quaternion identity is unit");
+static_assert(Quaternion::dot(Quaternion(1.f, 2.f, 3.f, 4.f), Quaternion(5.f, 6.f, 7.f, 8.f)) == 70.f, "Quaternion dot");
+static_assert(equal(conjugated(Quaternion(1.f, 2.f, 3.f, 4.f)), Quaternion(-1.f, -2.f, -3.f, 4.f)), "Quaternion conjugate");
+static_assert(equal(Quaternion::concatenate(Quaternion::identity, Quaternion(1.f, 2.f, 3.f, 4.f)), Quaternion(1.f, 2.f, 3.f, 4.f)), "Quaternion identity is neutral");
+static_assert(equal(Quaternion::concatenate(Quaternion(1.f, 2.f, 3.f, 4.f), Quaternion::identity), Quaternion(1.f, 2.f, 3.f, 4.f)), "Quaternion identity is neutral");
+//q * conjugate(q) = |q|^2
+static_assert(equal(Quaternion::concatenate(Quaternion(1.f, 2.f, 3.f, 4.f), conjugated(Quaternion(1.f, 2.f, 3.f, 4.f))), Quaternion(0.f, 0.f, 0.f, 30.f)), "Quaternion concatenate with conjugate");
+//z軸180度回転をx軸180度回転の後に掛けるとy軸180度回転になる
+static_assert(equal(Quaternion::concatenate(Quaternion(1.f, 0.f, 0.f, 0.f), Quaternion(0.f, 0.f, 1.f, 0.f)), Quaternion(0.f, 1.f, 0.f, 0.f)), "Quaternion concatenate order");
+
+//Matrix4
+static_assert(equal(Matrix4(), Matrix4::identity), "Matrix4 default is identity");
+static_assert(Matrix4::identity.m[0][0] == 1.f && Matrix4::identity.m[3][3] == 1.f && Matrix4::identity.m[0][1] == 0.f && Matrix4::identity.m[3][0] == 0.f, "Matrix4 identity");
+static_assert(equal(Matrix4::createScale(1.f), Matrix4::identity), "Matrix4 unit scale");
+static_assert(equal(Matrix4::createScale(Vector3(2.f, 3.f, 4.f)), Matrix4::createScale(2.f, 3.f, 4.f)), "Matrix4 createScale overloads");
+static_assert(Matrix4::createScale(2.f, 3.f, 4.f).m[1][1] == 3.f && Matrix4::createScale(2.f, 3.f, 4.f).m[2][2] == 4.f, "Matrix4 createScale diagonal");
+static_assert(equal(Matrix4::createTranslation(Vector3::zero), Matrix4::identity), "Matrix4 zero translation");
+static_assert(Matrix4::createTranslation(Vector3(1.f, 2.f, 3.f)).m[3][0] == 1.f && Matrix4::createTranslation(Vector3(1.f, 2.f, 3.f)).m[3][2] == 3.f, "Matrix4 translation is in the 4th row");
+static_assert(equal(Matrix4::createFromQuaternion(Quaternion::identity), Matrix4::identity), "Matrix4 identity rotation");
+//z軸180度回転はxとyを反転する
+static_assert(equal(Matrix4::createFromQuaternion(Quaternion(0.f, 0.f, 1.f, 0.f)), Matrix4::createScale(-1.f, -1.f, 1.f)), "Matrix4 from quaternion");
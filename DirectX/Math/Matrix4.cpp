@@ -1,19 +1,47 @@
 ﻿#include "Matrix4.h"
 #include "Math.h"
 #include "Quaternion.h"
+#include "SIMD.h"
 #include "Vector3.h"
 #include <memory>
 
-Matrix4::Matrix4() {
-    *this = Matrix4::identity;
-}
-
-Matrix4::Matrix4(float inMat[4][4]) {
-    memcpy(m, inMat, 16 * sizeof(float));
-}
-
 Matrix4 operator*(const Matrix4& a, const Matrix4& b) {
     Matrix4 retVal;
+#if defined(MATH_AVX)
+    //bの各行を上下のレーンに複製し、aの2行分をまとめて計算する
+    auto b0 = _mm_loadu_ps(b.m[0]);
+    auto b1 = _mm_loadu_ps(b.m[1]);
+    auto b2 = _mm_loadu_ps(b.m[2]);
+    auto b3 = _mm_loadu_ps(b.m[3]);
+    auto bb0 = _mm256_insertf128_ps(_mm256_castps128_ps256(b0), b0, 1);
+    auto bb1 = _mm256_insertf128_ps(_mm256_castps128_ps256(b1), b1, 1);
+    auto bb2 = _mm256_insertf128_ps(_mm256_castps128_ps256(b2), b2, 1);
+    auto bb3 = _mm256_insertf128_ps(_mm256_castps128_ps256(b3), b3, 1);
+
+    for (int i = 0; i < 4; i += 2) {
+        auto rows = _mm256_loadu_ps(a.m[i]);
+        auto r = _mm256_mul_ps(_mm256_shuffle_ps(rows, rows, _MM_SHUFFLE(0, 0, 0, 0)), bb0);
+        r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(rows, rows, _MM_SHUFFLE(1, 1, 1, 1)), bb1));
+        r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(rows, rows, _MM_SHUFFLE(2, 2, 2, 2)), bb2));
+        r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(rows, rows, _MM_SHUFFLE(3, 3, 3, 3)), bb3));
+        _mm256_storeu_ps(retVal.m[i], r);
+    }
+#elif defined(MATH_SSE)
+    //結果の各行はbの行をaの行の要素で重み付けした和になる
+    auto b0 = _mm_loadu_ps(b.m[0]);
+    auto b1 = _mm_loadu_ps(b.m[1]);
+    auto b2 = _mm_loadu_ps(b.m[2]);
+    auto b3 = _mm_loadu_ps(b.m[3]);
+
+    for (int i = 0; i < 4; ++i) {
+        auto row = _mm_loadu_ps(a.m[i]);
+        auto r = _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(0, 0, 0, 0)), b0);
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(1, 1, 1, 1)), b1));
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(2, 2, 2, 2)), b2));
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(3, 3, 3, 3)), b3));
+        _mm_storeu_ps(retVal.m[i], r);
+    }
+#else
     // row 0
     retVal.m[0][0] =
         a.m[0][0] * b.m[0][0] +
@@ -113,6 +141,7 @@ Matrix4 operator*(const Matrix4& a, const Matrix4& b) {
         a.m[3][1] * b.m[1][3] +
         a.m[3][2] * b.m[2][3] +
         a.m[3][3] * b.m[3][3];
+#endif // MATH_AVX
 
     return retVal;
 }
@@ -123,6 +152,17 @@ Matrix4& Matrix4::operator*=(const Matrix4& right) {
 }
 
 void Matrix4::transpose() {
+#ifdef MATH_SSE
+    auto r0 = _mm_loadu_ps(m[0]);
+    auto r1 = _mm_loadu_ps(m[1]);
+    auto r2 = _mm_loadu_ps(m[2]);
+    auto r3 = _mm_loadu_ps(m[3]);
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+    _mm_storeu_ps(m[0], r0);
+    _mm_storeu_ps(m[1], r1);
+    _mm_storeu_ps(m[2], r2);
+    _mm_storeu_ps(m[3], r3);
+#else
     float src[16];
 
     // Transpose matrix
@@ -156,9 +196,85 @@ void Matrix4::transpose() {
             m[i][j] = src[i * 4 + j];
         }
     }
+#endif // MATH_SSE
 }
 
 void Matrix4::inverse() {
+#ifdef MATH_SSE
+    //2x2の小行列に分けて余因子を求める
+    //M = | A B |
+    //    | C D |
+    auto r0 = _mm_loadu_ps(m[0]);
+    auto r1 = _mm_loadu_ps(m[1]);
+    auto r2 = _mm_loadu_ps(m[2]);
+    auto r3 = _mm_loadu_ps(m[3]);
+
+    auto A = _mm_movelh_ps(r0, r1);
+    auto B = _mm_movehl_ps(r1, r0);
+    auto C = _mm_movelh_ps(r2, r3);
+    auto D = _mm_movehl_ps(r3, r2);
+
+    //2x2の積 x * y
+    auto mat2Mul = [](__m128 x, __m128 y) {
+        return _mm_add_ps(
+            _mm_mul_ps(x, _mm_shuffle_ps(y, y, _MM_SHUFFLE(3, 0, 3, 0))),
+            _mm_mul_ps(_mm_shuffle_ps(x, x, _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps(y, y, _MM_SHUFFLE(1, 2, 1, 2)))
+        );
+    };
+    //2x2の余因子行列との積 adj(x) * y
+    auto mat2AdjMul = [](__m128 x, __m128 y) {
+        return _mm_sub_ps(
+            _mm_mul_ps(_mm_shuffle_ps(x, x, _MM_SHUFFLE(0, 0, 3, 3)), y),
+            _mm_mul_ps(_mm_shuffle_ps(x, x, _MM_SHUFFLE(2, 2, 1, 1)), _mm_shuffle_ps(y, y, _MM_SHUFFLE(1, 0, 3, 2)))
+        );
+    };
+    //2x2の余因子行列との積 x * adj(y)
+    auto mat2MulAdj = [](__m128 x, __m128 y) {
+        return _mm_sub_ps(
+            _mm_mul_ps(x, _mm_shuffle_ps(y, y, _MM_SHUFFLE(0, 3, 0, 3))),
+            _mm_mul_ps(_mm_shuffle_ps(x, x, _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps(y, y, _MM_SHUFFLE(1, 2, 1, 2)))
+        );
+    };
+
+    //各小行列の行列式 (|A|, |B|, |C|, |D|)
+    auto detSub = _mm_sub_ps(
+        _mm_mul_ps(_mm_shuffle_ps(r0, r2, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(r1, r3, _MM_SHUFFLE(3, 1, 3, 1))),
+        _mm_mul_ps(_mm_shuffle_ps(r0, r2, _MM_SHUFFLE(3, 1, 3, 1)), _mm_shuffle_ps(r1, r3, _MM_SHUFFLE(2, 0, 2, 0)))
+    );
+    auto detA = _mm_shuffle_ps(detSub, detSub, _MM_SHUFFLE(0, 0, 0, 0));
+    auto detB = _mm_shuffle_ps(detSub, detSub, _MM_SHUFFLE(1, 1, 1, 1));
+    auto detC = _mm_shuffle_ps(detSub, detSub, _MM_SHUFFLE(2, 2, 2, 2));
+    auto detD = _mm_shuffle_ps(detSub, detSub, _MM_SHUFFLE(3, 3, 3, 3));
+
+    auto adjDC = mat2AdjMul(D, C);
+    auto adjAB = mat2AdjMul(A, B);
+    //逆行列 = 1 / |M| * | X Y |
+    //                   | Z W |
+    auto X = _mm_sub_ps(_mm_mul_ps(detD, A), mat2Mul(B, adjDC));
+    auto W = _mm_sub_ps(_mm_mul_ps(detA, D), mat2Mul(C, adjAB));
+    auto Y = _mm_sub_ps(_mm_mul_ps(detB, C), mat2MulAdj(D, adjAB));
+    auto Z = _mm_sub_ps(_mm_mul_ps(detC, B), mat2MulAdj(A, adjDC));
+
+    //|M| = |A||D| + |B||C| - tr(adj(A)B adj(D)C)
+    auto tr = _mm_mul_ps(adjAB, _mm_shuffle_ps(adjDC, adjDC, _MM_SHUFFLE(3, 1, 2, 0)));
+    tr = _mm_add_ps(tr, _mm_movehl_ps(tr, tr));
+    tr = _mm_add_ps(tr, _mm_shuffle_ps(tr, tr, _MM_SHUFFLE(1, 1, 1, 1)));
+    tr = _mm_shuffle_ps(tr, tr, _MM_SHUFFLE(0, 0, 0, 0));
+    auto det = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC)), tr);
+
+    //余因子行列の符号をまとめて掛ける
+    auto invDet = _mm_div_ps(_mm_setr_ps(1.f, -1.f, -1.f, 1.f), det);
+    X = _mm_mul_ps(X, invDet);
+    Y = _mm_mul_ps(Y, invDet);
+    Z = _mm_mul_ps(Z, invDet);
+    W = _mm_mul_ps(W, invDet);
+
+    //余因子行列への並べ替えと格納を同時に行う
+    _mm_storeu_ps(m[0], _mm_shuffle_ps(X, Y, _MM_SHUFFLE(1, 3, 1, 3)));
+    _mm_storeu_ps(m[1], _mm_shuffle_ps(X, Y, _MM_SHUFFLE(0, 2, 0, 2)));
+    _mm_storeu_ps(m[2], _mm_shuffle_ps(Z, W, _MM_SHUFFLE(1, 3, 1, 3)));
+    _mm_storeu_ps(m[3], _mm_shuffle_ps(Z, W, _MM_SHUFFLE(0, 2, 0, 2)));
+#else
     // Thanks slow math
     // This is a really janky way to unroll everything...
     float tmp[12];
@@ -267,6 +383,7 @@ void Matrix4::inverse() {
             m[i][j] = dst[i * 4 + j];
         }
     }
+#endif // MATH_SSE
 }
 
 Matrix4 Matrix4::inverse(const Matrix4& right) {
@@ -275,6 +392,86 @@ Matrix4 Matrix4::inverse(const Matrix4& right) {
     return temp;
 }
 
+void Matrix4::inverseAffine() {
+    //左上3x3の逆行列は各行の外積を列に並べて行列式で割ったもの
+    //平行移動は逆行列を掛けて符号を反転する
+#ifdef MATH_SSE
+    auto r0 = _mm_loadu_ps(m[0]);
+    auto r1 = _mm_loadu_ps(m[1]);
+    auto r2 = _mm_loadu_ps(m[2]);
+    auto t = _mm_loadu_ps(m[3]);
+
+    auto cross = [](__m128 a, __m128 b) {
+        auto a1 = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+        auto b1 = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+        auto c = _mm_sub_ps(_mm_mul_ps(a, b1), _mm_mul_ps(a1, b));
+        return _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 0, 2, 1));
+    };
+    auto c0 = cross(r1, r2);
+    auto c1 = cross(r2, r0);
+    auto c2 = cross(r0, r1);
+
+    //行列式 r0・(r1×r2)
+    auto d = _mm_mul_ps(r0, c0);
+    d = _mm_add_ps(_mm_add_ps(d, _mm_shuffle_ps(d, d, _MM_SHUFFLE(1, 1, 1, 1))), _mm_shuffle_ps(d, d, _MM_SHUFFLE(2, 2, 2, 2)));
+    auto invDet = _mm_div_ps(_mm_set1_ps(1.f), _mm_shuffle_ps(d, d, _MM_SHUFFLE(0, 0, 0, 0)));
+    c0 = _mm_mul_ps(c0, invDet);
+    c1 = _mm_mul_ps(c1, invDet);
+    c2 = _mm_mul_ps(c2, invDet);
+
+    //列を行に並べ替える 4列目は0になる
+    auto c3 = _mm_setzero_ps();
+    _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+    //平行移動 -t * inv
+    auto it = _mm_mul_ps(_mm_shuffle_ps(t, t, _MM_SHUFFLE(0, 0, 0, 0)), c0);
+    it = _mm_add_ps(it, _mm_mul_ps(_mm_shuffle_ps(t, t, _MM_SHUFFLE(1, 1, 1, 1)), c1));
+    it = _mm_add_ps(it, _mm_mul_ps(_mm_shuffle_ps(t, t, _MM_SHUFFLE(2, 2, 2, 2)), c2));
+    it = _mm_sub_ps(_mm_setr_ps(0.f, 0.f, 0.f, 1.f), it);
+
+    _mm_storeu_ps(m[0], c0);
+    _mm_storeu_ps(m[1], c1);
+    _mm_storeu_ps(m[2], c2);
+    _mm_storeu_ps(m[3], it);
+#else
+    //各行の外積
+    float c0[3] = {
+        m[1][1] * m[2][2] - m[1][2] * m[2][1],
+        m[1][2] * m[2][0] - m[1][0] * m[2][2],
+        m[1][0] * m[2][1] - m[1][1] * m[2][0]
+    };
+    float c1[3] = {
+        m[2][1] * m[0][2] - m[2][2] * m[0][1],
+        m[2][2] * m[0][0] - m[2][0] * m[0][2],
+        m[2][0] * m[0][1] - m[2][1] * m[0][0]
+    };
+    float c2[3] = {
+        m[0][1] * m[1][2] - m[0][2] * m[1][1],
+        m[0][2] * m[1][0] - m[0][0] * m[1][2],
+        m[0][0] * m[1][1] - m[0][1] * m[1][0]
+    };
+    float invDet = 1.f / (m[0][0] * c0[0] + m[0][1] * c0[1] + m[0][2] * c0[2]);
+
+    float t[3] = { m[3][0], m[3][1], m[3][2] };
+    for (int i = 0; i < 3; ++i) {
+        m[i][0] = c0[i] * invDet;
+        m[i][1] = c1[i] * invDet;
+        m[i][2] = c2[i] * invDet;
+        m[i][3] = 0.f;
+    }
+    for (int j = 0; j < 3; ++j) {
+        m[3][j] = -(t[0] * m[0][j] + t[1] * m[1][j] + t[2] * m[2][j]);
+    }
+    m[3][3] = 1.f;
+#endif // MATH_SSE
+}
+
+Matrix4 Matrix4::inverseAffine(const Matrix4& right) {
+    auto temp = right;
+    temp.inverseAffine();
+    return temp;
+}
+
 Vector3 Matrix4::getTranslation() const {
     return Vector3(m[3][0], m[3][1], m[3][2]);
 }
@@ -299,24 +496,6 @@ Vector3 Matrix4::getScale() const {
     return retVal;
 }
 
-Matrix4 Matrix4::createScale(float xScale, float yScale, float zScale) {
-    float temp[4][4] = {
-        { xScale, 0.f, 0.f, 0.f },
-        { 0.f, yScale, 0.f, 0.f },
-        { 0.f, 0.f, zScale, 0.f },
-        { 0.f, 0.f, 0.f, 1.f }
-    };
-    return Matrix4(temp);
-}
-
-Matrix4 Matrix4::createScale(const Vector3& scaleVector) {
-    return createScale(scaleVector.x, scaleVector.y, scaleVector.z);
-}
-
-Matrix4 Matrix4::createScale(float scale) {
-    return createScale(scale, scale, scale);
-}
-
 Matrix4 Matrix4::createRotationX(float theta) {
     float temp[4][4] = {
         { 1.f, 0.f, 0.f , 0.f },
@@ -347,42 +526,6 @@ Matrix4 Matrix4::createRotationZ(float theta) {
     return Matrix4(temp);
 }
 
-Matrix4 Matrix4::createFromQuaternion(const Quaternion& q) {
-    float mat[4][4];
-
-    mat[0][0] = 1.f - 2.f * q.y * q.y - 2.f * q.z * q.z;
-    mat[0][1] = 2.f * q.x * q.y + 2.f * q.w * q.z;
-    mat[0][2] = 2.f * q.x * q.z - 2.f * q.w * q.y;
-    mat[0][3] = 0.f;
-
-    mat[1][0] = 2.f * q.x * q.y - 2.f * q.w * q.z;
-    mat[1][1] = 1.f - 2.f * q.x * q.x - 2.f * q.z * q.z;
-    mat[1][2] = 2.f * q.y * q.z + 2.f * q.w * q.x;
-    mat[1][3] = 0.f;
-
-    mat[2][0] = 2.f * q.x * q.z + 2.f * q.w * q.y;
-    mat[2][1] = 2.f * q.y * q.z - 2.f * q.w * q.x;
-    mat[2][2] = 1.f - 2.f * q.x * q.x - 2.f * q.y * q.y;
-    mat[2][3] = 0.f;
-
-    mat[3][0] = 0.f;
-    mat[3][1] = 0.f;
-    mat[3][2] = 0.f;
-    mat[3][3] = 1.f;
-
-    return Matrix4(mat);
-}
-
-Matrix4 Matrix4::createTranslation(const Vector3& trans) {
-    float temp[4][4] = {
-        { 1.f, 0.f, 0.f, 0.f },
-        { 0.f, 1.f, 0.f, 0.f },
-        { 0.f, 0.f, 1.f, 0.f },
-        { trans.x, trans.y, trans.z, 1.f }
-    };
-    return Matrix4(temp);
-}
-
 Matrix4 Matrix4::createOrtho(float width, float height, float _near, float _far) {
     float temp[4][4] = {
         { 2.f / width, 0.f, 0.f, 0.f },
@@ -393,10 +536,125 @@ Matrix4 Matrix4::createOrtho(float width, float height, float _near, float _far)
     return Matrix4(temp);
 }
 
-float m4Ident[4][4] = {
-    { 1.f, 0.f, 0.f, 0.f },
-    { 0.f, 1.f, 0.f, 0.f },
-    { 0.f, 0.f, 1.f, 0.f },
-    { 0.f, 0.f, 0.f, 1.f }
-};
-const Matrix4 Matrix4::identity(m4Ident);
+void Matrix4::createFromQuaternionArray(const Quaternion* rotations, Matrix4* out, size_t count) {
+    composeArray(nullptr, rotations, nullptr, nullptr, out, count);
+}
+
+void Matrix4::createTRSArray(const Vector3* scales, const Quaternion* rotations, const Vector3* positions, Matrix4* out, size_t count, const Vector3* pivots) {
+    composeArray(scales, rotations, positions, pivots, out, count);
+}
+
+void Matrix4::composeArray(const Vector3* scales, const Quaternion* rotations, const Vector3* positions, const Vector3* pivots, Matrix4* out, size_t count) {
+    size_t i = 0;
+
+#ifdef MATH_SSE
+    const auto zero = _mm_setzero_ps();
+    const auto one = _mm_set1_ps(1.f);
+    //Vector3は12バイトなので、4要素の同じ成分を1レーンずつ集める
+    auto gather = [](const Vector3* v, int axis) {
+        return _mm_set_ps(v[3][axis], v[2][axis], v[1][axis], v[0][axis]);
+    };
+
+    //4要素ずつ行列の成分ごとのレーンに並べて計算する
+    for (; i + 4 <= count; i += 4) {
+        auto qx = _mm_loadu_ps(&rotations[i].x);
+        auto qy = _mm_loadu_ps(&rotations[i + 1].x);
+        auto qz = _mm_loadu_ps(&rotations[i + 2].x);
+        auto qw = _mm_loadu_ps(&rotations[i + 3].x);
+        _MM_TRANSPOSE4_PS(qx, qy, qz, qw);
+
+        //createFromQuaternionと同じ式
+        auto x2 = _mm_add_ps(qx, qx);
+        auto y2 = _mm_add_ps(qy, qy);
+        auto z2 = _mm_add_ps(qz, qz);
+        auto xx = _mm_mul_ps(qx, x2), yy = _mm_mul_ps(qy, y2), zz = _mm_mul_ps(qz, z2);
+        auto xy = _mm_mul_ps(qx, y2), xz = _mm_mul_ps(qx, z2), yz = _mm_mul_ps(qy, z2);
+        auto wx = _mm_mul_ps(qw, x2), wy = _mm_mul_ps(qw, y2), wz = _mm_mul_ps(qw, z2);
+
+        auto r00 = _mm_sub_ps(_mm_sub_ps(one, yy), zz), r01 = _mm_add_ps(xy, wz), r02 = _mm_sub_ps(xz, wy);
+        auto r10 = _mm_sub_ps(xy, wz), r11 = _mm_sub_ps(_mm_sub_ps(one, xx), zz), r12 = _mm_add_ps(yz, wx);
+        auto r20 = _mm_add_ps(xz, wy), r21 = _mm_sub_ps(yz, wx), r22 = _mm_sub_ps(_mm_sub_ps(one, xx), yy);
+
+        //スケールは各行に掛かる
+        if (scales) {
+            auto sx = gather(scales + i, 0), sy = gather(scales + i, 1), sz = gather(scales + i, 2);
+            r00 = _mm_mul_ps(r00, sx);
+            r01 = _mm_mul_ps(r01, sx);
+            r02 = _mm_mul_ps(r02, sx);
+            r10 = _mm_mul_ps(r10, sy);
+            r11 = _mm_mul_ps(r11, sy);
+            r12 = _mm_mul_ps(r12, sy);
+            r20 = _mm_mul_ps(r20, sz);
+            r21 = _mm_mul_ps(r21, sz);
+            r22 = _mm_mul_ps(r22, sz);
+        }
+
+        auto t0 = zero, t1 = zero, t2 = zero;
+        if (positions) {
+            t0 = gather(positions + i, 0);
+            t1 = gather(positions + i, 1);
+            t2 = gather(positions + i, 2);
+        }
+        //ピボットを原点に移動させる分は、ピボットを回転拡縮して引く
+        if (pivots) {
+            auto px = gather(pivots + i, 0), py = gather(pivots + i, 1), pz = gather(pivots + i, 2);
+            t0 = _mm_sub_ps(t0, _mm_add_ps(_mm_add_ps(_mm_mul_ps(px, r00), _mm_mul_ps(py, r10)), _mm_mul_ps(pz, r20)));
+            t1 = _mm_sub_ps(t1, _mm_add_ps(_mm_add_ps(_mm_mul_ps(px, r01), _mm_mul_ps(py, r11)), _mm_mul_ps(pz, r21)));
+            t2 = _mm_sub_ps(t2, _mm_add_ps(_mm_add_ps(_mm_mul_ps(px, r02), _mm_mul_ps(py, r12)), _mm_mul_ps(pz, r22)));
+        }
+
+        //成分ごとのレーンを転置して、各行列の行に戻す
+        auto w = zero;
+        _MM_TRANSPOSE4_PS(r00, r01, r02, w);
+        _mm_storeu_ps(out[i].m[0], r00);
+        _mm_storeu_ps(out[i + 1].m[0], r01);
+        _mm_storeu_ps(out[i + 2].m[0], r02);
+        _mm_storeu_ps(out[i + 3].m[0], w);
+
+        w = zero;
+        _MM_TRANSPOSE4_PS(r10, r11, r12, w);
+        _mm_storeu_ps(out[i].m[1], r10);
+        _mm_storeu_ps(out[i + 1].m[1], r11);
+        _mm_storeu_ps(out[i + 2].m[1], r12);
+        _mm_storeu_ps(out[i + 3].m[1], w);
+
+        w = zero;
+        _MM_TRANSPOSE4_PS(r20, r21, r22, w);
+        _mm_storeu_ps(out[i].m[2], r20);
+        _mm_storeu_ps(out[i + 1].m[2], r21);
+        _mm_storeu_ps(out[i + 2].m[2], r22);
+        _mm_storeu_ps(out[i + 3].m[2], w);
+
+        w = one;
+        _MM_TRANSPOSE4_PS(t0, t1, t2, w);
+        _mm_storeu_ps(out[i].m[3], t0);
+        _mm_storeu_ps(out[i + 1].m[3], t1);
+        _mm_storeu_ps(out[i + 2].m[3], t2);
+        _mm_storeu_ps(out[i + 3].m[3], w);
+    }
+#endif // MATH_SSE
+
+    //残りはスカラーで計算する
+    for (; i < count; ++i) {
+        auto& mat = out[i];
+        mat = createFromQuaternion(rotations[i]);
+
+        if (scales) {
+            const auto& s = scales[i];
+            for (int j = 0; j < 3; ++j) {
+                mat.m[0][j] *= s.x;
+                mat.m[1][j] *= s.y;
+                mat.m[2][j] *= s.z;
+            }
+        }
+
+        for (int j = 0; j < 3; ++j) {
+            auto t = (positions) ? positions[i][j] : 0.f;
+            if (pivots) {
+                const auto& p = pivots[i];
+                t -= p.x * mat.m[0][j] + p.y * mat.m[1][j] + p.z * mat.m[2][j];
+            }
+            mat.m[3][j] = t;
+        }
+    }
+}
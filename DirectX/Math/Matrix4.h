@@ -1,16 +1,17 @@
 ﻿#pragma once
 
-class Vector3;
-class Quaternion;
+#include "Quaternion.h"
+#include "Vector3.h"
+#include <cstddef>
 
 class Matrix4 {
 public:
     float m[4][4];
 
 public:
-    Matrix4();
+    constexpr Matrix4();
 
-    explicit Matrix4(float inMat[4][4]);
+    constexpr explicit Matrix4(float inMat[4][4]);
 
     // Matrix multiplication (a * b)
     friend Matrix4 operator*(const Matrix4& a, const Matrix4& b);
@@ -19,11 +20,17 @@ public:
 
     void transpose();
 
-    // Invert the matrix - super slow
+    //逆行列にする SSEが使える環境では2x2の小行列に分けて求める
     void inverse();
 
     static Matrix4 inverse(const Matrix4& right);
 
+    //4列目が(0, 0, 0, 1)のアフィン変換行列専用の逆行列
+    //ワールド行列やビュー行列はこちらの方が速い
+    void inverseAffine();
+
+    static Matrix4 inverseAffine(const Matrix4& right);
+
     // Get the translation component of the matrix
     Vector3 getTranslation() const;
 
@@ -40,12 +47,12 @@ public:
     Vector3 getScale() const;
 
     // Create a scale matrix with x, y, and z scales
-    static Matrix4 createScale(float xScale, float yScale, float zScale);
+    static constexpr Matrix4 createScale(float xScale, float yScale, float zScale);
 
-    static Matrix4 createScale(const Vector3& scaleVector);
+    static constexpr Matrix4 createScale(const Vector3& scaleVector);
 
     // Create a scale matrix with a uniform factor
-    static Matrix4 createScale(float scale);
+    static constexpr Matrix4 createScale(float scale);
 
     // Rotation about x-axis
     static Matrix4 createRotationX(float theta);
@@ -57,11 +64,96 @@ public:
     static Matrix4 createRotationZ(float theta);
 
     // Create a rotation matrix from a quaternion
-    static Matrix4 createFromQuaternion(const Quaternion& q);
+    static constexpr Matrix4 createFromQuaternion(const Quaternion& q);
 
-    static Matrix4 createTranslation(const Vector3& trans);
+    static constexpr Matrix4 createTranslation(const Vector3& trans);
 
     static Matrix4 createOrtho(float width, float height, float _near, float _far);
 
+    //連続したクォータニオンからまとめて回転行列を作る
+    static void createFromQuaternionArray(const Quaternion* rotations, Matrix4* out, size_t count);
+
+    //スケール、回転、平行移動の順に掛けた行列をまとめて作る
+    //pivotsを指定すると、先に各ピボットを原点に移動させる
+    static void createTRSArray(const Vector3* scales, const Quaternion* rotations, const Vector3* positions, Matrix4* out, size_t count, const Vector3* pivots = nullptr);
+
     static const Matrix4 identity;
+
+private:
+    //nullptrの配列はスケール1、移動量0、ピボットなしとして扱う
+    static void composeArray(const Vector3* scales, const Quaternion* rotations, const Vector3* positions, const Vector3* pivots, Matrix4* out, size_t count);
 };
+
+constexpr Matrix4::Matrix4() :
+    m{
+        { 1.f, 0.f, 0.f, 0.f },
+        { 0.f, 1.f, 0.f, 0.f },
+        { 0.f, 0.f, 1.f, 0.f },
+        { 0.f, 0.f, 0.f, 1.f }
+    } {
+}
+
+constexpr Matrix4::Matrix4(float inMat[4][4]) :
+    m() {
+    //memcpyは定数式で使えないため要素ごとにコピーする
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            m[i][j] = inMat[i][j];
+        }
+    }
+}
+
+constexpr Matrix4 Matrix4::createScale(float xScale, float yScale, float zScale) {
+    float temp[4][4] = {
+        { xScale, 0.f, 0.f, 0.f },
+        { 0.f, yScale, 0.f, 0.f },
+        { 0.f, 0.f, zScale, 0.f },
+        { 0.f, 0.f, 0.f, 1.f }
+    };
+    return Matrix4(temp);
+}
+
+constexpr Matrix4 Matrix4::createScale(const Vector3& scaleVector) {
+    return createScale(scaleVector.x, scaleVector.y, scaleVector.z);
+}
+
+constexpr Matrix4 Matrix4::createScale(float scale) {
+    return createScale(scale, scale, scale);
+}
+
+constexpr Matrix4 Matrix4::createFromQuaternion(const Quaternion& q) {
+    float mat[4][4] = {
+        {
+            1.f - 2.f * q.y * q.y - 2.f * q.z * q.z,
+            2.f * q.x * q.y + 2.f * q.w * q.z,
+            2.f * q.x * q.z - 2.f * q.w * q.y,
+            0.f
+        },
+        {
+            2.f * q.x * q.y - 2.f * q.w * q.z,
+            1.f - 2.f * q.x * q.x - 2.f * q.z * q.z,
+            2.f * q.y * q.z + 2.f * q.w * q.x,
+            0.f
+        },
+        {
+            2.f * q.x * q.z + 2.f * q.w * q.y,
+            2.f * q.y * q.z - 2.f * q.w * q.x,
+            1.f - 2.f * q.x * q.x - 2.f * q.y * q.y,
+            0.f
+        },
+        { 0.f, 0.f, 0.f, 1.f }
+    };
+    return Matrix4(mat);
+}
+
+constexpr Matrix4 Matrix4::createTranslation(const Vector3& trans) {
+    float temp[4][4] = {
+        { 1.f, 0.f, 0.f, 0.f },
+        { 0.f, 1.f, 0.f, 0.f },
+        { 0.f, 0.f, 1.f, 0.f },
+        { trans.x, trans.y, trans.z, 1.f }
+    };
+    return Matrix4(temp);
+}
+
+inline constexpr Matrix4 Matrix4::identity = Matrix4();
@@ -1,6 +1,13 @@
 ﻿#include "Plane.h"
 #include "Vector3.h"
 
+Plane::Plane() :
+    a(0.f),
+    b(0.f),
+    c(0.f),
+    d(0.f) {
+}
+
 Plane::Plane(float inA, float inB, float inC, float inD) :
     a(inA),
     b(inB),
@@ -10,6 +10,7 @@ public:
     float d;
 
 public:
+    Plane();
     //aX + bY + cZ = d
     Plane(float inA, float inB, float inC, float inD);
     //法線ベクトル(a, b, c)と平面の距離(D = d / |n|)
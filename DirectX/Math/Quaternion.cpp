@@ -1,18 +1,8 @@
 ﻿#include "Quaternion.h"
 #include "Math.h"
+#include "SIMD.h"
 #include "Vector3.h"
 
-Quaternion::Quaternion() {
-    *this = Quaternion::identity;
-}
-
-Quaternion::Quaternion(float inX, float inY, float inZ, float inW) :
-    x(inX),
-    y(inY),
-    z(inZ),
-    w(inW) {
-}
-
 Quaternion::Quaternion(const Vector3& axis, float angle) {
     float scalar = Math::sin(angle / 2.f);
     x = axis.x * scalar;
@@ -21,23 +11,6 @@ Quaternion::Quaternion(const Vector3& axis, float angle) {
     w = Math::cos(angle / 2.f);
 }
 
-void Quaternion::set(float inX, float inY, float inZ, float inW) {
-    x = inX;
-    y = inY;
-    z = inZ;
-    w = inW;
-}
-
-void Quaternion::conjugate() {
-    x *= -1.f;
-    y *= -1.f;
-    z *= -1.f;
-}
-
-float Quaternion::lengthSq() const {
-    return (x * x + y * y + z * z + w * w);
-}
-
 float Quaternion::length() const {
     return Math::sqrt(lengthSq());
 }
@@ -102,10 +75,6 @@ Quaternion Quaternion::lerp(const Quaternion& a, const Quaternion& b, float f) {
     return retVal;
 }
 
-float Quaternion::dot(const Quaternion& a, const Quaternion& b) {
-    return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
-}
-
 Quaternion Quaternion::slerp(const Quaternion& a, const Quaternion& b, float f) {
     float rawCosm = Quaternion::dot(a, b);
 
@@ -141,23 +110,126 @@ Quaternion Quaternion::slerp(const Quaternion& a, const Quaternion& b, float f)
     return retVal;
 }
 
-Quaternion Quaternion::concatenate(const Quaternion& q, const Quaternion& p) {
-    Quaternion retVal;
+void Quaternion::lerpArray(const Quaternion* a, const Quaternion* b, Quaternion* out, size_t count, float f) {
+    size_t i = 0;
+
+#ifdef MATH_SSE
+    const auto t = _mm_set1_ps(f);
+    const auto zero = _mm_setzero_ps();
+    const auto one = _mm_set1_ps(1.f);
+
+    //4要素ずつxyzwごとのレーンに並べ替えて計算する
+    for (; i + 4 <= count; i += 4) {
+        auto a0 = _mm_loadu_ps(&a[i].x), a1 = _mm_loadu_ps(&a[i + 1].x), a2 = _mm_loadu_ps(&a[i + 2].x), a3 = _mm_loadu_ps(&a[i + 3].x);
+        auto b0 = _mm_loadu_ps(&b[i].x), b1 = _mm_loadu_ps(&b[i + 1].x), b2 = _mm_loadu_ps(&b[i + 2].x), b3 = _mm_loadu_ps(&b[i + 3].x);
+        _MM_TRANSPOSE4_PS(a0, a1, a2, a3);
+        _MM_TRANSPOSE4_PS(b0, b1, b2, b3);
+
+        auto x = _mm_add_ps(a0, _mm_mul_ps(t, _mm_sub_ps(b0, a0)));
+        auto y = _mm_add_ps(a1, _mm_mul_ps(t, _mm_sub_ps(b1, a1)));
+        auto z = _mm_add_ps(a2, _mm_mul_ps(t, _mm_sub_ps(b2, a2)));
+        auto w = _mm_add_ps(a3, _mm_mul_ps(t, _mm_sub_ps(b3, a3)));
+
+        //長さが0の要素はnormalizeと同じく割らずにそのまま返す
+        auto len = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_add_ps(_mm_mul_ps(z, z), _mm_mul_ps(w, w))));
+        auto isZero = _mm_cmpeq_ps(len, zero);
+        len = _mm_or_ps(_mm_and_ps(isZero, one), _mm_andnot_ps(isZero, len));
+        x = _mm_div_ps(x, len);
+        y = _mm_div_ps(y, len);
+        z = _mm_div_ps(z, len);
+        w = _mm_div_ps(w, len);
+
+        _MM_TRANSPOSE4_PS(x, y, z, w);
+        _mm_storeu_ps(&out[i].x, x);
+        _mm_storeu_ps(&out[i + 1].x, y);
+        _mm_storeu_ps(&out[i + 2].x, z);
+        _mm_storeu_ps(&out[i + 3].x, w);
+    }
+#endif // MATH_SSE
 
-    // Vector component is:
-    // ps * qv + qs * pv + pv x qv
-    Vector3 qv(q.x, q.y, q.z);
-    Vector3 pv(p.x, p.y, p.z);
-    Vector3 newVec = p.w * qv + q.w * pv + Vector3::cross(pv, qv);
-    retVal.x = newVec.x;
-    retVal.y = newVec.y;
-    retVal.z = newVec.z;
+    //残りはスカラーで計算する
+    for (; i < count; ++i) {
+        out[i] = lerp(a[i], b[i], f);
+    }
+}
 
-    // Scalar component is:
-    // ps * qs - pv . qv
-    retVal.w = p.w * q.w - Vector3::dot(pv, qv);
+void Quaternion::slerpArray(const Quaternion* a, const Quaternion* b, Quaternion* out, size_t count, float f) {
+    size_t i = 0;
+
+#ifdef MATH_SSE
+    //sin(tθ) / sin(θ)をcos(θ) - 1の多項式で近似する (Eberly, A Fast and Accurate Algorithm for Computing SLERP)
+    //i項目の係数はt^2 / (i(2i + 1)) - i / (2i + 1)で、最後の項は打ち切り誤差を均すため(1 + mu)倍する
+    //12項で打ち切ると、補間の重みの誤差は1e-6未満になる
+    static constexpr int TERM_COUNT = 12;
+    static constexpr float ONE_PLUS_MU = 1.895f;
+    //補間係数は全要素で同じなので、多項式の係数は先に求めておく
+    const auto d = 1.f - f;
+    __m128 coefT[TERM_COUNT];
+    __m128 coefD[TERM_COUNT];
+    for (int j = 0; j < TERM_COUNT; ++j) {
+        auto n = static_cast<float>(j + 1);
+        auto u = 1.f / (n * (2.f * n + 1.f));
+        auto v = n / (2.f * n + 1.f);
+        if (j == TERM_COUNT - 1) {
+            u *= ONE_PLUS_MU;
+            v *= ONE_PLUS_MU;
+        }
+        coefT[j] = _mm_set1_ps(u * f * f - v);
+        coefD[j] = _mm_set1_ps(u * d * d - v);
+    }
 
-    return retVal;
-}
+    const auto t = _mm_set1_ps(f);
+    const auto dd = _mm_set1_ps(d);
+    const auto one = _mm_set1_ps(1.f);
+    const auto signBit = _mm_set1_ps(-0.f);
+
+    for (; i + 4 <= count; i += 4) {
+        auto a0 = _mm_loadu_ps(&a[i].x), a1 = _mm_loadu_ps(&a[i + 1].x), a2 = _mm_loadu_ps(&a[i + 2].x), a3 = _mm_loadu_ps(&a[i + 3].x);
+        auto b0 = _mm_loadu_ps(&b[i].x), b1 = _mm_loadu_ps(&b[i + 1].x), b2 = _mm_loadu_ps(&b[i + 2].x), b3 = _mm_loadu_ps(&b[i + 3].x);
+        _MM_TRANSPOSE4_PS(a0, a1, a2, a3);
+        _MM_TRANSPOSE4_PS(b0, b1, b2, b3);
+
+        //内積が負なら最短経路になるようbを反転する
+        auto cosom = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a0, b0), _mm_mul_ps(a1, b1)), _mm_add_ps(_mm_mul_ps(a2, b2), _mm_mul_ps(a3, b3)));
+        auto sign = _mm_and_ps(cosom, signBit);
+        cosom = _mm_xor_ps(cosom, sign);
+        b0 = _mm_xor_ps(b0, sign);
+        b1 = _mm_xor_ps(b1, sign);
+        b2 = _mm_xor_ps(b2, sign);
+        b3 = _mm_xor_ps(b3, sign);
+
+        auto xm1 = _mm_sub_ps(cosom, one);
+        auto scaleT = one;
+        auto scaleD = one;
+        for (int j = TERM_COUNT - 1; j >= 0; --j) {
+            scaleT = _mm_add_ps(one, _mm_mul_ps(_mm_mul_ps(coefT[j], xm1), scaleT));
+            scaleD = _mm_add_ps(one, _mm_mul_ps(_mm_mul_ps(coefD[j], xm1), scaleD));
+        }
+        scaleT = _mm_mul_ps(scaleT, t);
+        scaleD = _mm_mul_ps(scaleD, dd);
+
+        auto x = _mm_add_ps(_mm_mul_ps(scaleD, a0), _mm_mul_ps(scaleT, b0));
+        auto y = _mm_add_ps(_mm_mul_ps(scaleD, a1), _mm_mul_ps(scaleT, b1));
+        auto z = _mm_add_ps(_mm_mul_ps(scaleD, a2), _mm_mul_ps(scaleT, b2));
+        auto w = _mm_add_ps(_mm_mul_ps(scaleD, a3), _mm_mul_ps(scaleT, b3));
+
+        //slerpと同じく最後に正規化する
+        auto len = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_add_ps(_mm_mul_ps(z, z), _mm_mul_ps(w, w))));
+        x = _mm_div_ps(x, len);
+        y = _mm_div_ps(y, len);
+        z = _mm_div_ps(z, len);
+        w = _mm_div_ps(w, len);
+
+        _MM_TRANSPOSE4_PS(x, y, z, w);
+        _mm_storeu_ps(&out[i].x, x);
+        _mm_storeu_ps(&out[i + 1].x, y);
+        _mm_storeu_ps(&out[i + 2].x, z);
+        _mm_storeu_ps(&out[i + 3].x, w);
+    }
+#endif // MATH_SSE
 
-const Quaternion Quaternion::identity(0.f, 0.f, 0.f, 1.f);
+    //残りはスカラーで計算する
+    for (; i < count; ++i) {
+        out[i] = slerp(a[i], b[i], f);
+    }
+}
@@ -1,5 +1,7 @@
 ﻿#pragma once
 
+#include <cstddef>
+
 class Vector3;
 
 class Quaternion {
@@ -10,11 +12,11 @@ public:
     float w;
 
 public:
-    Quaternion();
+    constexpr Quaternion();
 
     // This directly sets the quaternion components --
     // don't use for axis/angle
-    explicit Quaternion(float inX, float inY, float inZ, float inW);
+    constexpr explicit Quaternion(float inX, float inY, float inZ, float inW);
 
     // Construct the quaternion from an axis and angle
     // It is assumed that axis is already normalized,
@@ -22,11 +24,11 @@ public:
     explicit Quaternion(const Vector3& axis, float angle);
 
     // Directly set the internal components
-    void set(float inX, float inY, float inZ, float inW);
+    constexpr void set(float inX, float inY, float inZ, float inW);
 
-    void conjugate();
+    constexpr void conjugate();
 
-    float lengthSq() const;
+    constexpr float lengthSq() const;
 
     float length() const;
 
@@ -44,7 +46,7 @@ public:
     // Linear interpolation
     static Quaternion lerp(const Quaternion& a, const Quaternion& b, float f);
 
-    static float dot(const Quaternion& a, const Quaternion& b);
+    static constexpr float dot(const Quaternion& a, const Quaternion& b);
 
     // Spherical Linear Interpolation
     static Quaternion slerp(const Quaternion& a, const Quaternion& b, float f);
@@ -52,7 +54,64 @@ public:
     // Concatenate
     // Rotate by q FOLLOWED BY p
     //掛け算
-    static Quaternion concatenate(const Quaternion& q, const Quaternion& p);
+    static constexpr Quaternion concatenate(const Quaternion& q, const Quaternion& p);
+
+    //連続したクォータニオンをまとめて線形補間し正規化する
+    //各要素の結果はlerpと同じ
+    static void lerpArray(const Quaternion* a, const Quaternion* b, Quaternion* out, size_t count, float f);
+    //連続したクォータニオンをまとめて球面線形補間する
+    //SSEが使える環境ではacos/sinを使わない多項式近似で求めるため、slerpとは誤差の範囲で異なる
+    static void slerpArray(const Quaternion* a, const Quaternion* b, Quaternion* out, size_t count, float f);
 
     static const Quaternion identity;
 };
+
+constexpr Quaternion::Quaternion() :
+    x(0.f),
+    y(0.f),
+    z(0.f),
+    w(1.f) {
+}
+
+constexpr Quaternion::Quaternion(float inX, float inY, float inZ, float inW) :
+    x(inX),
+    y(inY),
+    z(inZ),
+    w(inW) {
+}
+
+constexpr void Quaternion::set(float inX, float inY, float inZ, float inW) {
+    x = inX;
+    y = inY;
+    z = inZ;
+    w = inW;
+}
+
+constexpr void Quaternion::conjugate() {
+    x *= -1.f;
+    y *= -1.f;
+    z *= -1.f;
+}
+
+constexpr float Quaternion::lengthSq() const {
+    return (x * x + y * y + z * z + w * w);
+}
+
+constexpr float Quaternion::dot(const Quaternion& a, const Quaternion& b) {
+    return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+}
+
+constexpr Quaternion Quaternion::concatenate(const Quaternion& q, const Quaternion& p) {
+    // Vector component is:
+    // ps * qv + qs * pv + pv x qv
+    // Scalar component is:
+    // ps * qs - pv . qv
+    return Quaternion(
+        q.x * p.w + p.x * q.w + (p.y * q.z - p.z * q.y),
+        q.y * p.w + p.y * q.w + (p.z * q.x - p.x * q.z),
+        q.z * p.w + p.z * q.w + (p.x * q.y - p.y * q.x),
+        p.w * q.w - (p.x * q.x + p.y * q.y + p.z * q.z)
+    );
+}
+
+inline constexpr Quaternion Quaternion::identity(0.f, 0.f, 0.f, 1.f);
@@ -0,0 +1,16 @@
+﻿#pragma once
+
+//コンパイラの設定から使用できるSIMD命令セットを判定する
+//どちらも定義されない環境ではスカラー実装が使われる
+
+//AVX (/arch:AVX以上)
+#if defined(__AVX__)
+#define MATH_AVX
+#include <immintrin.h>
+#endif
+
+//SSE2 (x64では常に使用可能)
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MATH_SSE
+#include <emmintrin.h>
+#endif
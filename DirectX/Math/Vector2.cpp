@@ -2,82 +2,10 @@
 #include "Math.h"
 #include "Matrix3.h"
 
-Vector2::Vector2() :
-    x(0.f),
-    y(0.f) {
-}
-
-Vector2::Vector2(float inX, float inY) :
-    x(inX),
-    y(inY) {
-}
-
-void Vector2::set(float inX, float inY) {
-    x = inX;
-    y = inY;
-}
-
-Vector2 Vector2::operator-() {
-    return Vector2(-x, -y);
-}
-
-Vector2 operator-(const Vector2& vec) {
-    return Vector2(-vec.x, -vec.y);
-}
-
-Vector2 operator+(const Vector2& a, const Vector2& b) {
-    return Vector2(a.x + b.x, a.y + b.y);
-}
-
-Vector2 operator-(const Vector2& a, const Vector2& b) {
-    return Vector2(a.x - b.x, a.y - b.y);
-}
-
-Vector2 operator*(const Vector2& a, const Vector2& b) {
-    return Vector2(a.x * b.x, a.y * b.y);
-}
-
-Vector2 operator*(const Vector2& vec, float scalar) {
-    return Vector2(vec.x * scalar, vec.y * scalar);
-}
-
-Vector2 operator*(float scalar, const Vector2& vec) {
-    return Vector2(vec.x * scalar, vec.y * scalar);
-}
-
-Vector2 operator/(const Vector2& vec, float scalar) {
-    if (scalar == 0) {
-        return vec;
-    }
-    return Vector2(vec.x / scalar, vec.y / scalar);
-}
-
-Vector2& Vector2::operator*=(float scalar) {
-    x *= scalar;
-    y *= scalar;
-    return *this;
-}
-
-Vector2& Vector2::operator+=(const Vector2& right) {
-    x += right.x;
-    y += right.y;
-    return *this;
-}
-
-Vector2& Vector2::operator-=(const Vector2& right) {
-    x -= right.x;
-    y -= right.y;
-    return *this;
-}
-
 bool Vector2::equal(const Vector2& right) const {
     return (Math::equal(x, right.x) && Math::equal(y, right.y));
 }
 
-float Vector2::lengthSq() const {
-    return (x * x + y * y);
-}
-
 float Vector2::length() const {
     return (Math::sqrt(lengthSq()));
 }
@@ -114,14 +42,6 @@ Vector2 Vector2::normalize(const Vector2& vec) {
     return temp;
 }
 
-float Vector2::dot(const Vector2& a, const Vector2& b) {
-    return (a.x * b.x + a.y * b.y);
-}
-
-float Vector2::cross(const Vector2& a, const Vector2& b) {
-    return (a.x * b.y - a.y * b.x);
-}
-
 Vector2 Vector2::lerp(const Vector2& a, const Vector2& b, float f) {
     return Vector2(a + f * (b - a));
 }
@@ -137,10 +57,3 @@ Vector2 Vector2::transform(const Vector2& vec, const Matrix3& mat, float w) {
     //ignore w since we aren't returning a new value for it...
     return retVal;
 }
-
-const Vector2 Vector2::zero(0.f, 0.f);
-const Vector2 Vector2::right(1.f, 0.f);
-const Vector2 Vector2::up(0.f, -1.f);
-const Vector2 Vector2::left(-1.f, 0.f);
-const Vector2 Vector2::down(0.f, 1.f);
-const Vector2 Vector2::one(1.f, 1.f);
@@ -8,49 +8,49 @@ public:
     float y;
 
 public:
-    Vector2();
+    constexpr Vector2();
 
-    explicit Vector2(float inX, float inY);
+    constexpr explicit Vector2(float inX, float inY);
 
     // Set both components in one line
-    void set(float inX, float inY);
+    constexpr void set(float inX, float inY);
 
-    Vector2 operator-();
+    constexpr Vector2 operator-();
 
-    friend Vector2 operator-(const Vector2& vec);
+    friend constexpr Vector2 operator-(const Vector2& vec);
 
     // Vector addition (a + b)
-    friend Vector2 operator+(const Vector2& a, const Vector2& b);
+    friend constexpr Vector2 operator+(const Vector2& a, const Vector2& b);
 
     // Vector subtraction (a - b)
-    friend Vector2 operator-(const Vector2& a, const Vector2& b);
+    friend constexpr Vector2 operator-(const Vector2& a, const Vector2& b);
 
     // Component-wise multiplication
     // (a.x * b.x, ...)
-    friend Vector2 operator*(const Vector2& a, const Vector2& b);
+    friend constexpr Vector2 operator*(const Vector2& a, const Vector2& b);
 
     // Scalar multiplication
-    friend Vector2 operator*(const Vector2& vec, float scalar);
+    friend constexpr Vector2 operator*(const Vector2& vec, float scalar);
 
     // Scalar multiplication
-    friend Vector2 operator*(float scalar, const Vector2& vec);
+    friend constexpr Vector2 operator*(float scalar, const Vector2& vec);
 
-    friend Vector2 operator/(const Vector2& vec, float scalar);
+    friend constexpr Vector2 operator/(const Vector2& vec, float scalar);
 
     // Scalar *=
-    Vector2& operator*=(float scalar);
+    constexpr Vector2& operator*=(float scalar);
 
     // Vector +=
-    Vector2& operator+=(const Vector2& right);
+    constexpr Vector2& operator+=(const Vector2& right);
 
     // Vector -=
-    Vector2& operator-=(const Vector2& right);
+    constexpr Vector2& operator-=(const Vector2& right);
 
     //ほぼ同じ値のVector2か
     bool equal(const Vector2& right) const;
 
     // Length squared of vector
-    float lengthSq() const;
+    constexpr float lengthSq() const;
 
     // Length of vector
     float length() const;
@@ -68,9 +68,9 @@ public:
     static Vector2 normalize(const Vector2& vec);
 
     // Dot product between two vectors (a dot b)
-    static float dot(const Vector2& a, const Vector2& b);
+    static constexpr float dot(const Vector2& a, const Vector2& b);
 
-    static float cross(const Vector2& a, const Vector2& b);
+    static constexpr float cross(const Vector2& a, const Vector2& b);
 
     // Lerp from A to B by f
     static Vector2 lerp(const Vector2& a, const Vector2& b, float f);
@@ -88,3 +88,90 @@ public:
     static const Vector2 down;
     static const Vector2 one;
 };
+
+constexpr Vector2::Vector2() :
+    x(0.f),
+    y(0.f) {
+}
+
+constexpr Vector2::Vector2(float inX, float inY) :
+    x(inX),
+    y(inY) {
+}
+
+constexpr void Vector2::set(float inX, float inY) {
+    x = inX;
+    y = inY;
+}
+
+constexpr Vector2 Vector2::operator-() {
+    return Vector2(-x, -y);
+}
+
+constexpr Vector2 operator-(const Vector2& vec) {
+    return Vector2(-vec.x, -vec.y);
+}
+
+constexpr Vector2 operator+(const Vector2& a, const Vector2& b) {
+    return Vector2(a.x + b.x, a.y + b.y);
+}
+
+constexpr Vector2 operator-(const Vector2& a, const Vector2& b) {
+    return Vector2(a.x - b.x, a.y - b.y);
+}
+
+constexpr Vector2 operator*(const Vector2& a, const Vector2& b) {
+    return Vector2(a.x * b.x, a.y * b.y);
+}
+
+constexpr Vector2 operator*(const Vector2& vec, float scalar) {
+    return Vector2(vec.x * scalar, vec.y * scalar);
+}
+
+constexpr Vector2 operator*(float scalar, const Vector2& vec) {
+    return Vector2(vec.x * scalar, vec.y * scalar);
+}
+
+constexpr Vector2 operator/(const Vector2& vec, float scalar) {
+    if (scalar == 0) {
+        return vec;
+    }
+    return Vector2(vec.x / scalar, vec.y / scalar);
+}
+
+constexpr Vector2& Vector2::operator*=(float scalar) {
+    x *= scalar;
+    y *= scalar;
+    return *this;
+}
+
+constexpr Vector2& Vector2::operator+=(const Vector2& right) {
+    x += right.x;
+    y += right.y;
+    return *this;
+}
+
+constexpr Vector2& Vector2::operator-=(const Vector2& right) {
+    x -= right.x;
+    y -= right.y;
+    return *this;
+}
+
+constexpr float Vector2::lengthSq() const {
+    return (x * x + y * y);
+}
+
+constexpr float Vector2::dot(const Vector2& a, const Vector2& b) {
+    return (a.x * b.x + a.y * b.y);
+}
+
+constexpr float Vector2::cross(const Vector2& a, const Vector2& b) {
+    return (a.x * b.y - a.y * b.x);
+}
+
+inline constexpr Vector2 Vector2::zero(0.f, 0.f);
+inline constexpr Vector2 Vector2::right(1.f, 0.f);
+inline constexpr Vector2 Vector2::up(0.f, -1.f);
+inline constexpr Vector2 Vector2::left(-1.f, 0.f);
+inline constexpr Vector2 Vector2::down(0.f, 1.f);
+inline constexpr Vector2 Vector2::one(1.f, 1.f);
@@ -1,98 +1,9 @@
 ﻿#include "Vector3.h"
 #include "Math.h"
 #include "Matrix4.h"
+#include "SIMD.h"
 #include "Vector2.h"
 
-Vector3::Vector3() :
-    x(0.f),
-    y(0.f),
-    z(0.f) {
-}
-
-Vector3::Vector3(float inX, float inY, float inZ) :
-    x(inX),
-    y(inY),
-    z(inZ) {
-}
-
-Vector3::Vector3(const Vector2& vec2, float inZ) :
-    x(vec2.x),
-    y(vec2.y),
-    z(inZ) {
-}
-
-void Vector3::set(float inX, float inY, float inZ) {
-    x = inX;
-    y = inY;
-    z = inZ;
-}
-
-Vector3& Vector3::operator=(const Vector3& vec) {
-    x = vec.x;
-    y = vec.y;
-    z = vec.z;
-    return *this;
-}
-
-Vector3 Vector3::operator-() {
-    return Vector3(-x, -y, -z);
-}
-
-Vector3 operator+(const Vector3& a, const Vector3& b) {
-    return Vector3(a.x + b.x, a.y + b.y, a.z + b.z);
-}
-
-Vector3 operator-(const Vector3& a, const Vector3& b) {
-    return Vector3(a.x - b.x, a.y - b.y, a.z - b.z);
-}
-
-Vector3 operator*(const Vector3& left, const Vector3& right) {
-    return Vector3(left.x * right.x, left.y * right.y, left.z * right.z);
-}
-
-Vector3 operator*(const Vector3& vec, float scalar) {
-    return Vector3(vec.x * scalar, vec.y * scalar, vec.z * scalar);
-}
-
-Vector3 operator*(float scalar, const Vector3& vec) {
-    return Vector3(vec.x * scalar, vec.y * scalar, vec.z * scalar);
-}
-
-Vector3 operator/(const Vector3& vec, float scalar) {
-    if (scalar == 0) {
-        return vec;
-    }
-    return Vector3(vec.x / scalar, vec.y / scalar, vec.z / scalar);
-}
-
-Vector3& Vector3::operator*=(float scalar) {
-    x *= scalar;
-    y *= scalar;
-    z *= scalar;
-    return *this;
-}
-
-Vector3& Vector3::operator*=(const Vector3& right) {
-    x *= right.x;
-    y *= right.y;
-    z *= right.z;
-    return *this;
-}
-
-Vector3& Vector3::operator+=(const Vector3& right) {
-    x += right.x;
-    y += right.y;
-    z += right.z;
-    return *this;
-}
-
-Vector3& Vector3::operator-=(const Vector3& right) {
-    x -= right.x;
-    y -= right.y;
-    z -= right.z;
-    return *this;
-}
-
 bool Vector3::equal(const Vector3& right) const {
     return (Math::equal(x, right.x) && Math::equal(y, right.y) && Math::equal(z, right.z));
 }
@@ -101,10 +12,6 @@ bool Vector3::equal(const Vector3& left, const Vector3& right) {
     return (Math::equal(left.x, right.x) && Math::equal(left.y, right.y) && Math::equal(left.z, right.z));
 }
 
-float Vector3::lengthSq() const {
-    return (x * x + y * y + z * z);
-}
-
 float Vector3::length() const {
     return (Math::sqrt(lengthSq()));
 }
@@ -144,18 +51,6 @@ Vector3 Vector3::normalize(const Vector3& vec) {
     return temp;
 }
 
-float Vector3::dot(const Vector3& a, const Vector3& b) {
-    return (a.x * b.x + a.y * b.y + a.z * b.z);
-}
-
-Vector3 Vector3::cross(const Vector3& a, const Vector3& b) {
-    return Vector3(
-        a.y * b.z - a.z * b.y,
-        a.z * b.x - a.x * b.z,
-        a.x * b.y - a.y * b.x
-    );
-}
-
 Vector3 Vector3::lerp(const Vector3& a, const Vector3& b, float f) {
     return Vector3(a + f * (b - a));
 }
@@ -194,14 +89,99 @@ Vector3 Vector3::transform(const Vector3& v, const Quaternion& q) {
     return retVal;
 }
 
-const Vector3 Vector3::zero(0.f, 0.f, 0.f);
-const Vector3 Vector3::right(1.f, 0.f, 0.f);
-const Vector3 Vector3::up(0.f, 1.f, 0.f);
-const Vector3 Vector3::forward(0.f, 0.f, 1.f);
-const Vector3 Vector3::left(-1.f, 0.f, 0.f);
-const Vector3 Vector3::down(0.f, -1.f, 0.f);
-const Vector3 Vector3::back(0.f, 0.f, -1.f);
-const Vector3 Vector3::one(1.f, 1.f, 1.f);
-const Vector3 Vector3::negOne(-1.f, -1.f, -1.f);
-const Vector3 Vector3::infinity(Math::infinity, Math::infinity, Math::infinity);
-const Vector3 Vector3::negInfinity(Math::negInfinity, Math::negInfinity, Math::negInfinity);
+void Vector3::transformArray(const Vector3* in, Vector3* out, size_t count, const Matrix4& mat, size_t inStride) {
+    transformStream(in, out, count, mat, inStride, 1.f);
+}
+
+void Vector3::transformNormalArray(const Vector3* in, Vector3* out, size_t count, const Matrix4& mat, size_t inStride) {
+    transformStream(in, out, count, mat, inStride, 0.f);
+}
+
+void Vector3::transformArray(const float* inX, const float* inY, const float* inZ, float* outX, float* outY, float* outZ, size_t count, const Matrix4& mat) {
+    transformStream(inX, inY, inZ, outX, outY, outZ, count, mat, 1.f);
+}
+
+void Vector3::transformNormalArray(const float* inX, const float* inY, const float* inZ, float* outX, float* outY, float* outZ, size_t count, const Matrix4& mat) {
+    transformStream(inX, inY, inZ, outX, outY, outZ, count, mat, 0.f);
+}
+
+void Vector3::transformStream(const Vector3* in, Vector3* out, size_t count, const Matrix4& mat, size_t inStride, float w) {
+    const auto* src = reinterpret_cast<const char*>(in);
+
+#ifdef MATH_SSE
+    //行列の各行を読み込んでおき、1点を4レーンで計算する
+    auto r0 = _mm_loadu_ps(mat.m[0]);
+    auto r1 = _mm_loadu_ps(mat.m[1]);
+    auto r2 = _mm_loadu_ps(mat.m[2]);
+    auto r3 = _mm_mul_ps(_mm_loadu_ps(mat.m[3]), _mm_set1_ps(w));
+
+    for (size_t i = 0; i < count; ++i) {
+        const auto* v = reinterpret_cast<const Vector3*>(src + i * inStride);
+        auto r = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(_mm_set1_ps(v->x), r0), _mm_mul_ps(_mm_set1_ps(v->y), r1)),
+            _mm_add_ps(_mm_mul_ps(_mm_set1_ps(v->z), r2), r3)
+        );
+
+        //隣の要素を壊さないようにxyzの12バイトだけ書き込む
+        _mm_storel_pi(reinterpret_cast<__m64*>(&out[i].x), r);
+        _mm_store_ss(&out[i].z, _mm_movehl_ps(r, r));
+    }
+#else
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = transform(*reinterpret_cast<const Vector3*>(src + i * inStride), mat, w);
+    }
+#endif // MATH_SSE
+}
+
+void Vector3::transformStream(const float* inX, const float* inY, const float* inZ, float* outX, float* outY, float* outZ, size_t count, const Matrix4& mat, float w) {
+    const auto& m = mat.m;
+    size_t i = 0;
+
+#if defined(MATH_AVX)
+    //8点ずつ計算する
+    auto m00 = _mm256_set1_ps(m[0][0]), m01 = _mm256_set1_ps(m[0][1]), m02 = _mm256_set1_ps(m[0][2]);
+    auto m10 = _mm256_set1_ps(m[1][0]), m11 = _mm256_set1_ps(m[1][1]), m12 = _mm256_set1_ps(m[1][2]);
+    auto m20 = _mm256_set1_ps(m[2][0]), m21 = _mm256_set1_ps(m[2][1]), m22 = _mm256_set1_ps(m[2][2]);
+    auto m30 = _mm256_set1_ps(m[3][0] * w), m31 = _mm256_set1_ps(m[3][1] * w), m32 = _mm256_set1_ps(m[3][2] * w);
+
+    for (; i + 8 <= count; i += 8) {
+        auto x = _mm256_loadu_ps(inX + i);
+        auto y = _mm256_loadu_ps(inY + i);
+        auto z = _mm256_loadu_ps(inZ + i);
+        auto ox = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, m00), _mm256_mul_ps(y, m10)), _mm256_add_ps(_mm256_mul_ps(z, m20), m30));
+        auto oy = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, m01), _mm256_mul_ps(y, m11)), _mm256_add_ps(_mm256_mul_ps(z, m21), m31));
+        auto oz = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, m02), _mm256_mul_ps(y, m12)), _mm256_add_ps(_mm256_mul_ps(z, m22), m32));
+        _mm256_storeu_ps(outX + i, ox);
+        _mm256_storeu_ps(outY + i, oy);
+        _mm256_storeu_ps(outZ + i, oz);
+    }
+#elif defined(MATH_SSE)
+    //4点ずつ計算する
+    auto m00 = _mm_set1_ps(m[0][0]), m01 = _mm_set1_ps(m[0][1]), m02 = _mm_set1_ps(m[0][2]);
+    auto m10 = _mm_set1_ps(m[1][0]), m11 = _mm_set1_ps(m[1][1]), m12 = _mm_set1_ps(m[1][2]);
+    auto m20 = _mm_set1_ps(m[2][0]), m21 = _mm_set1_ps(m[2][1]), m22 = _mm_set1_ps(m[2][2]);
+    auto m30 = _mm_set1_ps(m[3][0] * w), m31 = _mm_set1_ps(m[3][1] * w), m32 = _mm_set1_ps(m[3][2] * w);
+
+    for (; i + 4 <= count; i += 4) {
+        auto x = _mm_loadu_ps(inX + i);
+        auto y = _mm_loadu_ps(inY + i);
+        auto z = _mm_loadu_ps(inZ + i);
+        auto ox = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m00), _mm_mul_ps(y, m10)), _mm_add_ps(_mm_mul_ps(z, m20), m30));
+        auto oy = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m01), _mm_mul_ps(y, m11)), _mm_add_ps(_mm_mul_ps(z, m21), m31));
+        auto oz = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m02), _mm_mul_ps(y, m12)), _mm_add_ps(_mm_mul_ps(z, m22), m32));
+        _mm_storeu_ps(outX + i, ox);
+        _mm_storeu_ps(outY + i, oy);
+        _mm_storeu_ps(outZ + i, oz);
+    }
+#endif // MATH_AVX
+
+    //残りはスカラーで計算する
+    for (; i < count; ++i) {
+        auto x = inX[i];
+        auto y = inY[i];
+        auto z = inZ[i];
+        outX[i] = x * m[0][0] + y * m[1][0] + z * m[2][0] + w * m[3][0];
+        outY[i] = x * m[0][1] + y * m[1][1] + z * m[2][1] + w * m[3][1];
+        outZ[i] = x * m[0][2] + y * m[1][2] + z * m[2][2] + w * m[3][2];
+    }
+}
@@ -1,6 +1,9 @@
 ﻿#pragma once
 
-class Vector2;
+#include "MathUtility.h"
+#include "Vector2.h"
+#include <cstddef>
+
 class Matrix4;
 class Quaternion;
 
@@ -11,46 +14,51 @@ public:
     float z;
 
 public:
-    Vector3();
+    constexpr Vector3();
 
-    explicit Vector3(float inX, float inY, float inZ);
+    constexpr explicit Vector3(float inX, float inY, float inZ);
 
-    Vector3(const Vector2& vec2, float inZ);
+    constexpr Vector3(const Vector2& vec2, float inZ);
 
     // Set all three components in one line
-    void set(float inX, float inY, float inZ);
+    constexpr void set(float inX, float inY, float inZ);
+
+    constexpr Vector3& operator=(const Vector3& vec);
+
+    constexpr Vector3 operator-() const;
 
-    Vector3& operator=(const Vector3& vec);
+    // Access the component by axis index (0 = x, 1 = y, 2 = z)
+    constexpr float& operator[](int index);
 
-    Vector3 operator-();
+    constexpr float operator[](int index) const;
 
     // Vector addition (a + b)
-    friend Vector3 operator+(const Vector3& a, const Vector3& b);
+    friend constexpr Vector3 operator+(const Vector3& a, const Vector3& b);
 
     // Vector subtraction (a - b)
-    friend Vector3 operator-(const Vector3& a, const Vector3& b);
+    friend constexpr Vector3 operator-(const Vector3& a, const Vector3& b);
 
     // Component-wise multiplication
-    friend Vector3 operator*(const Vector3& left, const Vector3& right);
+    friend constexpr Vector3 operator*(const Vector3& left, const Vector3& right);
 
     // Scalar multiplication
-    friend Vector3 operator*(const Vector3& vec, float scalar);
+    friend constexpr Vector3 operator*(const Vector3& vec, float scalar);
 
     // Scalar multiplication
-    friend Vector3 operator*(float scalar, const Vector3& vec);
+    friend constexpr Vector3 operator*(float scalar, const Vector3& vec);
 
-    friend Vector3 operator/(const Vector3& vec, float scalar);
+    friend constexpr Vector3 operator/(const Vector3& vec, float scalar);
 
     // Scalar *=
-    Vector3& operator*=(float scalar);
+    constexpr Vector3& operator*=(float scalar);
 
-    Vector3& operator*=(const Vector3& right);
+    constexpr Vector3& operator*=(const Vector3& right);
 
     // Vector +=
-    Vector3& operator+=(const Vector3& right);
+    constexpr Vector3& operator+=(const Vector3& right);
 
     // Vector -=
-    Vector3& operator-=(const Vector3& right);
+    constexpr Vector3& operator-=(const Vector3& right);
 
     //ほぼ同じ値のVector3か
     bool equal(const Vector3& right) const;
@@ -58,7 +66,7 @@ public:
     static bool equal(const Vector3& left, const Vector3& right);
 
     // Length squared of vector
-    float lengthSq() const;
+    constexpr float lengthSq() const;
 
     // Length of vector
     float length() const;
@@ -76,10 +84,10 @@ public:
     static Vector3 normalize(const Vector3& vec);
 
     // Dot product between two vectors (a dot b)
-    static float dot(const Vector3& a, const Vector3& b);
+    static constexpr float dot(const Vector3& a, const Vector3& b);
 
     // Cross product between two vectors (a cross b)
-    static Vector3 cross(const Vector3& a, const Vector3& b);
+    static constexpr Vector3 cross(const Vector3& a, const Vector3& b);
 
     // Lerp from A to B by f
     static Vector3 lerp(const Vector3& a, const Vector3& b, float f);
@@ -94,6 +102,16 @@ public:
     // Transform a Vector3 by a quaternion
     static Vector3 transform(const Vector3& v, const Quaternion& q);
 
+    //連続した点にまとめて行列を掛ける inとoutは同じ配列でもよい
+    //inStrideは入力の要素間のバイト数 頂点構造体の座標を直接渡せる
+    static void transformArray(const Vector3* in, Vector3* out, size_t count, const Matrix4& mat, size_t inStride = sizeof(Vector3));
+    //平行移動を無視して連続した方向ベクトルに行列を掛ける
+    static void transformNormalArray(const Vector3* in, Vector3* out, size_t count, const Matrix4& mat, size_t inStride = sizeof(Vector3));
+    //SoA配列の点にまとめて行列を掛ける
+    static void transformArray(const float* inX, const float* inY, const float* inZ, float* outX, float* outY, float* outZ, size_t count, const Matrix4& mat);
+    //平行移動を無視してSoA配列の方向ベクトルに行列を掛ける
+    static void transformNormalArray(const float* inX, const float* inY, const float* inZ, float* outX, float* outY, float* outZ, size_t count, const Matrix4& mat);
+
     static const Vector3 zero;
     static const Vector3 right;
     static const Vector3 up;
@@ -105,4 +123,135 @@ public:
     static const Vector3 negOne;
     static const Vector3 infinity;
     static const Vector3 negInfinity;
+
+private:
+    //w成分を指定して配列に行列を掛ける
+    static void transformStream(const Vector3* in, Vector3* out, size_t count, const Matrix4& mat, size_t inStride, float w);
+    static void transformStream(const float* inX, const float* inY, const float* inZ, float* outX, float* outY, float* outZ, size_t count, const Matrix4& mat, float w);
 };
+
+constexpr Vector3::Vector3() :
+    x(0.f),
+    y(0.f),
+    z(0.f) {
+}
+
+constexpr Vector3::Vector3(float inX, float inY, float inZ) :
+    x(inX),
+    y(inY),
+    z(inZ) {
+}
+
+constexpr Vector3::Vector3(const Vector2& vec2, float inZ) :
+    x(vec2.x),
+    y(vec2.y),
+    z(inZ) {
+}
+
+constexpr void Vector3::set(float inX, float inY, float inZ) {
+    x = inX;
+    y = inY;
+    z = inZ;
+}
+
+constexpr Vector3& Vector3::operator=(const Vector3& vec) {
+    x = vec.x;
+    y = vec.y;
+    z = vec.z;
+    return *this;
+}
+
+constexpr Vector3 Vector3::operator-() const {
+    return Vector3(-x, -y, -z);
+}
+
+constexpr float& Vector3::operator[](int index) {
+    return (index == 0) ? x : (index == 1) ? y : z;
+}
+
+constexpr float Vector3::operator[](int index) const {
+    return (index == 0) ? x : (index == 1) ? y : z;
+}
+
+constexpr Vector3 operator+(const Vector3& a, const Vector3& b) {
+    return Vector3(a.x + b.x, a.y + b.y, a.z + b.z);
+}
+
+constexpr Vector3 operator-(const Vector3& a, const Vector3& b) {
+    return Vector3(a.x - b.x, a.y - b.y, a.z - b.z);
+}
+
+constexpr Vector3 operator*(const Vector3& left, const Vector3& right) {
+    return Vector3(left.x * right.x, left.y * right.y, left.z * right.z);
+}
+
+constexpr Vector3 operator*(const Vector3& vec, float scalar) {
+    return Vector3(vec.x * scalar, vec.y * scalar, vec.z * scalar);
+}
+
+constexpr Vector3 operator*(float scalar, const Vector3& vec) {
+    return Vector3(vec.x * scalar, vec.y * scalar, vec.z * scalar);
+}
+
+constexpr Vector3 operator/(const Vector3& vec, float scalar) {
+    if (scalar == 0) {
+        return vec;
+    }
+    return Vector3(vec.x / scalar, vec.y / scalar, vec.z / scalar);
+}
+
+constexpr Vector3& Vector3::operator*=(float scalar) {
+    x *= scalar;
+    y *= scalar;
+    z *= scalar;
+    return *this;
+}
+
+constexpr Vector3& Vector3::operator*=(const Vector3& right) {
+    x *= right.x;
+    y *= right.y;
+    z *= right.z;
+    return *this;
+}
+
+constexpr Vector3& Vector3::operator+=(const Vector3& right) {
+    x += right.x;
+    y += right.y;
+    z += right.z;
+    return *this;
+}
+
+constexpr Vector3& Vector3::operator-=(const Vector3& right) {
+    x -= right.x;
+    y -= right.y;
+    z -= right.z;
+    return *this;
+}
+
+constexpr float Vector3::lengthSq() const {
+    return (x * x + y * y + z * z);
+}
+
+constexpr float Vector3::dot(const Vector3& a, const Vector3& b) {
+    return (a.x * b.x + a.y * b.y + a.z * b.z);
+}
+
+constexpr Vector3 Vector3::cross(const Vector3& a, const Vector3& b) {
+    return Vector3(
+        a.y * b.z - a.z * b.y,
+        a.z * b.x - a.x * b.z,
+        a.x * b.y - a.y * b.x
+    );
+}
+
+inline constexpr Vector3 Vector3::zero(0.f, 0.f, 0.f);
+inline constexpr Vector3 Vector3::right(1.f, 0.f, 0.f);
+inline constexpr Vector3 Vector3::up(0.f, 1.f, 0.f);
+inline constexpr Vector3 Vector3::forward(0.f, 0.f, 1.f);
+inline constexpr Vector3 Vector3::left(-1.f, 0.f, 0.f);
+inline constexpr Vector3 Vector3::down(0.f, -1.f, 0.f);
+inline constexpr Vector3 Vector3::back(0.f, 0.f, -1.f);
+inline constexpr Vector3 Vector3::one(1.f, 1.f, 1.f);
+inline constexpr Vector3 Vector3::negOne(-1.f, -1.f, -1.f);
+inline constexpr Vector3 Vector3::infinity(Math::infinity, Math::infinity, Math::infinity);
+inline constexpr Vector3 Vector3::negInfinity(Math::negInfinity, Math::negInfinity, Math::negInfinity);
@@ -1,31 +1,130 @@
 ﻿#include "Vector4.h"
+#include "Matrix4.h"
+#include "SIMD.h"
 #include "Vector3.h"
 
-Vector4::Vector4() :
-    x(0.f),
-    y(0.f),
-    z(0.f),
-    w(0.f) {
-}
+void Vector4::transformArray(const Vector3* in, Vector4* out, size_t count, const Matrix4& mat, size_t inStride) {
+    const auto* src = reinterpret_cast<const char*>(in);
+    const auto& m = mat.m;
+
+#ifdef MATH_SSE
+    auto r0 = _mm_loadu_ps(m[0]);
+    auto r1 = _mm_loadu_ps(m[1]);
+    auto r2 = _mm_loadu_ps(m[2]);
+    auto r3 = _mm_loadu_ps(m[3]);
 
-Vector4::Vector4(float inX, float inY, float inZ, float inW) :
-    x(inX),
-    y(inY),
-    z(inZ),
-    w(inW) {
+    for (size_t i = 0; i < count; ++i) {
+        const auto* v = reinterpret_cast<const Vector3*>(src + i * inStride);
+        auto r = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(_mm_set1_ps(v->x), r0), _mm_mul_ps(_mm_set1_ps(v->y), r1)),
+            _mm_add_ps(_mm_mul_ps(_mm_set1_ps(v->z), r2), r3)
+        );
+        _mm_storeu_ps(&out[i].x, r);
+    }
+#else
+    for (size_t i = 0; i < count; ++i) {
+        const auto& v = *reinterpret_cast<const Vector3*>(src + i * inStride);
+        out[i] = Vector4(
+            v.x * m[0][0] + v.y * m[1][0] + v.z * m[2][0] + m[3][0],
+            v.x * m[0][1] + v.y * m[1][1] + v.z * m[2][1] + m[3][1],
+            v.x * m[0][2] + v.y * m[1][2] + v.z * m[2][2] + m[3][2],
+            v.x * m[0][3] + v.y * m[1][3] + v.z * m[2][3] + m[3][3]
+        );
+    }
+#endif // MATH_SSE
 }
 
-Vector4::Vector4(const Vector3& vec3, float inW) :
-    x(vec3.x),
-    y(vec3.y),
-    z(vec3.z),
-    w(inW) {
+void Vector4::transformArray(const Vector4* in, Vector4* out, size_t count, const Matrix4& mat) {
+    const auto& m = mat.m;
+
+#ifdef MATH_SSE
+    auto r0 = _mm_loadu_ps(m[0]);
+    auto r1 = _mm_loadu_ps(m[1]);
+    auto r2 = _mm_loadu_ps(m[2]);
+    auto r3 = _mm_loadu_ps(m[3]);
+
+    for (size_t i = 0; i < count; ++i) {
+        auto v = _mm_loadu_ps(&in[i].x);
+        auto r = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)), r0), _mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)), r1)),
+            _mm_add_ps(_mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2)), r2), _mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3)), r3))
+        );
+        _mm_storeu_ps(&out[i].x, r);
+    }
+#else
+    for (size_t i = 0; i < count; ++i) {
+        auto v = in[i];
+        out[i] = Vector4(
+            v.x * m[0][0] + v.y * m[1][0] + v.z * m[2][0] + v.w * m[3][0],
+            v.x * m[0][1] + v.y * m[1][1] + v.z * m[2][1] + v.w * m[3][1],
+            v.x * m[0][2] + v.y * m[1][2] + v.z * m[2][2] + v.w * m[3][2],
+            v.x * m[0][3] + v.y * m[1][3] + v.z * m[2][3] + v.w * m[3][3]
+        );
+    }
+#endif // MATH_SSE
 }
 
-Vector4& Vector4::operator=(const Vector4& vec) {
-    x = vec.x;
-    y = vec.y;
-    z = vec.z;
-    w = vec.w;
-    return *this;
+void Vector4::transformArray(const float* inX, const float* inY, const float* inZ, const float* inW, float* outX, float* outY, float* outZ, float* outW, size_t count, const Matrix4& mat) {
+    const auto& m = mat.m;
+    size_t i = 0;
+
+#if defined(MATH_AVX)
+    //8要素ずつ計算する 出力の各成分は入力の4成分と行列の1列の内積
+    __m256 col[4][4];
+    for (int r = 0; r < 4; ++r) {
+        for (int c = 0; c < 4; ++c) {
+            col[c][r] = _mm256_set1_ps(m[r][c]);
+        }
+    }
+    float* outs[4] = { outX, outY, outZ, outW };
+
+    for (; i + 8 <= count; i += 8) {
+        auto x = _mm256_loadu_ps(inX + i);
+        auto y = _mm256_loadu_ps(inY + i);
+        auto z = _mm256_loadu_ps(inZ + i);
+        auto w = _mm256_loadu_ps(inW + i);
+        for (int c = 0; c < 4; ++c) {
+            auto o = _mm256_add_ps(
+                _mm256_add_ps(_mm256_mul_ps(x, col[c][0]), _mm256_mul_ps(y, col[c][1])),
+                _mm256_add_ps(_mm256_mul_ps(z, col[c][2]), _mm256_mul_ps(w, col[c][3]))
+            );
+            _mm256_storeu_ps(outs[c] + i, o);
+        }
+    }
+#elif defined(MATH_SSE)
+    //4要素ずつ計算する 出力の各成分は入力の4成分と行列の1列の内積
+    __m128 col[4][4];
+    for (int r = 0; r < 4; ++r) {
+        for (int c = 0; c < 4; ++c) {
+            col[c][r] = _mm_set1_ps(m[r][c]);
+        }
+    }
+    float* outs[4] = { outX, outY, outZ, outW };
+
+    for (; i + 4 <= count; i += 4) {
+        auto x = _mm_loadu_ps(inX + i);
+        auto y = _mm_loadu_ps(inY + i);
+        auto z = _mm_loadu_ps(inZ + i);
+        auto w = _mm_loadu_ps(inW + i);
+        for (int c = 0; c < 4; ++c) {
+            auto o = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(x, col[c][0]), _mm_mul_ps(y, col[c][1])),
+                _mm_add_ps(_mm_mul_ps(z, col[c][2]), _mm_mul_ps(w, col[c][3]))
+            );
+            _mm_storeu_ps(outs[c] + i, o);
+        }
+    }
+#endif // MATH_AVX
+
+    //残りはスカラーで計算する
+    for (; i < count; ++i) {
+        auto x = inX[i];
+        auto y = inY[i];
+        auto z = inZ[i];
+        auto w = inW[i];
+        outX[i] = x * m[0][0] + y * m[1][0] + z * m[2][0] + w * m[3][0];
+        outY[i] = x * m[0][1] + y * m[1][1] + z * m[2][1] + w * m[3][1];
+        outZ[i] = x * m[0][2] + y * m[1][2] + z * m[2][2] + w * m[3][2];
+        outW[i] = x * m[0][3] + y * m[1][3] + z * m[2][3] + w * m[3][3];
+    }
 }
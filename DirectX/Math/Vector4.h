@@ -1,6 +1,9 @@
 ﻿#pragma once
 
-class Vector3;
+#include "Vector3.h"
+#include <cstddef>
+
+class Matrix4;
 
 class Vector4 {
 public:
@@ -10,11 +13,48 @@ public:
     float w;
 
 public:
-    Vector4();
+    constexpr Vector4();
+
+    constexpr explicit Vector4(float inX, float inY, float inZ, float inW);
 
-    explicit Vector4(float inX, float inY, float inZ, float inW);
+    constexpr Vector4(const Vector3& vec3, float inW);
 
-    Vector4(const Vector3& vec3, float inW);
+    constexpr Vector4& operator=(const Vector4& vec);
 
-    Vector4& operator=(const Vector4& vec);
+    //w=1の点にまとめて行列を掛け、wで割らずに同次座標のまま返す
+    //inStrideは入力の要素間のバイト数 頂点構造体の座標を直接渡せる
+    static void transformArray(const Vector3* in, Vector4* out, size_t count, const Matrix4& mat, size_t inStride = sizeof(float) * 3);
+    //連続したベクトルにまとめて行列を掛ける inとoutは同じ配列でもよい
+    static void transformArray(const Vector4* in, Vector4* out, size_t count, const Matrix4& mat);
+    //SoA配列のベクトルにまとめて行列を掛ける
+    static void transformArray(const float* inX, const float* inY, const float* inZ, const float* inW, float* outX, float* outY, float* outZ, float* outW, size_t count, const Matrix4& mat);
 };
+
+constexpr Vector4::Vector4() :
+    x(0.f),
+    y(0.f),
+    z(0.f),
+    w(0.f) {
+}
+
+constexpr Vector4::Vector4(float inX, float inY, float inZ, float inW) :
+    x(inX),
+    y(inY),
+    z(inZ),
+    w(inW) {
+}
+
+constexpr Vector4::Vector4(const Vector3& vec3, float inW) :
+    x(vec3.x),
+    y(vec3.y),
+    z(vec3.z),
+    w(inW) {
+}
+
+constexpr Vector4& Vector4::operator=(const Vector4& vec) {
+    x = vec.x;
+    y = vec.y;
+    z = vec.z;
+    w = vec.w;
+    return *this;
+}
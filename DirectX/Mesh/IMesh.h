@@ -5,6 +5,11 @@
 #include "Material.h"
 #include <vector>
 
+struct AABB;
+struct Sphere;
+class ConvexHull;
+class TriangleBVH;
+
 //外部公開用メッシュインターフェース
 class IMesh {
 public:
@@ -17,4 +22,16 @@ public:
     virtual const MeshVertices& getMeshVertices(unsigned index) const = 0;
     //ボーン配列を取得する
     virtual const std::vector<Bone>& getBones() const = 0;
+    //指定のメッシュを囲むオブジェクト空間のAABBを取得する
+    virtual const AABB& getAABB(unsigned index) const = 0;
+    //全メッシュを囲むオブジェクト空間のAABBを取得する
+    virtual const AABB& getAABB() const = 0;
+    //指定のメッシュを囲むオブジェクト空間の球を取得する
+    virtual const Sphere& getSphere(unsigned index) const = 0;
+    //全メッシュを囲むオブジェクト空間の球を取得する
+    virtual const Sphere& getSphere() const = 0;
+    //オブジェクト空間の三角形BVHを取得する
+    virtual const TriangleBVH& getTriangleBVH() const = 0;
+    //オブジェクト空間の凸包を取得する
+    virtual const ConvexHull& getConvexHull() const = 0;
 };
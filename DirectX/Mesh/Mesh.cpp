@@ -1,13 +1,19 @@
 ﻿#include "Mesh.h"
 #include "OBJ.h"
 #include "FBX/FBX.h"
+#include "../Collision/ConvexHull.h"
+#include "../Collision/TriangleBVH.h"
 #include "../DebugLayer/Debug.h"
 #include "../DirectX/DirectXInclude.h"
 #include "../Utility/FileUtil.h"
 #include <cassert>
 
 Mesh::Mesh() :
-    mMesh(nullptr) {
+    mMesh(nullptr),
+    mAABB(Vector3::zero, Vector3::zero),
+    mSphere(Vector3::zero, 0.f),
+    mTriangleBVH(std::make_unique<TriangleBVH>()),
+    mConvexHull(std::make_unique<ConvexHull>()) {
 }
 
 Mesh::~Mesh() = default;
@@ -28,6 +34,30 @@ const std::vector<Bone>& Mesh::getBones() const {
     return mBones;
 }
 
+const AABB& Mesh::getAABB(unsigned index) const {
+    return mAABBs[index];
+}
+
+const AABB& Mesh::getAABB() const {
+    return mAABB;
+}
+
+const Sphere& Mesh::getSphere(unsigned index) const {
+    return mSpheres[index];
+}
+
+const Sphere& Mesh::getSphere() const {
+    return mSphere;
+}
+
+const TriangleBVH& Mesh::getTriangleBVH() const {
+    return *mTriangleBVH;
+}
+
+const ConvexHull& Mesh::getConvexHull() const {
+    return *mConvexHull;
+}
+
 void Mesh::loadMesh(const std::string& filePath) {
     //すでに生成済みなら終了する
     if (mMesh) {
@@ -60,6 +90,14 @@ void Mesh::initialize(const std::string& filePath) {
         createVertexBuffer(i);
         createIndexBuffer(i);
     }
+
+    //カリングやコライダー作成で使う境界を求めておく
+    computeBounds();
+
+    //レイ判定用のBVHを頂点から1度だけ構築する
+    mTriangleBVH->build(mMeshesVertices);
+    //凸形状同士の判定用の凸包も1度だけ構築する
+    mConvexHull->build(mMeshesVertices);
 }
 
 void Mesh::createMesh(const std::string& filePath) {
@@ -102,3 +140,50 @@ void Mesh::createIndexBuffer(unsigned meshIndex) {
 
     mIndexBuffers.emplace_back(std::make_unique<IndexBuffer>(bd, sub));
 }
+
+void Mesh::computeBounds() {
+    mAABBs.resize(mMeshesVertices.size());
+    mSpheres.resize(mMeshesVertices.size());
+    AABB all;
+
+    for (size_t i = 0; i < mMeshesVertices.size(); ++i) {
+        const auto& meshVertices = mMeshesVertices[i];
+        if (meshVertices.empty()) {
+            mAABBs[i] = AABB(Vector3::zero, Vector3::zero);
+            mSpheres[i] = Sphere(Vector3::zero, 0.f);
+            continue;
+        }
+
+        AABB aabb;
+        for (const auto& v : meshVertices) {
+            aabb.updateMinMax(v.pos);
+        }
+        mAABBs[i] = aabb;
+        all.updateMinMax(aabb.min);
+        all.updateMinMax(aabb.max);
+
+        //AABBの中心から最も遠い頂点までを半径にする
+        auto center = (aabb.min + aabb.max) / 2.f;
+        float radiusSq = 0.f;
+        for (const auto& v : meshVertices) {
+            radiusSq = Math::Max(radiusSq, (v.pos - center).lengthSq());
+        }
+        mSpheres[i] = Sphere(center, Math::sqrt(radiusSq));
+    }
+
+    if (mMeshesVertices.empty() || all.min.x > all.max.x) {
+        mAABB = AABB(Vector3::zero, Vector3::zero);
+        mSphere = Sphere(Vector3::zero, 0.f);
+        return;
+    }
+
+    mAABB = all;
+    auto center = (all.min + all.max) / 2.f;
+    float radiusSq = 0.f;
+    for (const auto& meshVertices : mMeshesVertices) {
+        for (const auto& v : meshVertices) {
+            radiusSq = Math::Max(radiusSq, (v.pos - center).lengthSq());
+        }
+    }
+    mSphere = Sphere(center, Math::sqrt(radiusSq));
+}
@@ -4,12 +4,16 @@
 #include "IMesh.h"
 #include "IMeshLoader.h"
 #include "Material.h"
+#include "../Collision/AABB.h"
+#include "../Collision/Sphere.h"
 #include <memory>
 #include <string>
 #include <vector>
 
 class VertexBuffer;
 class IndexBuffer;
+class TriangleBVH;
+class ConvexHull;
 
 class Mesh : public IMesh {
 public:
@@ -24,6 +28,18 @@ public:
     virtual const MeshVertices& getMeshVertices(unsigned index) const override;
     //ボーン配列を取得する
     virtual const std::vector<Bone>& getBones() const override;
+    //指定のメッシュを囲むオブジェクト空間のAABBを取得する
+    virtual const AABB& getAABB(unsigned index) const override;
+    //全メッシュを囲むオブジェクト空間のAABBを取得する
+    virtual const AABB& getAABB() const override;
+    //指定のメッシュを囲むオブジェクト空間の球を取得する
+    virtual const Sphere& getSphere(unsigned index) const override;
+    //全メッシュを囲むオブジェクト空間の球を取得する
+    virtual const Sphere& getSphere() const override;
+    //オブジェクト空間の三角形BVHを取得する
+    virtual const TriangleBVH& getTriangleBVH() const override;
+    //オブジェクト空間の凸包を取得する
+    virtual const ConvexHull& getConvexHull() const override;
 
     //ファイル名からメッシュを生成する
     void loadMesh(const std::string& filePath);
@@ -39,10 +55,21 @@ private:
     void createVertexBuffer(unsigned meshIndex);
     //インデックスバッファを生成する
     void createIndexBuffer(unsigned meshIndex);
+    //頂点から各メッシュと全体の境界を求める
+    void computeBounds();
 
 private:
     std::unique_ptr<IMeshLoader> mMesh;
     std::vector<MeshVertices> mMeshesVertices;
+    //読み込み時に1度だけ求める境界
+    std::vector<AABB> mAABBs;
+    AABB mAABB;
+    std::vector<Sphere> mSpheres;
+    Sphere mSphere;
+    //頂点から構築したレイ判定用のBVH
+    std::unique_ptr<TriangleBVH> mTriangleBVH;
+    //頂点から構築したGJK/EPA用の凸包
+    std::unique_ptr<ConvexHull> mConvexHull;
     std::vector<Indices> mMeshesIndices;
     std::vector<Material> mMaterials;
     std::vector<Bone> mBones;
@@ -1,10 +1,14 @@
 ﻿#include "MeshManager.h"
+#include "OcclusionCuller.h"
+#include "../Collision/Intersect.h"
 #include "../Component/Camera/Camera.h"
 #include "../Component/Mesh/MeshComponent.h"
 #include "../DirectX/DirectXInclude.h"
 #include "../Transform/Transform3D.h"
+#include <algorithm>
 
-MeshManager::MeshManager() {
+MeshManager::MeshManager(ThreadPool& threadPool) :
+    mOcclusionCuller(std::make_unique<OcclusionCuller>(threadPool)) {
     MeshComponent::setMeshManager(this);
 }
 
@@ -12,20 +16,18 @@ MeshManager::~MeshManager() {
     MeshComponent::setMeshManager(nullptr);
 }
 
-void MeshManager::update() {
+void MeshManager::update(const Camera& camera) {
     remove();
+    cull(camera);
+    occlusionCull(camera);
 }
 
 void MeshManager::draw(const Camera& camera, const DirectionalLight& dirLight) const {
-    if (mMeshes.empty()) {
+    if (mVisibleMeshes.empty()) {
         return;
     }
 
-    for (const auto& mesh : mMeshes) {
-        if (!isDraw(*mesh, camera)) {
-            continue;
-        }
-
+    for (const auto& mesh : mVisibleMeshes) {
         //MyDirectX::DirectX::instance().rasterizerState()->setCulling(CullMode::FRONT);
         //mesh->draw(camera, dirLight);
 
@@ -40,6 +42,10 @@ void MeshManager::add(const MeshPtr& mesh) {
 
 void MeshManager::clear() {
     mMeshes.clear();
+    mCullMeshes.clear();
+    mBounds.clear();
+    mVisibleIndices.clear();
+    mVisibleMeshes.clear();
 }
 
 void MeshManager::remove() {
@@ -53,18 +59,65 @@ void MeshManager::remove() {
     }
 }
 
-bool MeshManager::isDraw(const MeshComponent& mesh, const Camera& camera) const {
+void MeshManager::cull(const Camera& camera) {
+    //描画対象の境界球をSoAに詰める
+    mCullMeshes.clear();
+    mBounds.clear();
+    for (const auto& mesh : mMeshes) {
+        if (!isDraw(*mesh)) {
+            continue;
+        }
+        mCullMeshes.emplace_back(mesh.get());
+        mBounds.add(computeWorldSphere(*mesh));
+    }
+
+    //視錐台とまとめて判定する
+    mVisibleIndices.clear();
+    Intersect::intersectFrustumSpheres(camera.getFrustum(), mBounds, mVisibleIndices);
+
+    mVisibleMeshes.clear();
+    for (const auto& index : mVisibleIndices) {
+        mVisibleMeshes.emplace_back(mCullMeshes[index]);
+    }
+}
+
+void MeshManager::occlusionCull(const Camera& camera) {
+    //視錐台の内側にあるオクルーダーの深度を描く
+    mOcclusionCuller->begin(camera.getViewProjection());
+    for (const auto& mesh : mVisibleMeshes) {
+        if (!mesh->isOccluder()) {
+            continue;
+        }
+        const auto& m = mesh->getMesh();
+        const auto& world = mesh->transform().getWorldTransform();
+        for (unsigned i = 0; i < m.getMeshCount(); ++i) {
+            mOcclusionCuller->addOccluder(m.getMeshVertices(i), world);
+        }
+    }
+    if (!mOcclusionCuller->hasOccluder()) {
+        return;
+    }
+    mOcclusionCuller->rasterize();
+
+    //オクルーダー自身は深度が等しいので残る
+    auto itr = std::remove_if(mVisibleMeshes.begin(), mVisibleMeshes.end(), [&](const MeshComponent* mesh) {
+        return !mOcclusionCuller->isVisible(mesh->getMesh().getAABB(), mesh->transform().getWorldTransform());
+    });
+    mVisibleMeshes.erase(itr, mVisibleMeshes.end());
+}
+
+bool MeshManager::isDraw(const MeshComponent& mesh) const {
     if (!mesh.getActive()) {
         return false;
     }
     if (mesh.isDead()) {
         return false;
     }
-    //auto pos = mesh.transform().getPosition();
-    //auto radius = mesh.getMesh().getRadius() * mesh.transform().getScale().x;
-    //if (!camera.viewFrustumCulling(pos, radius)) {
-    //    return false;
-    //}
 
     return true;
 }
+
+Sphere MeshManager::computeWorldSphere(const MeshComponent& mesh) {
+    //読み込み時に求めてあるオブジェクト空間の球をワールド行列で移す
+    return mesh.getMesh().getSphere().transform(mesh.transform().getWorldTransform());
+}
@@ -1,20 +1,27 @@
 ﻿#pragma once
 
+#include "../Collision/Sphere.h"
+#include "../Collision/SphereArray.h"
 #include <list>
 #include <memory>
+#include <vector>
 
 class MeshComponent;
 class Camera;
 class DirectionalLight;
+class OcclusionCuller;
+class ThreadPool;
 
 class MeshManager {
     using MeshPtr = std::shared_ptr<MeshComponent>;
     using MeshPtrList = std::list<MeshPtr>;
 
 public:
-    MeshManager();
+    MeshManager(ThreadPool& threadPool);
     ~MeshManager();
-    void update();
+    //不要なメッシュを削除し、カメラから見えるメッシュを集める
+    void update(const Camera& camera);
+    //updateで集めたメッシュだけを描画する
     void draw(const Camera& camera, const DirectionalLight& dirLight) const;
     void add(const MeshPtr& mesh);
     void clear();
@@ -25,9 +32,24 @@ private:
 
     //不要なメッシュを削除する
     void remove();
+    //視錐台の内側にあるメッシュを集める
+    void cull(const Camera& camera);
+    //オクルーダーに隠れるメッシュを取り除く
+    void occlusionCull(const Camera& camera);
     //描画するか
-    bool isDraw(const MeshComponent& mesh, const Camera& camera) const;
+    bool isDraw(const MeshComponent& mesh) const;
+    //メッシュを囲むワールド空間の球を求める
+    static Sphere computeWorldSphere(const MeshComponent& mesh);
 
 private:
     MeshPtrList mMeshes;
+    std::unique_ptr<OcclusionCuller> mOcclusionCuller;
+    //カリング対象のメッシュ mBoundsと同じ並び
+    std::vector<const MeshComponent*> mCullMeshes;
+    //カリング対象の境界球
+    SphereArray mBounds;
+    //視錐台の内側にあった要素の番号
+    std::vector<unsigned> mVisibleIndices;
+    //描画するメッシュ
+    std::vector<const MeshComponent*> mVisibleMeshes;
 };
@@ -0,0 +1,55 @@
+﻿#include "MeshPicker.h"
+#include "../Collision/Intersect.h"
+#include "../Component/Mesh/MeshComponent.h"
+#include "../Transform/Transform3D.h"
+#include <algorithm>
+
+MeshPicker::MeshPicker() = default;
+
+MeshPicker::~MeshPicker() = default;
+
+bool MeshPicker::pick(const Ray& ray, const MeshPtrArray& meshes, MeshPtr& outMesh, RaycastHit& outHit, const MeshComponent* ignore) {
+    //読み込み時に求めてあるAABBをワールド空間に移し、まとめてレイと判定する
+    mBounds.clear();
+    for (const auto& mesh : meshes) {
+        mBounds.add(mesh->getMesh().getAABB().transform(mesh->transform().getWorldTransform()));
+    }
+    mEntryT.resize(meshes.size());
+    if (Intersect::intersectRayAABBs(ray, mBounds, mEntryT.data()) == 0) {
+        return false;
+    }
+
+    mCandidates.clear();
+    for (unsigned i = 0; i < meshes.size(); ++i) {
+        if (mEntryT[i] == Math::infinity) {
+            continue;
+        }
+        if (meshes[i].get() == ignore || meshes[i]->isDead()) {
+            continue;
+        }
+        mCandidates.emplace_back(mEntryT[i], i);
+    }
+    std::sort(mCandidates.begin(), mCandidates.end());
+
+    //AABBへの進入位置はメッシュとの交点の位置の下限
+    //それが今までで最も近い交点より奥なら、以降のメッシュは調べる必要がない
+    auto bestT = Math::infinity;
+    RaycastHit hit;
+    for (const auto& candidate : mCandidates) {
+        if (candidate.first > bestT) {
+            break;
+        }
+
+        const auto& mesh = meshes[candidate.second];
+        if (!Intersect::intersectRayMesh(ray, mesh->getMesh(), mesh->transform().getWorldTransform(), hit)) {
+            continue;
+        }
+        if (hit.t < bestT) {
+            bestT = hit.t;
+            outMesh = mesh;
+            outHit = hit;
+        }
+    }
+
+    return (bestT != Math::infinity);
+}
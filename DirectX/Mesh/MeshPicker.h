@@ -0,0 +1,36 @@
+﻿#pragma once
+
+#include "../Collision/AABBArray.h"
+#include "../Collision/Ray.h"
+#include "../Collision/RaycastHit.h"
+#include <memory>
+#include <utility>
+#include <vector>
+
+class MeshComponent;
+
+//レイと複数のメッシュから最も近い交点を探す
+//境界ボックスへの進入位置が近い順にポリゴンを調べ、次の進入位置より手前で交差した時点で打ち切る
+class MeshPicker {
+    using MeshPtr = std::shared_ptr<MeshComponent>;
+    using MeshPtrArray = std::vector<MeshPtr>;
+
+public:
+    MeshPicker();
+    ~MeshPicker();
+    //レイと最も近くで交差するメッシュを求める ignoreは判定から除く
+    //outHitのpointとnormalはワールド空間で返す
+    bool pick(const Ray& ray, const MeshPtrArray& meshes, MeshPtr& outMesh, RaycastHit& outHit, const MeshComponent* ignore = nullptr);
+
+private:
+    MeshPicker(const MeshPicker&) = delete;
+    MeshPicker& operator=(const MeshPicker&) = delete;
+
+private:
+    //各メッシュのワールド空間のAABB
+    AABBArray mBounds;
+    //各AABBへのレイの進入位置
+    std::vector<float> mEntryT;
+    //AABBと交差したメッシュの進入位置と番号 進入位置の近い順に並べる
+    std::vector<std::pair<float, unsigned>> mCandidates;
+};
@@ -0,0 +1,305 @@
+﻿#include "OcclusionCuller.h"
+#include "../Device/ThreadPool.h"
+#include "../Math/SIMD.h"
+#include <algorithm>
+#include <cmath>
+
+OcclusionCuller::OcclusionCuller(ThreadPool& threadPool) :
+    mThreadPool(threadPool),
+    mViewProjection(Matrix4::identity),
+    mWidth(0),
+    mHeight(0),
+    mTileCountX(0),
+    mTileCountY(0) {
+    resize(DEFAULT_WIDTH, DEFAULT_HEIGHT);
+}
+
+OcclusionCuller::~OcclusionCuller() = default;
+
+void OcclusionCuller::resize(int width, int height) {
+    mTileCountX = (Math::Max(width, 1) + TILE_SIZE - 1) / TILE_SIZE;
+    mTileCountY = (Math::Max(height, 1) + TILE_SIZE - 1) / TILE_SIZE;
+    mWidth = mTileCountX * TILE_SIZE;
+    mHeight = mTileCountY * TILE_SIZE;
+
+    mDepth.assign(mWidth * mHeight, 1.f);
+    mHiZ.assign((mWidth / BLOCK_SIZE) * (mHeight / BLOCK_SIZE), 1.f);
+    mTileBins.resize(mTileCountX * mTileCountY);
+    for (auto&& bin : mTileBins) {
+        bin.clear();
+    }
+    mTriangles.clear();
+}
+
+void OcclusionCuller::begin(const Matrix4& viewProjection) {
+    mViewProjection = viewProjection;
+    mTriangles.clear();
+    for (auto&& bin : mTileBins) {
+        bin.clear();
+    }
+}
+
+void OcclusionCuller::addOccluder(const MeshVertices& vertices, const Matrix4& world) {
+    const auto count = vertices.size() / 3 * 3;
+    if (count == 0) {
+        return;
+    }
+
+    //頂点構造体から座標だけを読んでまとめてクリップ座標に変換する
+    auto wvp = world * mViewProjection;
+    mClipVertices.resize(count);
+    Vector4::transformArray(&vertices[0].pos, mClipVertices.data(), count, wvp, sizeof(MeshVertex));
+
+    for (size_t i = 0; i < count; i += 3) {
+        addTriangle(mClipVertices[i], mClipVertices[i + 1], mClipVertices[i + 2]);
+    }
+}
+
+void OcclusionCuller::rasterize() {
+    //タイルごとに書き込む範囲が分かれているので排他は要らない
+    mThreadPool.parallelFor(mTileBins.size(), 1, [&](size_t begin, size_t end, unsigned) {
+        for (size_t i = begin; i < end; ++i) {
+            rasterizeTile(static_cast<unsigned>(i));
+        }
+    });
+}
+
+bool OcclusionCuller::isVisible(const AABB& aabb, const Matrix4& world) const {
+    //描いていなければ何も隠れない
+    if (mTriangles.empty()) {
+        return true;
+    }
+
+    //8つの角をスクリーンに投影して、覆う矩形と最も手前の深度を求める
+    Vector3 corners[8];
+    for (int i = 0; i < 8; ++i) {
+        corners[i] = Vector3(
+            (i & 1) ? aabb.max.x : aabb.min.x,
+            (i & 2) ? aabb.max.y : aabb.min.y,
+            (i & 4) ? aabb.max.z : aabb.min.z
+        );
+    }
+    Vector4 clips[8];
+    Vector4::transformArray(corners, clips, 8, world * mViewProjection);
+
+    auto minX = Math::infinity;
+    auto minY = Math::infinity;
+    auto maxX = Math::negInfinity;
+    auto maxY = Math::negInfinity;
+    auto minDepth = Math::infinity;
+    for (const auto& clip : clips) {
+        //近クリップ面をまたぐなら手前にあるので見える
+        if (clip.w <= NEAR_W) {
+            return true;
+        }
+        auto invW = 1.f / clip.w;
+        auto sx = (clip.x * invW * 0.5f + 0.5f) * mWidth;
+        auto sy = (0.5f - clip.y * invW * 0.5f) * mHeight;
+        minX = Math::Min(minX, sx);
+        minY = Math::Min(minY, sy);
+        maxX = Math::Max(maxX, sx);
+        maxY = Math::Max(maxY, sy);
+        minDepth = Math::Min(minDepth, clip.z * invW);
+    }
+
+    //画面外は視錐台カリングに任せる
+    auto x0 = Math::Max(static_cast<int>(std::floor(minX)), 0);
+    auto y0 = Math::Max(static_cast<int>(std::floor(minY)), 0);
+    auto x1 = Math::Min(static_cast<int>(std::floor(maxX)), mWidth - 1);
+    auto y1 = Math::Min(static_cast<int>(std::floor(maxY)), mHeight - 1);
+    if (x0 > x1 || y0 > y1) {
+        return true;
+    }
+
+    //ブロックの最も奥の深度より手前にあれば、そのブロックの画素を詳しく調べる
+    const auto blockCountX = mWidth / BLOCK_SIZE;
+    for (int by = y0 / BLOCK_SIZE; by <= y1 / BLOCK_SIZE; ++by) {
+        for (int bx = x0 / BLOCK_SIZE; bx <= x1 / BLOCK_SIZE; ++bx) {
+            if (minDepth > mHiZ[by * blockCountX + bx]) {
+                continue;
+            }
+
+            auto py0 = Math::Max(y0, by * BLOCK_SIZE);
+            auto py1 = Math::Min(y1, by * BLOCK_SIZE + BLOCK_SIZE - 1);
+            auto px0 = Math::Max(x0, bx * BLOCK_SIZE);
+            auto px1 = Math::Min(x1, bx * BLOCK_SIZE + BLOCK_SIZE - 1);
+            for (int y = py0; y <= py1; ++y) {
+                for (int x = px0; x <= px1; ++x) {
+                    if (minDepth <= mDepth[y * mWidth + x]) {
+                        return true;
+                    }
+                }
+            }
+        }
+    }
+
+    return false;
+}
+
+bool OcclusionCuller::hasOccluder() const {
+    return !mTriangles.empty();
+}
+
+float OcclusionCuller::getDepth(int x, int y) const {
+    return mDepth[y * mWidth + x];
+}
+
+int OcclusionCuller::getWidth() const {
+    return mWidth;
+}
+
+int OcclusionCuller::getHeight() const {
+    return mHeight;
+}
+
+void OcclusionCuller::addTriangle(const Vector4& v0, const Vector4& v1, const Vector4& v2) {
+    //近クリップ面をまたぐ三角形は切り取らずに捨てる 描かない分には誤って隠すことはない
+    if (v0.w <= NEAR_W || v1.w <= NEAR_W || v2.w <= NEAR_W) {
+        return;
+    }
+
+    //スクリーン座標と深度
+    float x[3], y[3], z[3];
+    const Vector4* v[3] = { &v0, &v1, &v2 };
+    for (int i = 0; i < 3; ++i) {
+        auto invW = 1.f / v[i]->w;
+        x[i] = (v[i]->x * invW * 0.5f + 0.5f) * mWidth;
+        y[i] = (0.5f - v[i]->y * invW * 0.5f) * mHeight;
+        z[i] = v[i]->z * invW;
+    }
+
+    //画素の中心で判定するので、中心を含みうる範囲に絞る
+    Triangle tri;
+    tri.minX = Math::Max(static_cast<int>(std::floor(Math::Min(x[0], Math::Min(x[1], x[2])) - 0.5f)), 0);
+    tri.minY = Math::Max(static_cast<int>(std::floor(Math::Min(y[0], Math::Min(y[1], y[2])) - 0.5f)), 0);
+    tri.maxX = Math::Min(static_cast<int>(std::ceil(Math::Max(x[0], Math::Max(x[1], x[2])) - 0.5f)), mWidth - 1);
+    tri.maxY = Math::Min(static_cast<int>(std::ceil(Math::Max(y[0], Math::Max(y[1], y[2])) - 0.5f)), mHeight - 1);
+    if (tri.minX > tri.maxX || tri.minY > tri.maxY) {
+        return;
+    }
+
+    //面積が0なら描かない 負なら裏向きなので頂点を入れ替えて表にする
+    auto area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+    if (area == 0.f) {
+        return;
+    }
+    if (area < 0.f) {
+        std::swap(x[1], x[2]);
+        std::swap(y[1], y[2]);
+        std::swap(z[1], z[2]);
+        area = -area;
+    }
+
+    //辺i (頂点i → 頂点i+1) の関数 内側が正になる
+    for (int i = 0; i < 3; ++i) {
+        auto j = (i + 1) % 3;
+        tri.edgeA[i] = y[i] - y[j];
+        tri.edgeB[i] = x[j] - x[i];
+        tri.edgeC[i] = x[i] * y[j] - x[j] * y[i];
+    }
+
+    //辺の関数は向かい合う頂点の重心座標 * 面積なので、深度もそのまま平面にできる
+    auto invArea = 1.f / area;
+    tri.depthA = (tri.edgeA[1] * z[0] + tri.edgeA[2] * z[1] + tri.edgeA[0] * z[2]) * invArea;
+    tri.depthB = (tri.edgeB[1] * z[0] + tri.edgeB[2] * z[1] + tri.edgeB[0] * z[2]) * invArea;
+    tri.depthC = (tri.edgeC[1] * z[0] + tri.edgeC[2] * z[1] + tri.edgeC[0] * z[2]) * invArea;
+
+    //覆うタイルに振り分ける
+    auto index = static_cast<unsigned>(mTriangles.size());
+    mTriangles.emplace_back(tri);
+    for (int ty = tri.minY / TILE_SIZE; ty <= tri.maxY / TILE_SIZE; ++ty) {
+        for (int tx = tri.minX / TILE_SIZE; tx <= tri.maxX / TILE_SIZE; ++tx) {
+            mTileBins[ty * mTileCountX + tx].emplace_back(index);
+        }
+    }
+}
+
+void OcclusionCuller::rasterizeTile(unsigned tileIndex) {
+    const auto tileX = static_cast<int>(tileIndex) % mTileCountX * TILE_SIZE;
+    const auto tileY = static_cast<int>(tileIndex) / mTileCountX * TILE_SIZE;
+
+    //前のフレームの深度を消す
+    for (int y = tileY; y < tileY + TILE_SIZE; ++y) {
+        std::fill_n(&mDepth[y * mWidth + tileX], TILE_SIZE, 1.f);
+    }
+
+    for (const auto& index : mTileBins[tileIndex]) {
+        const auto& tri = mTriangles[index];
+        rasterizeTriangle(
+            tri,
+            Math::Max(tri.minX, tileX),
+            Math::Max(tri.minY, tileY),
+            Math::Min(tri.maxX, tileX + TILE_SIZE - 1),
+            Math::Min(tri.maxY, tileY + TILE_SIZE - 1)
+        );
+    }
+
+    //タイル内のブロックごとに最も奥の深度を求める
+    const auto blockCountX = mWidth / BLOCK_SIZE;
+    for (int by = tileY; by < tileY + TILE_SIZE; by += BLOCK_SIZE) {
+        for (int bx = tileX; bx < tileX + TILE_SIZE; bx += BLOCK_SIZE) {
+            auto maxDepth = 0.f;
+            for (int y = by; y < by + BLOCK_SIZE; ++y) {
+                const auto* row = &mDepth[y * mWidth + bx];
+                for (int x = 0; x < BLOCK_SIZE; ++x) {
+                    maxDepth = Math::Max(maxDepth, row[x]);
+                }
+            }
+            mHiZ[(by / BLOCK_SIZE) * blockCountX + bx / BLOCK_SIZE] = maxDepth;
+        }
+    }
+}
+
+void OcclusionCuller::rasterizeTriangle(const Triangle& tri, int minX, int minY, int maxX, int maxY) {
+    //4画素ずつ処理するので開始位置を4の倍数に揃える タイルの幅も4の倍数なのではみ出さない
+    minX &= ~3;
+
+    for (int y = minY; y <= maxY; ++y) {
+        auto py = y + 0.5f;
+        auto* row = &mDepth[y * mWidth];
+        int x = minX;
+
+#ifdef MATH_SSE
+        const auto offset = _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f);
+        const auto zero = _mm_setzero_ps();
+        const auto a0 = _mm_set1_ps(tri.edgeA[0]);
+        const auto a1 = _mm_set1_ps(tri.edgeA[1]);
+        const auto a2 = _mm_set1_ps(tri.edgeA[2]);
+        const auto da = _mm_set1_ps(tri.depthA);
+        const auto rowE0 = _mm_set1_ps(tri.edgeB[0] * py + tri.edgeC[0]);
+        const auto rowE1 = _mm_set1_ps(tri.edgeB[1] * py + tri.edgeC[1]);
+        const auto rowE2 = _mm_set1_ps(tri.edgeB[2] * py + tri.edgeC[2]);
+        const auto rowZ = _mm_set1_ps(tri.depthB * py + tri.depthC);
+        for (; x <= maxX; x += 4) {
+            auto px = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), offset);
+            auto e0 = _mm_add_ps(_mm_mul_ps(a0, px), rowE0);
+            auto e1 = _mm_add_ps(_mm_mul_ps(a1, px), rowE1);
+            auto e2 = _mm_add_ps(_mm_mul_ps(a2, px), rowE2);
+            auto inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(e0, zero), _mm_cmpge_ps(e1, zero)), _mm_cmpge_ps(e2, zero));
+            if (_mm_movemask_ps(inside) == 0) {
+                continue;
+            }
+
+            //内側の画素だけ手前の深度で上書きする
+            auto depth = _mm_add_ps(_mm_mul_ps(da, px), rowZ);
+            auto old = _mm_loadu_ps(&row[x]);
+            auto result = _mm_min_ps(old, depth);
+            _mm_storeu_ps(&row[x], _mm_or_ps(_mm_and_ps(inside, result), _mm_andnot_ps(inside, old)));
+        }
+#endif // MATH_SSE
+
+        for (; x <= maxX; ++x) {
+            auto px = x + 0.5f;
+            bool inside = true;
+            for (int i = 0; i < 3; ++i) {
+                if (tri.edgeA[i] * px + tri.edgeB[i] * py + tri.edgeC[i] < 0.f) {
+                    inside = false;
+                    break;
+                }
+            }
+            if (inside) {
+                row[x] = Math::Min(row[x], tri.depthA * px + tri.depthB * py + tri.depthC);
+            }
+        }
+    }
+}
@@ -0,0 +1,85 @@
+﻿#pragma once
+
+#include "IMeshLoader.h"
+#include "../Collision/AABB.h"
+#include "../Math/Math.h"
+#include <vector>
+
+class ThreadPool;
+
+//CPUでオクルーダーを小さな深度バッファに描き、その裏に隠れるものを描画前に取り除く
+//深度はDirectXと同じく手前が0、奥が1
+class OcclusionCuller {
+    //スクリーン空間の三角形
+    struct Triangle {
+        //辺の関数 a * x + b * y + c が全て0以上なら内側
+        float edgeA[3];
+        float edgeB[3];
+        float edgeC[3];
+        //深度の平面 depthA * x + depthB * y + depthC
+        float depthA;
+        float depthB;
+        float depthC;
+        //覆う画素の範囲(両端を含む)
+        int minX;
+        int minY;
+        int maxX;
+        int maxY;
+    };
+
+public:
+    //タイルの描画はシーン全体で共有するスレッドプールで並列に行う
+    OcclusionCuller(ThreadPool& threadPool);
+    ~OcclusionCuller();
+    //深度バッファの大きさを設定する 幅と高さはタイルの大きさに切り上げる
+    void resize(int width, int height);
+    //描き始める 登録済みのオクルーダーを消し、ビュー射影行列を設定する
+    void begin(const Matrix4& viewProjection);
+    //オクルーダーの三角形を登録する 頂点は3つで1つの三角形
+    void addOccluder(const MeshVertices& vertices, const Matrix4& world);
+    //登録したオクルーダーをタイルごとに並列で描き、階層深度を作る
+    void rasterize();
+    //オブジェクト空間のAABBがオクルーダーに隠れず見える可能性があるか
+    bool isVisible(const AABB& aabb, const Matrix4& world) const;
+    //オクルーダーが登録されているか
+    bool hasOccluder() const;
+    //指定画素の深度を取得する
+    float getDepth(int x, int y) const;
+    int getWidth() const;
+    int getHeight() const;
+
+private:
+    OcclusionCuller(const OcclusionCuller&) = delete;
+    OcclusionCuller& operator=(const OcclusionCuller&) = delete;
+
+    //クリップ座標の三角形をスクリーン空間に移し、覆うタイルに振り分ける
+    void addTriangle(const Vector4& v0, const Vector4& v1, const Vector4& v2);
+    //タイル1つ分の三角形を描き、そのタイルの階層深度を作る
+    void rasterizeTile(unsigned tileIndex);
+    //画素の範囲に三角形を描く
+    void rasterizeTriangle(const Triangle& tri, int minX, int minY, int maxX, int maxY);
+
+private:
+    //所有はSceneManager
+    ThreadPool& mThreadPool;
+    std::vector<float> mDepth;
+    //BLOCK_SIZE四方ごとの最も奥の深度
+    std::vector<float> mHiZ;
+    std::vector<Triangle> mTriangles;
+    //オクルーダーの頂点をクリップ座標に変換する作業用
+    std::vector<Vector4> mClipVertices;
+    //タイルごとに描く三角形の番号
+    std::vector<std::vector<unsigned>> mTileBins;
+    Matrix4 mViewProjection;
+    int mWidth;
+    int mHeight;
+    int mTileCountX;
+    int mTileCountY;
+
+    static constexpr int TILE_SIZE = 32;
+    static constexpr int BLOCK_SIZE = 8;
+    static constexpr int DEFAULT_WIDTH = 320;
+    static constexpr int DEFAULT_HEIGHT = 192;
+    //これより手前にかかる三角形は近クリップ面をまたぐので描かない
+    static constexpr float NEAR_W = 1e-4f;
+};
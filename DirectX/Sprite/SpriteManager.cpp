@@ -38,7 +38,7 @@ void SpriteManager::draw3Ds(const Matrix4& view, const Matrix4& proj) const {
     cancelRotation.m[3][0] = 0.f;
     cancelRotation.m[3][1] = 0.f;
     cancelRotation.m[3][2] = 0.f;
-    cancelRotation.inverse();
+    cancelRotation.inverseAffine();
 
     for (const auto& sprite : mSprite3Ds) {
         if (!sprite->getActive() || sprite->isDead()) {
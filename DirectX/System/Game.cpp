@@ -14,6 +14,7 @@
 #include "../Imgui/imgui_impl_win32.h"
 #include "../Input/InputUtility.h"
 #include "../Sound/XAudio2/SoundEngine.h"
+#include "../Transform/TransformPool.h"
 #include "../Utility/LevelLoader.h"
 #include "../Utility/Random.h"
 
@@ -39,6 +40,7 @@ Game::~Game() {
     DebugUtility::finalize();
     SoundEngine::instance().finalize();
     AssetsManager::instance().finalize();
+    TransformPool::instance().finalize();
     MyDirectX::DirectX::instance().finalize();
 }
 
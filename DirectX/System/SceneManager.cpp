@@ -13,6 +13,7 @@
 #include "../Device/DrawString.h"
 #include "../Device/Physics.h"
 #include "../Device/Renderer.h"
+#include "../Device/ThreadPool.h"
 #include "../GameObject/GameObject.h"
 #include "../GameObject/GameObjectFactory.h"
 #include "../GameObject/GameObjectManager.h"
@@ -21,31 +22,36 @@
 #include "../Mesh/MeshManager.h"
 #include "../Sprite/Sprite.h"
 #include "../Sprite/SpriteManager.h"
+#include "../Transform/TransformPool.h"
 #include "../Utility/LevelLoader.h"
 
 SceneManager::SceneManager() :
+    mThreadPool(std::make_unique<ThreadPool>()),
     mRenderer(std::make_unique<Renderer>()),
     mCurrentScene(nullptr),
     mCamera(nullptr),
     mGameObjectManager(std::make_unique<GameObjectManager>()),
-    mMeshManager(std::make_unique<MeshManager>()),
+    mMeshManager(std::make_unique<MeshManager>(*mThreadPool)),
     mSpriteManager(std::make_unique<SpriteManager>()),
-    mPhysics(std::make_unique<Physics>()),
+    mPhysics(std::make_unique<Physics>(*mThreadPool)),
     mLightManager(std::make_unique<LightManager>()),
     mTextDrawer(new DrawString()),
     mBeginScene(),
     mShouldDraw(false) {
+    TransformPool::instance().setThreadPool(mThreadPool.get());
 }
 
 SceneManager::~SceneManager() {
     safeDelete(mTextDrawer);
 
     TextBase::setDrawString(nullptr);
+    TransformPool::instance().setThreadPool(nullptr);
 }
 
 void SceneManager::loadProperties(const rapidjson::Value& inObj) {
     JsonHelper::getString(inObj, "beginScene", &mBeginScene);
     mLightManager->loadProperties(inObj);
+    mPhysics->loadProperties(inObj);
     mTextDrawer->loadProperties(inObj);
 }
 
@@ -92,7 +98,7 @@ void SceneManager::update() {
     //総当たり判定
     mPhysics->sweepAndPrune();
     //各マネージャークラスを更新
-    mMeshManager->update();
+    mMeshManager->update(*mCamera);
     mSpriteManager->update();
     //デバッグ
     DebugUtility::update();
@@ -14,6 +14,7 @@ class Physics;
 class SpriteManager;
 class LightManager;
 class DrawString;
+class ThreadPool;
 
 class SceneManager {
     using StringSet = std::unordered_set<std::string>;
@@ -31,6 +32,8 @@ private:
     void createScene(const std::string& name);
 
 private:
+    //物理、オクルージョンカリング、トランスフォームで共有するワーカー 使う側より先に作り、後に破棄する
+    std::unique_ptr<ThreadPool> mThreadPool;
     std::unique_ptr<Renderer> mRenderer;
     std::shared_ptr<Scene> mCurrentScene;
     std::shared_ptr<Camera> mCamera;
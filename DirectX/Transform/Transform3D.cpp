@@ -1,99 +1,74 @@
 ﻿#include "Transform3D.h"
+#include "TransformPool.h"
 #include "../DebugLayer/ImGuiWrapper.h"
 #include "../GameObject/GameObject.h"
 #include "../Imgui/imgui.h"
 #include "../Utility/LevelLoader.h"
 
 Transform3D::Transform3D() :
-    mWorldTransform(Matrix4::identity),
-    mPosition(Vector3::zero),
-    mRotation(Quaternion::identity),
-    mPivot(Vector3::zero),
-    mScale(Vector3::one), 
-    mParent(nullptr) {
+    mHandle(TransformPool::instance().create(this)) {
 }
 
 Transform3D::~Transform3D() {
-    if (mParent) {
-        mParent.reset();
-    }
-    if (mChildren.empty()) {
-        return;
-    }
-    for (const auto& child : mChildren) {
-        //child->gameObject().destroy();
-    }
+    TransformPool::instance().destroy(mHandle);
 }
 
 void Transform3D::computeWorldTransform() {
-    mWorldTransform = Matrix4::createTranslation(-mPivot); //ピボットを原点に
-    mWorldTransform *= Matrix4::createScale(getScale());
-    mWorldTransform *= Matrix4::createFromQuaternion(getRotation());
-    mWorldTransform *= Matrix4::createTranslation(getPosition());
+    TransformPool::instance().computeWorldTransform(mHandle);
 }
 
 const Matrix4& Transform3D::getWorldTransform() const {
-    return mWorldTransform;
+    return TransformPool::instance().getWorldTransform(mHandle);
 }
 
 void Transform3D::setPosition(const Vector3& pos) {
-    mPosition = pos;
+    TransformPool::instance().setLocalPosition(mHandle, pos);
 }
 
 Vector3 Transform3D::getPosition() const {
-    auto root = mParent;
-    auto pos = mPosition;
-    while (root) {
-        pos += root->mPosition;
-        root = root->mParent;
-    }
-    return pos;
+    return TransformPool::instance().getWorldPosition(mHandle);
 }
 
 const Vector3& Transform3D::getLocalPosition() const {
-    return mPosition;
+    return TransformPool::instance().getLocalPosition(mHandle);
 }
 
 void Transform3D::translate(const Vector3& translation) {
-    mPosition += translation;
+    setPosition(getLocalPosition() + translation);
 }
 
 void Transform3D::translate(float x, float y, float z) {
-    mPosition.x += x;
-    mPosition.y += y;
-    mPosition.z += z;
+    translate(Vector3(x, y, z));
 }
 
 void Transform3D::setRotation(const Quaternion& rot) {
-    mRotation = rot;
+    TransformPool::instance().setLocalRotation(mHandle, rot);
 }
 
 void Transform3D::setRotation(const Vector3& axis, float angle) {
     angle *= 0.5f;
     auto sinAngle = Math::sin(angle);
 
-    mRotation.x = axis.x * sinAngle;
-    mRotation.y = axis.y * sinAngle;
-    mRotation.z = axis.z * sinAngle;
-    mRotation.w = Math::cos(angle);
+    Quaternion rot;
+    rot.x = axis.x * sinAngle;
+    rot.y = axis.y * sinAngle;
+    rot.z = axis.z * sinAngle;
+    rot.w = Math::cos(angle);
+    setRotation(rot);
 }
 
 void Transform3D::setRotation(const Vector3& eulers) {
-    mRotation.setEuler(eulers);
+    Quaternion rot;
+    rot.setEuler(eulers);
+    setRotation(rot);
 }
 
 Quaternion Transform3D::getRotation() const {
-    auto root = mParent;
-    auto rotation = mRotation;
-    while (root) {
-        rotation = Quaternion::concatenate(rotation, root->mRotation);
-        root = root->mParent;
-    }
-    return rotation;
+    return TransformPool::instance().getWorldRotation(mHandle);
 }
 
 const Quaternion& Transform3D::getLocalRotation() const {
-    return mRotation;
+    return TransformPool::instance().getLocalRotation(mHandle);
 }
 
 void Transform3D::rotate(const Vector3& axis, float angle) {
@@ -106,7 +81,7 @@ void Transform3D::rotate(const Vector3& axis, float angle) {
     inc.z = axis.z * sinAngle;
     inc.w = Math::cos(angle);
 
-    mRotation = Quaternion::concatenate(mRotation, inc);
+    setRotation(Quaternion::concatenate(getLocalRotation(), inc));
 }
 
 void Transform3D::rotate(const Vector3& eulers) {
@@ -116,112 +91,108 @@ void Transform3D::rotate(const Vector3& eulers) {
 }
 
 void Transform3D::setPivot(const Vector3& pivot) {
-    mPivot = pivot;
+    TransformPool::instance().setPivot(mHandle, pivot);
 }
 
 const Vector3& Transform3D::getPivot() const {
-    return mPivot;
+    return TransformPool::instance().getPivot(mHandle);
 }
 
 void Transform3D::setScale(const Vector3& scale) {
-    mScale = scale;
+    TransformPool::instance().setLocalScale(mHandle, scale);
 }
 
 void Transform3D::setScale(float scale) {
-    mScale.x = scale;
-    mScale.y = scale;
-    mScale.z = scale;
+    setScale(Vector3(scale, scale, scale));
 }
 
 Vector3 Transform3D::getScale() const {
-    auto root = mParent;
-    auto scale = mScale;
-    while (root) {
-        scale.x *= root->mScale.x;
-        scale.y *= root->mScale.y;
-        scale.z *= root->mScale.z;
-        root = root->mParent;
-    }
-    return scale;
+    return TransformPool::instance().getWorldScale(mHandle);
 }
 
 const Vector3& Transform3D::getLocalScale() const {
-    return mScale;
+    return TransformPool::instance().getLocalScale(mHandle);
 }
 
 Vector3 Transform3D::forward() const {
-    return Vector3::transform(Vector3::forward, mRotation);
+    return Vector3::transform(Vector3::forward, getLocalRotation());
 }
 
 Vector3 Transform3D::up() const {
-    return Vector3::transform(Vector3::up, mRotation);
+    return Vector3::transform(Vector3::up, getLocalRotation());
 }
 
 Vector3 Transform3D::right() const {
-    return Vector3::transform(Vector3::right, mRotation);
+    return Vector3::transform(Vector3::right, getLocalRotation());
 }
 
-void Transform3D::addChild(std::shared_ptr<Transform3D>& child) {
-    mChildren.emplace_back(child);
-    child->setParent(shared_from_this());
+void Transform3D::addChild(Transform3D& child) {
+    TransformPool::instance().setParent(child.mHandle, mHandle);
 }
 
-std::list<std::shared_ptr<Transform3D>> Transform3D::getChildren() const {
-    return mChildren;
+std::vector<Transform3D*> Transform3D::getChildren() const {
+    std::vector<Transform3D*> children;
+    TransformPool::instance().getChildren(mHandle, &children);
+    return children;
 }
 
 Transform3D& Transform3D::parent() const {
-    return *mParent;
+    return *TransformPool::instance().getParent(mHandle);
 }
 
 Transform3D& Transform3D::root() const {
-    auto root = mParent;
-    while (root) {
-        auto p = root->mParent;
-        if (!p) {
-            break;
-        }
+    auto& pool = TransformPool::instance();
+    auto root = const_cast<Transform3D*>(this);
+    while (auto p = pool.getParent(root->mHandle)) {
         root = p;
     }
     return *root;
 }
 
 size_t Transform3D::getChildCount() const {
-    return mChildren.size();
+    return getChildren().size();
 }
 
 void Transform3D::loadProperties(const rapidjson::Value& inObj) {
     //位置、回転、スケールを読み込む
-    JsonHelper::getVector3(inObj, "position", &mPosition);
+    Vector3 pos;
+    if (JsonHelper::getVector3(inObj, "position", &pos)) {
+        setPosition(pos);
+    }
     Vector3 rot;
     if (JsonHelper::getVector3(inObj, "rotation", &rot)) {
         setRotation(rot);
     }
-    JsonHelper::getVector3(inObj, "scale", &mScale);
+    Vector3 scale;
+    if (JsonHelper::getVector3(inObj, "scale", &scale)) {
+        setScale(scale);
+    }
 
     computeWorldTransform();
 }
 
 void Transform3D::saveProperties(rapidjson::Document::AllocatorType& alloc, rapidjson::Value* inObj) const {
     //位置、回転、スケールを書き込む
-    JsonHelper::setVector3(alloc, inObj, "position", mPosition);
-    JsonHelper::setVector3(alloc, inObj, "rotation", mRotation.euler());
-    JsonHelper::setVector3(alloc, inObj, "scale", mScale);
+    JsonHelper::setVector3(alloc, inObj, "position", getLocalPosition());
+    JsonHelper::setVector3(alloc, inObj, "rotation", getLocalRotation().euler());
+    JsonHelper::setVector3(alloc, inObj, "scale", getLocalScale());
 }
 
 void Transform3D::drawInspector() {
     ImGui::Text("Transform");
 
-    ImGuiWrapper::dragVector3("Position", mPosition, 0.01f);
+    auto pos = getLocalPosition();
+    if (ImGuiWrapper::dragVector3("Position", pos, 0.01f)) {
+        setPosition(pos);
+    }
 
-    auto euler = mRotation.euler();
+    auto euler = getLocalRotation().euler();
     if (ImGuiWrapper::dragVector3("Rotation", euler, 0.1f)) {
-        mRotation.setEuler(euler);
+        setRotation(euler);
     }
 
-    ImGuiWrapper::dragVector3("Scale", mScale, 0.01f);
-}
-
-void Transform3D::setParent(const std::shared_ptr<Transform3D>& parent) {
-    mParent = parent;
+    auto scale = getLocalScale();
+    if (ImGuiWrapper::dragVector3("Scale", scale, 0.01f)) {
+        setScale(scale);
+    }
 }
@@ -2,18 +2,19 @@
 
 #include "../Math/Math.h"
 #include <rapidjson/document.h>
-#include <list>
-#include <memory>
 #include <string>
+#include <vector>
 
-class Transform3D : public std::enable_shared_from_this<Transform3D> {
+//実体はTransformPoolに置き、自身はハンドルだけを持つ
+class Transform3D {
 public:
     Transform3D();
     ~Transform3D();
 
-    //ワールド行列更新
+    //ワールド行列更新 変更がなければ何もしない
     void computeWorldTransform();
     //ワールド行列の取得
+    //参照はトランスフォームの生成、破棄、TransformPool::computeWorldTransformsで無効になる
     const Matrix4& getWorldTransform() const;
 
     //位置の設定
@@ -64,8 +65,8 @@ public:
     Vector3 right() const;
 
     //親子関係
-    void addChild(std::shared_ptr<Transform3D>& child);
-    std::list<std::shared_ptr<Transform3D>> getChildren() const;
+    void addChild(Transform3D& child);
+    std::vector<Transform3D*> getChildren() const;
     Transform3D& parent() const;
     Transform3D& root() const;
     size_t getChildCount() const;
@@ -81,15 +82,7 @@ private:
     Transform3D(const Transform3D&) = delete;
     Transform3D& operator=(const Transform3D&) = delete;
 
-    //親の設定
-    void setParent(const std::shared_ptr<Transform3D>& parent);
-
 private:
-    Matrix4 mWorldTransform;
-    Vector3 mPosition;
-    Quaternion mRotation;
-    Vector3 mPivot;
-    Vector3 mScale;
-    std::shared_ptr<Transform3D> mParent;
-    std::list<std::shared_ptr<Transform3D>> mChildren;
+    //TransformPoolでのハンドル
+    unsigned mHandle;
 };
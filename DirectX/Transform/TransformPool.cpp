@@ -0,0 +1,409 @@
+﻿#include "TransformPool.h"
+#include "../Device/ThreadPool.h"
+#include "../System/GlobalFunction.h"
+#include <algorithm>
+
+TransformPool::TransformPool() :
+    mLevelStarts(1, 0),
+    mSortedCount(0),
+    mDestroyedCount(0),
+    mIsOrderDirty(false),
+    mThreadPool(nullptr) {
+}
+
+TransformPool::~TransformPool() = default;
+
+TransformPool& TransformPool::instance() {
+    if (!mInstance) {
+        mInstance = new TransformPool();
+    }
+    return *mInstance;
+}
+
+void TransformPool::finalize() {
+    safeDelete(mInstance);
+}
+
+void TransformPool::setThreadPool(ThreadPool* threadPool) {
+    mThreadPool = threadPool;
+}
+
+unsigned TransformPool::create(Transform3D* owner) {
+    unsigned handle = 0;
+    if (mFreeHandles.empty()) {
+        handle = static_cast<unsigned>(mIndices.size());
+        mIndices.emplace_back(INVALID_INDEX);
+    } else {
+        handle = mFreeHandles.back();
+        mFreeHandles.pop_back();
+    }
+
+    //親を持たないので末尾に追加しても深さ順は崩れない
+    mIndices[handle] = static_cast<unsigned>(mParents.size());
+    mPositions.emplace_back(Vector3::zero);
+    mRotations.emplace_back(Quaternion::identity);
+    mScales.emplace_back(Vector3::one);
+    mPivots.emplace_back(Vector3::zero);
+    mWorldPositions.emplace_back(Vector3::zero);
+    mWorldRotations.emplace_back(Quaternion::identity);
+    mWorldScales.emplace_back(Vector3::one);
+    mWorldTransforms.emplace_back(Matrix4::identity);
+    mParents.emplace_back(INVALID_INDEX);
+    mVersions.emplace_back(0);
+    mParentVersions.emplace_back(0);
+    mFlags.emplace_back(WORLD_DIRTY | MATRIX_DIRTY);
+    mHandles.emplace_back(handle);
+    mOwners.emplace_back(owner);
+
+    return handle;
+}
+
+void TransformPool::destroy(unsigned handle) {
+    auto index = indexOf(handle);
+    mIndices[handle] = INVALID_INDEX;
+    mFreeHandles.emplace_back(handle);
+
+    //並び替え後に追加された末尾の根は子を持たないので、そのまま取り除ける
+    if (!mIsOrderDirty && index >= mSortedCount && index + 1 == mParents.size()) {
+        mPositions.pop_back();
+        mRotations.pop_back();
+        mScales.pop_back();
+        mPivots.pop_back();
+        mWorldPositions.pop_back();
+        mWorldRotations.pop_back();
+        mWorldScales.pop_back();
+        mWorldTransforms.pop_back();
+        mParents.pop_back();
+        mVersions.pop_back();
+        mParentVersions.pop_back();
+        mFlags.pop_back();
+        mHandles.pop_back();
+        mOwners.pop_back();
+        return;
+    }
+
+    //子の添字をずらさないよう、印だけ付けて次の並び替えで詰める
+    mFlags[index] |= DESTROYED;
+    mHandles[index] = INVALID_HANDLE;
+    mOwners[index] = nullptr;
+    ++mDestroyedCount;
+}
+
+void TransformPool::computeWorldTransforms() {
+    if (mIsOrderDirty || mDestroyedCount * 4 > mParents.size()) {
+        sortByDepth();
+    }
+
+    //親は必ず1つ浅い深さにあるので、浅い順に求めれば親は求め終わっている
+    const auto levelCount = mLevelStarts.size() - 1;
+    for (size_t d = 0; d < levelCount; ++d) {
+        updateWorldRange(mLevelStarts[d], mLevelStarts[d + 1]);
+    }
+    //並び替え後に追加された根は子を持たないので、まとめて求められる
+    const auto count = mParents.size();
+    updateWorldRange(mSortedCount, count);
+
+    //行列は自身のワールド値だけで決まるので、全体を分割して作る
+    parallelFor(count, [&](size_t begin, size_t end) {
+        buildWorldTransforms(begin, end);
+    });
+}
+
+void TransformPool::computeWorldTransform(unsigned handle) {
+    auto index = indexOf(handle);
+    updateWorldFromRoot(index);
+    if (mFlags[index] & MATRIX_DIRTY) {
+        buildWorldTransform(index);
+    }
+}
+
+const Matrix4& TransformPool::getWorldTransform(unsigned handle) const {
+    return mWorldTransforms[indexOf(handle)];
+}
+
+void TransformPool::setLocalPosition(unsigned handle, const Vector3& pos) {
+    auto index = indexOf(handle);
+    mPositions[index] = pos;
+    mFlags[index] |= WORLD_DIRTY;
+}
+
+void TransformPool::setLocalRotation(unsigned handle, const Quaternion& rot) {
+    auto index = indexOf(handle);
+    mRotations[index] = rot;
+    mFlags[index] |= WORLD_DIRTY;
+}
+
+void TransformPool::setLocalScale(unsigned handle, const Vector3& scale) {
+    auto index = indexOf(handle);
+    mScales[index] = scale;
+    mFlags[index] |= WORLD_DIRTY;
+}
+
+void TransformPool::setPivot(unsigned handle, const Vector3& pivot) {
+    auto index = indexOf(handle);
+    mPivots[index] = pivot;
+    //ピボットは子に影響しないので自身の行列だけ作り直す
+    mFlags[index] |= MATRIX_DIRTY;
+}
+
+const Vector3& TransformPool::getLocalPosition(unsigned handle) const {
+    return mPositions[indexOf(handle)];
+}
+
+const Quaternion& TransformPool::getLocalRotation(unsigned handle) const {
+    return mRotations[indexOf(handle)];
+}
+
+const Vector3& TransformPool::getLocalScale(unsigned handle) const {
+    return mScales[indexOf(handle)];
+}
+
+const Vector3& TransformPool::getPivot(unsigned handle) const {
+    return mPivots[indexOf(handle)];
+}
+
+const Vector3& TransformPool::getWorldPosition(unsigned handle) {
+    auto index = indexOf(handle);
+    updateWorldFromRoot(index);
+    return mWorldPositions[index];
+}
+
+const Quaternion& TransformPool::getWorldRotation(unsigned handle) {
+    auto index = indexOf(handle);
+    updateWorldFromRoot(index);
+    return mWorldRotations[index];
+}
+
+const Vector3& TransformPool::getWorldScale(unsigned handle) {
+    auto index = indexOf(handle);
+    updateWorldFromRoot(index);
+    return mWorldScales[index];
+}
+
+void TransformPool::setParent(unsigned handle, unsigned parentHandle) {
+    auto index = indexOf(handle);
+    auto parent = (parentHandle == INVALID_HANDLE) ? INVALID_INDEX : indexOf(parentHandle);
+
+    //親子関係が循環しないよう、自身の子孫は親にしない
+    for (auto i = parent; i != INVALID_INDEX; i = parentOf(i)) {
+        if (i == index) {
+            return;
+        }
+    }
+
+    mParents[index] = parent;
+    mFlags[index] |= WORLD_DIRTY;
+    mIsOrderDirty = true;
+}
+
+Transform3D* TransformPool::getParent(unsigned handle) const {
+    auto parent = mParents[indexOf(handle)];
+    if (parent == INVALID_INDEX || (mFlags[parent] & DESTROYED)) {
+        return nullptr;
+    }
+    return mOwners[parent];
+}
+
+void TransformPool::getChildren(unsigned handle, std::vector<Transform3D*>* children) const {
+    auto index = indexOf(handle);
+    const auto count = mParents.size();
+    for (size_t i = 0; i < count; ++i) {
+        if (mParents[i] == index && !(mFlags[i] & DESTROYED)) {
+            children->emplace_back(mOwners[i]);
+        }
+    }
+}
+
+size_t TransformPool::size() const {
+    return mParents.size() - mDestroyedCount;
+}
+
+unsigned TransformPool::indexOf(unsigned handle) const {
+    return mIndices[handle];
+}
+
+unsigned TransformPool::parentOf(unsigned index) {
+    auto parent = mParents[index];
+    if (parent != INVALID_INDEX && (mFlags[parent] & DESTROYED)) {
+        mParents[index] = INVALID_INDEX;
+        mFlags[index] |= WORLD_DIRTY;
+        return INVALID_INDEX;
+    }
+    return parent;
+}
+
+void TransformPool::updateWorld(unsigned index) {
+    auto& flags = mFlags[index];
+    if (flags & DESTROYED) {
+        return;
+    }
+
+    auto parent = parentOf(index);
+    if (parent == INVALID_INDEX) {
+        if (!(flags & WORLD_DIRTY)) {
+            return;
+        }
+        mWorldPositions[index] = mPositions[index];
+        mWorldRotations[index] = mRotations[index];
+        mWorldScales[index] = mScales[index];
+    } else {
+        //自身も親も変わっていなければ求め直さない
+        if (!(flags & WORLD_DIRTY) && mParentVersions[index] == mVersions[parent]) {
+            return;
+        }
+        mWorldPositions[index] = mWorldPositions[parent] + mPositions[index];
+        mWorldRotations[index] = Quaternion::concatenate(mRotations[index], mWorldRotations[parent]);
+        mWorldScales[index] = mScales[index] * mWorldScales[parent];
+        mParentVersions[index] = mVersions[parent];
+    }
+
+    ++mVersions[index];
+    flags = (flags & ~WORLD_DIRTY) | MATRIX_DIRTY;
+}
+
+void TransformPool::updateWorldFromRoot(unsigned index) {
+    mWork.clear();
+    for (auto i = index; i != INVALID_INDEX; i = parentOf(i)) {
+        mWork.emplace_back(i);
+    }
+    for (auto itr = mWork.rbegin(); itr != mWork.rend(); ++itr) {
+        updateWorld(*itr);
+    }
+}
+
+void TransformPool::buildWorldTransform(unsigned index) {
+    buildWorldTransforms(index, index + 1);
+}
+
+void TransformPool::buildWorldTransforms(size_t begin, size_t end) {
+    //作り直しが必要な要素が連続する区間ごとに、まとめて行列を作る
+    auto needsBuild = [&](size_t i) {
+        return (mFlags[i] & (MATRIX_DIRTY | DESTROYED)) == MATRIX_DIRTY;
+    };
+
+    auto i = begin;
+    while (i < end) {
+        if (!needsBuild(i)) {
+            ++i;
+            continue;
+        }
+        auto last = i + 1;
+        while (last < end && needsBuild(last)) {
+            ++last;
+        }
+
+        //ピボットを原点に移動させてから、スケール、回転、位置の順に掛ける
+        Matrix4::createTRSArray(&mWorldScales[i], &mWorldRotations[i], &mWorldPositions[i], &mWorldTransforms[i], last - i, &mPivots[i]);
+        for (; i < last; ++i) {
+            mFlags[i] &= ~MATRIX_DIRTY;
+        }
+    }
+}
+
+void TransformPool::updateWorldRange(size_t begin, size_t end) {
+    //書き込むのは各要素自身の値だけで、読むのは求め終わった親の値だけ
+    parallelFor(end - begin, [&](size_t first, size_t last) {
+        for (size_t i = begin + first; i < begin + last; ++i) {
+            updateWorld(static_cast<unsigned>(i));
+        }
+    });
+}
+
+void TransformPool::sortByDepth() {
+    const auto count = mParents.size();
+
+    //親の深さが求まっていなければ、求まっている祖先まで積んでから降りていく
+    std::vector<unsigned> depths(count, INVALID_INDEX);
+    unsigned levelCount = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (mFlags[i] & DESTROYED) {
+            continue;
+        }
+
+        mWork.clear();
+        auto p = static_cast<unsigned>(i);
+        while (p != INVALID_INDEX && depths[p] == INVALID_INDEX) {
+            mWork.emplace_back(p);
+            p = parentOf(p);
+        }
+
+        auto depth = (p == INVALID_INDEX) ? 0 : depths[p] + 1;
+        for (auto itr = mWork.rbegin(); itr != mWork.rend(); ++itr) {
+            depths[*itr] = depth++;
+        }
+        levelCount = std::max(levelCount, depth);
+    }
+
+    //深さごとの個数から各深さの開始位置を求め、深さ順に詰めた並びを作る
+    std::vector<unsigned> starts(levelCount + 1, 0);
+    for (size_t i = 0; i < count; ++i) {
+        if (depths[i] != INVALID_INDEX) {
+            ++starts[depths[i] + 1];
+        }
+    }
+    for (unsigned d = 0; d < levelCount; ++d) {
+        starts[d + 1] += starts[d];
+    }
+    mLevelStarts = starts;
+
+    const auto aliveCount = starts[levelCount];
+    std::vector<unsigned> order(aliveCount);
+    std::vector<unsigned> newIndices(count, INVALID_INDEX);
+    for (size_t i = 0; i < count; ++i) {
+        if (depths[i] == INVALID_INDEX) {
+            continue;
+        }
+        auto newIndex = starts[depths[i]]++;
+        order[newIndex] = static_cast<unsigned>(i);
+        newIndices[i] = newIndex;
+    }
+
+    reorder(mPositions, order);
+    reorder(mRotations, order);
+    reorder(mScales, order);
+    reorder(mPivots, order);
+    reorder(mWorldPositions, order);
+    reorder(mWorldRotations, order);
+    reorder(mWorldScales, order);
+    reorder(mWorldTransforms, order);
+    reorder(mParents, order);
+    reorder(mVersions, order);
+    reorder(mParentVersions, order);
+    reorder(mFlags, order);
+    reorder(mHandles, order);
+    reorder(mOwners, order);
+
+    for (unsigned i = 0; i < aliveCount; ++i) {
+        auto& parent = mParents[i];
+        if (parent != INVALID_INDEX) {
+            parent = newIndices[parent];
+        }
+        mIndices[mHandles[i]] = i;
+    }
+
+    mSortedCount = aliveCount;
+    mDestroyedCount = 0;
+    mIsOrderDirty = false;
+}
+
+template <typename T>
+void TransformPool::reorder(std::vector<T>& values, const std::vector<unsigned>& order) {
+    std::vector<T> sorted;
+    sorted.reserve(order.size());
+    for (auto i : order) {
+        sorted.emplace_back(values[i]);
+    }
+    values.swap(sorted);
+}
+
+template <typename Task>
+void TransformPool::parallelFor(size_t count, const Task& task) {
+    if (!mThreadPool) {
+        task(0, count);
+        return;
+    }
+
+    mThreadPool->parallelFor(count, MIN_TRANSFORMS_PER_THREAD, [&](size_t begin, size_t end, unsigned) {
+        task(begin, end);
+    });
+}
@@ -0,0 +1,145 @@
+﻿#pragma once
+
+#include "../Math/Math.h"
+#include <vector>
+
+class ThreadPool;
+class Transform3D;
+
+//全Transform3Dのローカル値とワールド行列を要素ごとの配列にまとめて持つ
+//親が子より必ず前に来るよう深さ順に並べ、親は配列の添字で指す
+//ワールド行列の更新は先頭から1度なめるだけで済み、同じ深さの要素同士は並列に求められる
+class TransformPool {
+private:
+    //シングルトンだからprivate
+    TransformPool();
+public:
+    ~TransformPool();
+    //トランスフォームプールのインスタンスを返す
+    static TransformPool& instance();
+    //終了処理
+    void finalize();
+    //ワールド行列の並列更新に使うスレッドプールを設定する 所有はしない
+    //nullptrなら呼び出したスレッドだけで更新する
+    void setThreadPool(ThreadPool* threadPool);
+
+    //トランスフォームを登録してハンドルを返す
+    //ハンドルは並び替えても変わらない
+    unsigned create(Transform3D* owner);
+    //トランスフォームを破棄する 子は親を失い根になる
+    void destroy(unsigned handle);
+
+    //全トランスフォームのワールド行列を深さ順に更新する
+    //同じ深さの要素はワーカースレッドで分割して求める
+    void computeWorldTransforms();
+    //1つのトランスフォームのワールド行列を更新する
+    void computeWorldTransform(unsigned handle);
+    //ワールド行列の取得 更新はしない
+    //参照はトランスフォームの生成、破棄、computeWorldTransformsで無効になる
+    const Matrix4& getWorldTransform(unsigned handle) const;
+
+    //ローカル値の設定
+    void setLocalPosition(unsigned handle, const Vector3& pos);
+    void setLocalRotation(unsigned handle, const Quaternion& rot);
+    void setLocalScale(unsigned handle, const Vector3& scale);
+    void setPivot(unsigned handle, const Vector3& pivot);
+    //ローカル値の取得
+    const Vector3& getLocalPosition(unsigned handle) const;
+    const Quaternion& getLocalRotation(unsigned handle) const;
+    const Vector3& getLocalScale(unsigned handle) const;
+    const Vector3& getPivot(unsigned handle) const;
+
+    //親子関係を考慮した値の取得 必要なら祖先から求め直す
+    const Vector3& getWorldPosition(unsigned handle);
+    const Quaternion& getWorldRotation(unsigned handle);
+    const Vector3& getWorldScale(unsigned handle);
+
+    //親の設定 INVALID_HANDLEで親子関係を解除する
+    //自身の子孫を親にしようとした場合は何もしない
+    void setParent(unsigned handle, unsigned parentHandle);
+    //親の取得 いなければnullptr
+    Transform3D* getParent(unsigned handle) const;
+    //子の取得 全体を走査するので頻繁に呼ばないこと
+    void getChildren(unsigned handle, std::vector<Transform3D*>* children) const;
+
+    //登録されているトランスフォームの数
+    size_t size() const;
+
+    static constexpr unsigned INVALID_HANDLE = ~0u;
+
+private:
+    TransformPool(const TransformPool&) = delete;
+    TransformPool& operator=(const TransformPool&) = delete;
+
+    //ハンドルから配列の添字を取得する
+    unsigned indexOf(unsigned handle) const;
+    //親の添字を取得する 破棄された親は切り離す
+    unsigned parentOf(unsigned index);
+    //親のワールド値から自身のワールド値を求める
+    void updateWorld(unsigned index);
+    //根から順にindexまでのワールド値を求める
+    void updateWorldFromRoot(unsigned index);
+    //ワールド値とピボットからワールド行列を作る
+    void buildWorldTransform(unsigned index);
+    //[begin, end)のうち作り直しが必要なワールド行列をまとめて作る
+    void buildWorldTransforms(size_t begin, size_t end);
+    //[begin, end)のワールド値を並列に求める 範囲内の要素は互いに親子でないこと
+    void updateWorldRange(size_t begin, size_t end);
+    //破棄された要素を詰め、深さ順に並べ直す
+    void sortByDepth();
+    //orderの添字順に要素を並べ替える
+    template <typename T>
+    static void reorder(std::vector<T>& values, const std::vector<unsigned>& order);
+    //[0, count)を分割して処理する スレッドプールがなければ一括で処理する
+    template <typename Task>
+    void parallelFor(size_t count, const Task& task);
+
+private:
+    static inline TransformPool* mInstance = nullptr;
+
+    static constexpr unsigned INVALID_INDEX = ~0u;
+    //ワールド値を求め直す必要がある
+    static constexpr unsigned char WORLD_DIRTY = 1 << 0;
+    //ワールド行列を作り直す必要がある
+    static constexpr unsigned char MATRIX_DIRTY = 1 << 1;
+    //破棄済み 次の並び替えで詰める
+    static constexpr unsigned char DESTROYED = 1 << 2;
+    //1スレッドに割り当てる最小のトランスフォーム数
+    static constexpr size_t MIN_TRANSFORMS_PER_THREAD = 512;
+
+    //以下、添字で対応する要素ごとの配列
+    std::vector<Vector3> mPositions;
+    std::vector<Quaternion> mRotations;
+    std::vector<Vector3> mScales;
+    std::vector<Vector3> mPivots;
+    std::vector<Vector3> mWorldPositions;
+    std::vector<Quaternion> mWorldRotations;
+    std::vector<Vector3> mWorldScales;
+    std::vector<Matrix4> mWorldTransforms;
+    //親の添字 根ならINVALID_INDEX
+    std::vector<unsigned> mParents;
+    //ワールド値を求め直すたびに増やす
+    std::vector<unsigned> mVersions;
+    //最後にワールド値を求めたときの親のバージョン
+    std::vector<unsigned> mParentVersions;
+    std::vector<unsigned char> mFlags;
+    std::vector<unsigned> mHandles;
+    std::vector<Transform3D*> mOwners;
+
+    //ハンドルから添字への対応表
+    std::vector<unsigned> mIndices;
+    //再利用できるハンドル
+    std::vector<unsigned> mFreeHandles;
+    //並び替え時の深さごとの開始位置 [mLevelStarts[d], mLevelStarts[d + 1])が深さdの要素
+    std::vector<unsigned> mLevelStarts;
+    //並び替え後、この添字より後ろは子を持たない根だけが追加されている
+    size_t mSortedCount;
+    //破棄済みでまだ詰めていない要素数
+    size_t mDestroyedCount;
+    //親子関係が変わり、並び替えが必要か
+    bool mIsOrderDirty;
+    //作業用
+    std::vector<unsigned> mWork;
+    //ワールド行列の更新に使うワーカー 所有はSceneManager
+    ThreadPool* mThreadPool;
+};
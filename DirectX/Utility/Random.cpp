@@ -5,6 +5,10 @@ void Random::initialize() {
     mt.seed(rd());
 }
 
+void Random::initialize(unsigned seed) {
+    mt.seed(seed);
+}
+
 float Random::randomNormal() {
     return randomRange(0.f, 1.f);
 }
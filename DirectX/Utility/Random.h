@@ -6,6 +6,8 @@
 class Random {
 public:
     static void initialize();
+    //シードを指定して初期化する 毎回同じ乱数列が必要な場合に使う
+    static void initialize(unsigned seed);
     //0.f <= value <= 1.f
     static float randomNormal();
     //min <= value < max
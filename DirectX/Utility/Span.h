@@ -0,0 +1,44 @@
+﻿#pragma once
+
+#include <cassert>
+
+//連続した配列の一部を所有せずに参照する
+//C++17にはstd::spanがないので最低限の機能だけ用意する
+template<typename T>
+class Span {
+public:
+    Span() :
+        mData(nullptr),
+        mSize(0) {
+    }
+
+    Span(T* data, size_t size) :
+        mData(data),
+        mSize(size) {
+    }
+
+    T* begin() const {
+        return mData;
+    }
+
+    T* end() const {
+        return mData + mSize;
+    }
+
+    T& operator[](size_t index) const {
+        assert(index < mSize);
+        return mData[index];
+    }
+
+    size_t size() const {
+        return mSize;
+    }
+
+    bool empty() const {
+        return mSize == 0;
+    }
+
+private:
+    T* mData;
+    size_t mSize;
+};